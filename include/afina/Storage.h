@@ -1,10 +1,45 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <cstdint>
+#include <ctime>
+#include <memory>
 #include <string>
 
 namespace Afina {
 
+/**
+ * # Reference to the value kept by storage
+ * Holds buffer value lives in, so once obtained value could be read without any storage locks and
+ * without copying, even if association gets updated or evicted meanwhile. Buffer is never modified after
+ * it was published by storage
+ */
+class StoredValue {
+public:
+    StoredValue() : offset(0), size(0), flags(0), expire(0), rendered(false) {}
+
+    inline const char *data() const { return buffer->data() + offset; }
+
+    // Buffer value lives in
+    std::shared_ptr<const std::string> buffer;
+
+    // Where value begins in the buffer
+    std::size_t offset;
+
+    // Value size in bytes
+    std::size_t size;
+
+    // Opaque client flags stored along with the value
+    uint32_t flags;
+
+    // Unix time when item expires, 0 if it never expires
+    time_t expire;
+
+    // Buffer starts with pre-rendered "VALUE <key> <flags> <bytes>\r\n" header and value is followed by
+    // "\r\n", so whole get reply for the item is buffer[0, offset + size + 2)
+    bool rendered;
+};
+
 /**
  *
  */
@@ -30,6 +65,19 @@ public:
      */
     virtual bool Put(const std::string &key, const std::string &value) = 0;
 
+    /**
+     * Same as Put, but also stores opaque client flags and expiration time along with the value. Once
+     * expiration time comes storage must behave as if association was deleted. By default both are ignored
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param flags to be stored along with the value
+     * @param expire unix time when association expires, 0 if it never expires
+     */
+    virtual bool Put(const std::string &key, const std::string &value, uint32_t flags, time_t expire) {
+        return Put(key, value);
+    }
+
     /**
      * Stores association between given key/value pair if key isn't present in
      * storage.
@@ -43,6 +91,14 @@ public:
      */
     virtual bool PutIfAbsent(const std::string &key, const std::string &value) = 0;
 
+    /**
+     * Same as PutIfAbsent, but also stores opaque client flags and expiration time along with the value.
+     * By default both are ignored
+     */
+    virtual bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, time_t expire) {
+        return PutIfAbsent(key, value);
+    }
+
     /**
      * Updates existing association between given key/value pair
      * If requested key doesn't present in storage method returns false and
@@ -56,6 +112,14 @@ public:
      */
     virtual bool Set(const std::string &key, const std::string &value) = 0;
 
+    /**
+     * Same as Set, but also stores opaque client flags and expiration time along with the value. By default
+     * both are ignored
+     */
+    virtual bool Set(const std::string &key, const std::string &value, uint32_t flags, time_t expire) {
+        return Set(key, value);
+    }
+
     /**
      * Removes association for the given key
      * If requested key doesn't present in storage method returns false and
@@ -84,6 +148,63 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Retrive value for the given key without copying it
+     * If there is an association for the given key then method makes given output parameter
+     * to refer stored value and return true
+     *
+     * In case if given key not found method returns false and doesn't perform
+     * any changes on the output parameter
+     *
+     * Default implementation copies value into a new buffer, so storages are encouraged to override it
+     *
+     * @param key to retrive value for
+     * @param value output parameter to point to the value
+     */
+    virtual bool Get(const std::string &key, StoredValue &value) {
+        std::shared_ptr<std::string> copy = std::make_shared<std::string>();
+        if (!Get(key, *copy)) {
+            return false;
+        }
+
+        value.offset = 0;
+        value.size = copy->size();
+        value.buffer = std::move(copy);
+        return true;
+    }
+
+    /**
+     * Updates expiration time of the existing association, value and flags stay the same
+     * If requested key doesn't present in storage method returns false and
+     * doesnt change anything.
+     *
+     * @param key to update expiration time for
+     * @param expire unix time when association expires, 0 if it never expires
+     */
+    virtual bool Touch(const std::string &key, time_t expire) {
+        StoredValue value;
+        return GetAndTouch(key, expire, value);
+    }
+
+    /**
+     * Same as Get for StoredValue, but also updates expiration time of the association
+     *
+     * Default implementation stores value copy back with new expiration time, storages are encouraged to
+     * override it with a single lookup that touches metadata only
+     *
+     * @param key to retrive value for
+     * @param expire unix time when association expires, 0 if it never expires
+     * @param value output parameter to point to the value
+     */
+    virtual bool GetAndTouch(const std::string &key, time_t expire, StoredValue &value) {
+        if (!Get(key, value)) {
+            return false;
+        }
+
+        value.expire = expire;
+        return Put(key, std::string(value.data(), value.size), value.flags, expire);
+    }
 };
 
 } // namespace Afina
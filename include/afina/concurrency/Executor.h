@@ -1,21 +1,31 @@
 #ifndef AFINA_CONCURRENCY_EXECUTOR_H
 #define AFINA_CONCURRENCY_EXECUTOR_H
 
+#include <chrono>
 #include <condition_variable>
-#include <functional>
-#include <memory>
+#include <cstddef>
+#include <deque>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 
+#include <afina/concurrency/Histogram.h>
+#include <afina/concurrency/Task.h>
+#include <afina/concurrency/TaskExecutor.h>
+
 namespace Afina {
 namespace Concurrency {
 
 /**
  * # Thread pool
+ * Keeps at least low_watermark threads alive and spawns more, up to high_watermark, once tasks arrive
+ * faster than free threads pick them up. Threads above low_watermark exit once they have nothing to do for
+ * idle_time. Tasks which couldn't be started right away wait in the queue of at most max_queue_size, beyond
+ * that Execute rejects them.
+ *
+ * Time every task spends in the queue is recorded, see QueueLatency
  */
-class Executor {
+class Executor : public TaskExecutor {
     enum class State {
         // Threadpool is fully operational, tasks could be added and get executed
         kRun,
@@ -28,38 +38,40 @@ class Executor {
         kStopped
     };
 
-    Executor(std::string name, int size);
-    ~Executor();
-
+public:
     /**
-     * Signal thread pool to stop, it will stop accepting new jobs and close threads just after each become
-     * free. All enqueued jobs will be complete.
-     *
-     * In case if await flag is true, call won't return until all background jobs are done and all threads are stopped
+     * @param name of the pool, for diagnostics
+     * @param low_watermark number of threads started right away
+     * @param high_watermark maximum number of threads
+     * @param max_queue_size maximum number of tasks waiting for a free thread
+     * @param idle_time how long thread above low_watermark waits for a task before exit
      */
-    void Stop(bool await = false);
+    Executor(std::string name, std::size_t low_watermark, std::size_t high_watermark, std::size_t max_queue_size,
+             std::chrono::milliseconds idle_time);
+    ~Executor() override;
+
+    // See TaskExecutor.h
+    void Stop(bool await = false) override;
+
+    // See TaskExecutor.h
+    bool Post(Task &&task) override;
+
+    // Name of the pool
+    inline const std::string &Name() const { return name; }
 
     /**
-     * Add function to be executed on the threadpool. Method returns true in case if task has been placed
-     * onto execution queue, i.e scheduled for execution and false otherwise.
-     *
-     * That function doesn't wait for function result. Function could always be written in a way to notify caller about
-     * execution finished by itself
+     * Number of threads alive and the number of them executing tasks
      */
-    template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
-        // Prepare "task"
-        auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
+    std::size_t Threads();
+    std::size_t BusyThreads();
 
-        std::unique_lock<std::mutex> lock(this->mutex);
-        if (state != State::kRun) {
-            return false;
-        }
+    /**
+     * Number of tasks not started yet
+     */
+    std::size_t QueueSize();
 
-        // Enqueue new task
-        tasks.push_back(exec);
-        empty_condition.notify_one();
-        return true;
-    }
+    // See TaskExecutor.h
+    const Histogram &QueueLatency() const override { return queue_latency; }
 
 private:
     // No copy/move/assign allowed
@@ -73,6 +85,24 @@ private:
      */
     friend void perform(Executor *executor);
 
+    /**
+     * Start one more thread, must be called with mutex held
+     */
+    void Spawn();
+
+    /**
+     * Name of the pool
+     */
+    const std::string name;
+
+    /**
+     * Pool size and queue limits
+     */
+    const std::size_t low_watermark;
+    const std::size_t high_watermark;
+    const std::size_t max_queue_size;
+    const std::chrono::milliseconds idle_time;
+
     /**
      * Mutex to protect state below from concurrent modification
      */
@@ -84,14 +114,35 @@ private:
     std::condition_variable empty_condition;
 
     /**
-     * Vector of actual threads that perorm execution
+     * Conditional variable to await the last thread to exit
      */
-    std::vector<std::thread> threads;
+    std::condition_variable stop_condition;
+
+    /**
+     * Number of threads alive, threads are detached, so the last one reports stop through stop_condition
+     */
+    std::size_t threads;
+
+    /**
+     * Number of threads executing tasks at the moment
+     */
+    std::size_t busy_threads;
+
+    /**
+     * Task queue, along with time each task has been queued
+     */
+    struct Queued {
+        explicit Queued(Task &&task) : task(std::move(task)), since(std::chrono::steady_clock::now()) {}
+
+        Task task;
+        std::chrono::steady_clock::time_point since;
+    };
+    std::deque<Queued> tasks;
 
     /**
-     * Task queue
+     * Time from Execute till task start
      */
-    std::deque<std::function<void()>> tasks;
+    Histogram queue_latency;
 
     /**
      * Flag to stop bg threads
@@ -0,0 +1,72 @@
+#ifndef AFINA_CONCURRENCY_HISTOGRAM_H
+#define AFINA_CONCURRENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Latency histogram
+ * Log-linear buckets over nanoseconds: every power of two range is split into four buckets, so any value is
+ * reported within 25% of its actual value, from nanoseconds up to centuries, in a fixed amount of memory.
+ *
+ * Record is a couple of relaxed atomic increments, so it is cheap to call from many threads at once.
+ * Readers see a consistent enough snapshot for monitoring but not an atomic one
+ */
+class Histogram {
+public:
+    // Number of buckets: 4 for the values below 4ns, then 4 per power of two
+    static constexpr std::size_t kBuckets = 4 * 63;
+
+    Histogram();
+
+    /**
+     * Account one more value
+     */
+    void Record(std::chrono::nanoseconds value);
+
+    /**
+     * Number of values recorded so far
+     */
+    uint64_t Count() const;
+
+    /**
+     * The largest value recorded, precise
+     */
+    std::chrono::nanoseconds Max() const;
+
+    /**
+     * Upper bound of the bucket which has the given share of values at or below it, 0 if nothing is recorded
+     *
+     * @param quantile share of values, 0.5 for median, 0.99 for 99th percentile
+     */
+    std::chrono::nanoseconds Percentile(double quantile) const;
+
+    /**
+     * Drop everything recorded so far
+     */
+    void Reset();
+
+    /**
+     * Bucket for the value and the largest value which gets into the bucket
+     */
+    static std::size_t Bucket(uint64_t value);
+    static uint64_t UpperBound(std::size_t bucket);
+
+private:
+    Histogram(const Histogram &) = delete;
+    Histogram &operator=(const Histogram &) = delete;
+
+    std::atomic<uint64_t> _buckets[kBuckets];
+    std::atomic<uint64_t> _count;
+    std::atomic<uint64_t> _max;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_HISTOGRAM_H
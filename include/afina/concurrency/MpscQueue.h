@@ -0,0 +1,135 @@
+#ifndef AFINA_CONCURRENCY_MPSC_QUEUE_H
+#define AFINA_CONCURRENCY_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Lock free bounded multi producer single consumer queue
+ * Ring of preallocated cells, each stamped with the sequence number of the position it is ready for. Producer
+ * claims position by moving the tail with CAS, writes the item into the cell and publishes it by the stamp,
+ * consumer takes cells one by one in order and stamps them free for the next round. So handoff is neither
+ * locked nor allocates anything, and items come out in the order producers have claimed positions.
+ *
+ * Push tells if consumer might have found queue empty, so producer has to wake consumer up only on that
+ * transition: the consumer moves head before checking the tail and producer moves tail before checking the
+ * head, so at least one of them sees the other.
+ *
+ * Items are copied in and out, queue is meant for small values such as descriptors or pointers
+ */
+template <typename T> class MpscQueue {
+public:
+    /**
+     * @param capacity items queue holds at once, rounded up to the power of two
+     */
+    explicit MpscQueue(std::size_t capacity) : _capacity(RoundUp(capacity)), _tail(0), _head(0) {
+        _cells.reset(new Cell[_capacity]);
+        for (std::size_t i = 0; i < _capacity; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Add item, any thread. Returns false if queue is full. Otherwise was_empty is set if consumer might
+     * have seen no items, then it has to be woken up
+     */
+    bool Push(const T &item, bool &was_empty) {
+        uint64_t pos = _tail.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &_cells[pos & (_capacity - 1)];
+            int64_t diff = int64_t(cell->sequence.load(std::memory_order_acquire)) - int64_t(pos);
+            if (diff == 0) {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                                                std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // Cell still holds the item of the previous round
+                return false;
+            } else {
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        was_empty = _head.load(std::memory_order_seq_cst) == pos;
+        return true;
+    }
+
+    /**
+     * Take all items pushed so far and pass them to func in order, consumer only. Returns number of items
+     * taken
+     */
+    template <typename F> std::size_t Consume(F &&func) {
+        std::size_t n = 0;
+        uint64_t pos = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = _cells[pos & (_capacity - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+                // Either nothing is there or producer has claimed the cell and is about to fill it, that takes
+                // a few instructions unless producer is preempted
+                if (_tail.load(std::memory_order_seq_cst) == pos) {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+
+            T item = std::move(cell.item);
+            cell.sequence.store(pos + _capacity, std::memory_order_release);
+            _head.store(++pos, std::memory_order_seq_cst);
+
+            func(item);
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * There are no items to consume, approximate if queue is modified concurrently
+     */
+    inline bool Empty() const {
+        return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_relaxed);
+    }
+
+    // Items queue holds at once
+    inline std::size_t Capacity() const { return _capacity; }
+
+private:
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    static std::size_t RoundUp(std::size_t capacity) {
+        std::size_t result = 1;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        T item;
+    };
+
+    const std::size_t _capacity;
+    std::unique_ptr<Cell[]> _cells;
+
+    // Next position for producers to claim and for consumer to take, kept apart to not share cache line
+    alignas(64) std::atomic<uint64_t> _tail;
+    alignas(64) std::atomic<uint64_t> _head;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_MPSC_QUEUE_H
@@ -0,0 +1,149 @@
+#ifndef AFINA_CONCURRENCY_STEALING_EXECUTOR_H
+#define AFINA_CONCURRENCY_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Histogram.h>
+#include <afina/concurrency/Task.h>
+#include <afina/concurrency/TaskExecutor.h>
+#include <afina/concurrency/WorkStealingDeque.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Work stealing thread pool
+ * Fixed number of threads, each with own lock free deque of tasks. Task posted from a pool thread goes to
+ * the deque of that thread and runs LIFO, as it likely works on the data its parent has just touched. Tasks
+ * posted from outside go to the shared queue. Thread which has run out of tasks steals the oldest ones from
+ * a random victim, so that expensive tasks don't pile up behind each other on one thread while others idle.
+ *
+ * Unlike Executor there is no lock on the hot path: pushing and popping own tasks is a couple of atomic
+ * operations, the shared queue and the parking lot are touched only by outside posts and idle threads
+ */
+class StealingExecutor : public TaskExecutor {
+public:
+    /**
+     * @param name of the pool, for diagnostics
+     * @param threads number of threads
+     * @param max_queue_size maximum number of tasks waiting for a free thread
+     */
+    StealingExecutor(std::string name, std::size_t threads, std::size_t max_queue_size);
+    ~StealingExecutor() override;
+
+    // See TaskExecutor.h
+    bool Post(Task &&task) override;
+
+    // See TaskExecutor.h
+    void Stop(bool await = false) override;
+
+    // See TaskExecutor.h
+    const Histogram &QueueLatency() const override { return _queue_latency; }
+
+    // Name of the pool
+    inline const std::string &Name() const { return _name; }
+
+    // Number of threads
+    inline std::size_t Threads() const { return _workers.size(); }
+
+    // Number of tasks not started yet
+    inline std::size_t QueueSize() const { return _pending.load(std::memory_order_relaxed); }
+
+    // How many tasks have been taken from other threads
+    inline std::size_t Steals() const { return _steals.load(std::memory_order_relaxed); }
+
+private:
+    StealingExecutor(const StealingExecutor &) = delete;
+    StealingExecutor &operator=(const StealingExecutor &) = delete;
+
+    // Task along with time it has been posted
+    struct Queued {
+        explicit Queued(Task &&task) : task(std::move(task)), since(std::chrono::steady_clock::now()) {}
+
+        Task task;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    struct Worker {
+        explicit Worker(StealingExecutor *owner, uint32_t seed) : owner(owner), seed(seed), ticks(0) {}
+
+        StealingExecutor *const owner;
+        WorkStealingDeque<Queued> tasks;
+
+        // State of generator picking victims to steal from
+        uint32_t seed;
+
+        // Tasks taken so far, to look into the shared queue now and then even if own deque is never empty
+        uint32_t ticks;
+
+        std::thread thread;
+    };
+
+    /**
+     * Thread body
+     */
+    void Run(Worker &self);
+
+    /**
+     * Find task for the thread: own deque, shared queue, other threads, in this order
+     */
+    Queued *Next(Worker &self);
+    Queued *Steal(Worker &self);
+    Queued *TakeShared();
+
+    /**
+     * There are tasks nobody has taken yet
+     */
+    bool HasWork() const;
+
+    /**
+     * Wake up one sleeping thread if there are any, called when new task appears
+     */
+    void Notify();
+
+    // Pool thread running on the current thread, if any
+    static thread_local Worker *_current;
+
+    const std::string _name;
+    const std::size_t _max_queue_size;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Tasks posted from outside of the pool
+    std::mutex _shared_lock;
+    std::deque<Queued *> _shared;
+    std::atomic<std::size_t> _shared_size;
+
+    // Threads sleeping while there is nothing to do
+    std::mutex _park_lock;
+    std::condition_variable _park;
+    std::atomic<std::size_t> _sleeping;
+
+    // Tasks posted and not started yet, and threads running tasks
+    std::atomic<std::size_t> _pending;
+    std::atomic<std::size_t> _busy;
+
+    std::atomic<std::size_t> _steals;
+    std::atomic<bool> _running;
+
+    // Serializes joining threads in Stop
+    std::mutex _stop_lock;
+
+    // Time from Post till task start
+    Histogram _queue_latency;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_STEALING_EXECUTOR_H
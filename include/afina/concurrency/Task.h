@@ -0,0 +1,130 @@
+#ifndef AFINA_CONCURRENCY_TASK_H
+#define AFINA_CONCURRENCY_TASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Type erased task
+ * Move only replacement of std::function<void()> for task queues. Callables up to kInlineSize bytes are kept
+ * inside the task itself, so that posting a typical bound function with a few arguments doesn't allocate.
+ * Larger ones, or ones which could throw on move, go to heap
+ */
+class Task {
+public:
+    static constexpr std::size_t kInlineSize = 48;
+
+    Task() : _ops(nullptr) {}
+
+    template <typename F, typename = typename std::enable_if<
+                              !std::is_same<typename std::decay<F>::type, Task>::value>::type>
+    Task(F &&func) : _ops(nullptr) {
+        typedef typename std::decay<F>::type Callable;
+        Init<Callable>(std::forward<F>(func), std::integral_constant<bool, Fits<Callable>::value>());
+    }
+
+    Task(Task &&other) : _ops(other._ops) {
+        if (_ops != nullptr) {
+            _ops->move(&_storage, &other._storage);
+            other._ops = nullptr;
+        }
+    }
+
+    Task &operator=(Task &&other) {
+        if (this != &other) {
+            Reset();
+            _ops = other._ops;
+            if (_ops != nullptr) {
+                _ops->move(&_storage, &other._storage);
+                other._ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    ~Task() { Reset(); }
+
+    /**
+     * Run the task, it must not be empty
+     */
+    inline void operator()() { _ops->call(&_storage); }
+
+    inline explicit operator bool() const { return _ops != nullptr; }
+
+    /**
+     * Callable is stored inside the task, no heap memory is used
+     */
+    inline bool Inline() const { return _ops != nullptr && _ops->inline_storage; }
+
+private:
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    // Operations on the callable of particular type, one static table per type
+    struct Ops {
+        void (*call)(void *storage);
+        void (*move)(void *to, void *from);
+        void (*destroy)(void *storage);
+        bool inline_storage;
+    };
+
+    template <typename F> struct Fits {
+        static constexpr bool value = sizeof(F) <= kInlineSize && alignof(F) <= alignof(std::max_align_t) &&
+                                      std::is_nothrow_move_constructible<F>::value;
+    };
+
+    // Callable lives in the storage
+    template <typename F> struct InlineOps {
+        static void Call(void *storage) { (*static_cast<F *>(storage))(); }
+        static void Move(void *to, void *from) {
+            new (to) F(std::move(*static_cast<F *>(from)));
+            static_cast<F *>(from)->~F();
+        }
+        static void Destroy(void *storage) { static_cast<F *>(storage)->~F(); }
+        static const Ops ops;
+    };
+
+    // Storage keeps pointer to the callable
+    template <typename F> struct HeapOps {
+        static void Call(void *storage) { (**static_cast<F **>(storage))(); }
+        static void Move(void *to, void *from) { *static_cast<F **>(to) = *static_cast<F **>(from); }
+        static void Destroy(void *storage) { delete *static_cast<F **>(storage); }
+        static const Ops ops;
+    };
+
+    template <typename F, typename Arg> void Init(Arg &&func, std::true_type) {
+        new (&_storage) F(std::forward<Arg>(func));
+        _ops = &InlineOps<F>::ops;
+    }
+
+    template <typename F, typename Arg> void Init(Arg &&func, std::false_type) {
+        *reinterpret_cast<F **>(&_storage) = new F(std::forward<Arg>(func));
+        _ops = &HeapOps<F>::ops;
+    }
+
+    void Reset() {
+        if (_ops != nullptr) {
+            _ops->destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+    typename std::aligned_storage<kInlineSize, alignof(std::max_align_t)>::type _storage;
+    const Ops *_ops;
+};
+
+template <typename F>
+const Task::Ops Task::InlineOps<F>::ops = {&InlineOps<F>::Call, &InlineOps<F>::Move, &InlineOps<F>::Destroy, true};
+
+template <typename F>
+const Task::Ops Task::HeapOps<F>::ops = {&HeapOps<F>::Call, &HeapOps<F>::Move, &HeapOps<F>::Destroy, false};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_TASK_H
@@ -0,0 +1,55 @@
+#ifndef AFINA_CONCURRENCY_TASK_EXECUTOR_H
+#define AFINA_CONCURRENCY_TASK_EXECUTOR_H
+
+#include <functional>
+#include <utility>
+
+#include <afina/concurrency/Histogram.h>
+#include <afina/concurrency/Task.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Something that runs tasks on background threads
+ * Common interface of thread pools, so that the code posting tasks doesn't depend on how the pool schedules them
+ */
+class TaskExecutor {
+public:
+    virtual ~TaskExecutor() {}
+
+    /**
+     * Add function to be executed on the threadpool. Method returns true in case if task has been placed
+     * onto execution queue, i.e scheduled for execution and false otherwise, for example if the queue is full.
+     *
+     * That function doesn't wait for function result. Function could always be written in a way to notify caller about
+     * execution finished by itself
+     */
+    template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
+        // Prepare "task", bound function with a few arguments is kept inline
+        return Post(Task(std::bind(std::forward<F>(func), std::forward<Types>(args)...)));
+    }
+
+    /**
+     * Same as Execute for the task prepared already
+     */
+    virtual bool Post(Task &&task) = 0;
+
+    /**
+     * Signal thread pool to stop, it will stop accepting new jobs and close threads just after each become
+     * free. All enqueued jobs will be complete.
+     *
+     * In case if await flag is true, call won't return until all background jobs are done and all threads are stopped
+     */
+    virtual void Stop(bool await = false) = 0;
+
+    /**
+     * Time tasks spend from Execute till start
+     */
+    virtual const Histogram &QueueLatency() const = 0;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_TASK_EXECUTOR_H
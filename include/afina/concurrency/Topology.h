@@ -0,0 +1,82 @@
+#ifndef AFINA_CONCURRENCY_TOPOLOGY_H
+#define AFINA_CONCURRENCY_TOPOLOGY_H
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # CPU topology
+ * Logical CPUs grouped by the physical core they are hyperthreads of, by the package (socket) and by the NUMA
+ * node, as the kernel reports them under /sys/devices/system/cpu. Used to decide which CPUs threads of a pool
+ * should run on:
+ * - compact: fill all hyperthreads of a core, then the next core of the same package, then the next package.
+ *   Threads share caches and memory controller, good for pools talking to each other a lot
+ * - scatter: one thread per core across all nodes and packages first, hyperthread siblings only once every
+ *   core has a thread. Each thread gets as much cache and memory bandwidth as possible
+ */
+class Topology {
+public:
+    struct Cpu {
+        int id;
+        int core;
+        int package;
+        int node;
+    };
+
+    enum class Placement { None, Compact, Scatter };
+
+    explicit Topology(std::vector<Cpu> cpus);
+
+    /**
+     * Topology of CPUs the calling process is allowed to run on. If sysfs is not there every allowed CPU is
+     * taken as a separate core of a single node
+     */
+    static Topology Detect();
+
+    /**
+     * All online CPUs described by sysfs tree at the given root, throws std::runtime_error if it can't be read
+     */
+    static Topology Read(const std::string &root);
+
+    /**
+     * Placement by name: none, compact or scatter. Throws std::runtime_error on anything else
+     */
+    static Placement ParsePlacement(const std::string &name);
+
+    /**
+     * Bind thread to the single CPU, returns 0 or error code
+     */
+    static int Pin(std::thread &thread, int cpu);
+
+    // Logical CPUs, ordered by id
+    inline const std::vector<Cpu> &Cpus() const { return _cpus; }
+
+    // Physical cores and NUMA nodes having at least one of the CPUs
+    std::size_t Cores() const;
+    std::size_t Nodes() const;
+
+    /**
+     * CPU ids in the order threads should take them, empty for Placement::None. Pool of more threads than
+     * CPUs is expected to wrap around
+     */
+    std::vector<int> Order(Placement placement) const;
+
+    /**
+     * The lowest CPU id of each package on each node, ordered by node. Threads that feed a pool, such as
+     * acceptors, take one of these per node rather than share the CPUs of the pool order
+     */
+    std::vector<int> Leaders() const;
+
+private:
+    std::vector<Cpu> _cpus;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_TOPOLOGY_H
@@ -0,0 +1,164 @@
+#ifndef AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
+#define AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Chase-Lev work stealing deque
+ * Queue of pointers owned by a single thread. Owner pushes and pops items on the bottom end without any
+ * atomic read-modify-write in the common case, so it works as a cheap LIFO stack of local work. Any other
+ * thread could steal items from the top end, the oldest ones, contending with the owner only for the very
+ * last item.
+ *
+ * Array grows on demand, replaced arrays are kept until the deque is destroyed as thieves might still read
+ * from them. Memory orders follow "Correct and Efficient Work-Stealing for Weak Memory Models" by Lê et al.
+ *
+ * Push/Pop are for the owner thread only, Steal/Size are threadsafe
+ */
+template <typename T> class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(std::size_t capacity = 256) : _top(0), _bottom(0) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _arrays.push_back(new Array(size));
+        _array.store(_arrays.back(), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingDeque() {
+        for (Array *a : _arrays) {
+            delete a;
+        }
+    }
+
+    /**
+     * Put item to the bottom end, owner only
+     */
+    void Push(T *item) {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_acquire);
+        Array *a = _array.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(a->mask)) {
+            a = Grow(a, t, b);
+        }
+
+        a->Put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Take the most recently pushed item, owner only. Returns nullptr if deque is empty
+     */
+    T *Pop() {
+        int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = _array.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty already
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *item = a->Get(b);
+        if (t == b) {
+            // The last item, race thieves for it
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * Take the oldest item, any thread. Returns nullptr if deque is empty or other thread has got the item
+     * first, caller should move on to another victim then
+     */
+    T *Steal() {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Array *a = _array.load(std::memory_order_acquire);
+        T *item = a->Get(t);
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /**
+     * Number of items in the deque, approximate if deque is modified concurrently
+     */
+    std::size_t Size() const {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_relaxed);
+        return (b > t) ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    inline bool Empty() const { return Size() == 0; }
+
+private:
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    // Circular buffer indexed by ever growing positions
+    struct Array {
+        explicit Array(std::size_t size) : mask(size - 1), items(new std::atomic<T *>[size]) {}
+        ~Array() { delete[] items; }
+
+        inline T *Get(int64_t i) const { return items[i & mask].load(std::memory_order_relaxed); }
+        inline void Put(int64_t i, T *item) { items[i & mask].store(item, std::memory_order_relaxed); }
+
+        const std::size_t mask;
+        std::atomic<T *> *items;
+    };
+
+    /**
+     * Replace full array by the twice larger one holding the same items
+     */
+    Array *Grow(Array *a, int64_t t, int64_t b) {
+        Array *bigger = new Array(2 * (a->mask + 1));
+        for (int64_t i = t; i < b; i++) {
+            bigger->Put(i, a->Get(i));
+        }
+
+        _arrays.push_back(bigger);
+        _array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    // Position of the oldest item, advanced by thieves and by owner taking the last item. Kept on its own
+    // cache line, so that thieves don't slow down owner working with bottom
+    std::atomic<int64_t> _top;
+    char _top_pad[64 - sizeof(std::atomic<int64_t>)];
+
+    // Position after the newest item, written by owner only
+    std::atomic<int64_t> _bottom;
+    char _bottom_pad[64 - sizeof(std::atomic<int64_t>)];
+
+    // Array in use
+    std::atomic<Array *> _array;
+
+    // All arrays ever allocated, owner only
+    std::vector<Array *> _arrays;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
@@ -0,0 +1,39 @@
+#ifndef AFINA_COROUTINE_BODY_H
+#define AFINA_COROUTINE_BODY_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Type erased routine body with arguments bound
+ * Used to start routine on its own stack, where arguments passed to run are not available anymore
+ */
+struct Body {
+    virtual ~Body() {}
+    virtual void operator()() = 0;
+};
+
+template <std::size_t...> struct Indices {};
+template <std::size_t N, std::size_t... Is> struct MakeIndices : MakeIndices<N - 1, N - 1, Is...> {};
+template <std::size_t... Is> struct MakeIndices<0, Is...> { typedef Indices<Is...> type; };
+
+// Arguments passed by lvalue reference are kept as references, temporaries are moved in
+template <typename... Ta> struct BoundBody : Body {
+    BoundBody(void (*func)(Ta...), Ta &&... args) : func(func), args(std::forward<Ta>(args)...) {}
+
+    void operator()() override { Call(typename MakeIndices<sizeof...(Ta)>::type()); }
+
+    template <std::size_t... Is> void Call(Indices<Is...>) { func(std::forward<Ta>(std::get<Is>(args))...); }
+
+    void (*func)(Ta...);
+    std::tuple<Ta...> args;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_BODY_H
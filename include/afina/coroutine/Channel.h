@@ -0,0 +1,116 @@
+#ifndef AFINA_COROUTINE_CHANNEL_H
+#define AFINA_COROUTINE_CHANNEL_H
+
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+#include <afina/coroutine/Engine.h>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Bounded queue between routines of the same engine
+ * Sender blocks in engine while channel is full, receiver blocks while it is empty. Once channel is closed
+ * all blocked routines wake up, senders fail and receivers get what is left in the buffer
+ *
+ * Not threadsafe, could be used only inside of engine routines
+ */
+template <typename T> class Channel {
+public:
+    /**
+     * @param capacity how many values channel could hold before sender gets blocked, at least one
+     */
+    Channel(Engine &engine, std::size_t capacity)
+        : _engine(engine), _capacity(capacity > 0 ? capacity : 1), _closed(false) {}
+    ~Channel() {}
+
+    /**
+     * Puts value into channel, blocks current routine while channel is full
+     *
+     * @return false if channel is closed, value is dropped then
+     */
+    bool send(T value) {
+        while (!_closed && _buffer.size() >= _capacity) {
+            _senders.push_back(_engine.current());
+            _engine.block();
+        }
+
+        if (_closed) {
+            return false;
+        }
+
+        _buffer.push_back(std::move(value));
+        Wake(_receivers);
+        return true;
+    }
+
+    /**
+     * Takes the oldest value out of the channel, blocks current routine while channel is empty
+     *
+     * @return false if channel is closed and there is nothing left to receive
+     */
+    bool receive(T &value) {
+        while (!_closed && _buffer.empty()) {
+            _receivers.push_back(_engine.current());
+            _engine.block();
+        }
+
+        if (_buffer.empty()) {
+            return false;
+        }
+
+        value = std::move(_buffer.front());
+        _buffer.pop_front();
+        Wake(_senders);
+        return true;
+    }
+
+    /**
+     * Forbid further sends and wake up everyone waiting on the channel
+     */
+    void close() {
+        _closed = true;
+        while (!_senders.empty()) {
+            Wake(_senders);
+        }
+        while (!_receivers.empty()) {
+            Wake(_receivers);
+        }
+    }
+
+    inline bool closed() const { return _closed; }
+
+    inline std::size_t size() const { return _buffer.size(); }
+
+private:
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+    // Unblock the routine waiting for the longest time
+    void Wake(std::deque<void *> &waiters) {
+        if (!waiters.empty()) {
+            _engine.unblock(waiters.front());
+            waiters.pop_front();
+        }
+    }
+
+    Engine &_engine;
+
+    const std::size_t _capacity;
+
+    bool _closed;
+
+    // Values sent and not received yet
+    std::deque<T> _buffer;
+
+    // Routines blocked on send and receive respectively, in order of arrival
+    std::deque<void *> _senders;
+    std::deque<void *> _receivers;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_CHANNEL_H
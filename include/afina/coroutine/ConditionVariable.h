@@ -0,0 +1,63 @@
+#ifndef AFINA_COROUTINE_CONDITION_VARIABLE_H
+#define AFINA_COROUTINE_CONDITION_VARIABLE_H
+
+#include <deque>
+
+#include <afina/coroutine/Mutex.h>
+
+namespace Afina {
+namespace Coroutine {
+
+// Forward declaration, see Engine.h
+class Engine;
+
+/**
+ * # Condition variable for routines of the same engine
+ * Waiting routine gets blocked in engine until notified. There are no spurious wakeups, but condition must
+ * be checked in loop anyway as some other routine could change it between notify and wakeup
+ *
+ * Not threadsafe, could be used only inside of engine routines
+ */
+class ConditionVariable {
+public:
+    explicit ConditionVariable(Engine &engine) : _engine(engine) {}
+    ~ConditionVariable() {}
+
+    /**
+     * Atomically releases mutex and blocks current routine until notified, then locks mutex back
+     */
+    void wait(Mutex &mutex);
+
+    /**
+     * Same as wait, but checks the condition itself
+     */
+    template <typename Predicate> void wait(Mutex &mutex, Predicate ready) {
+        while (!ready()) {
+            wait(mutex);
+        }
+    }
+
+    /**
+     * Wakes up the routine waiting for the longest time
+     */
+    void notify_one();
+
+    /**
+     * Wakes up all waiting routines
+     */
+    void notify_all();
+
+private:
+    ConditionVariable(const ConditionVariable &) = delete;
+    ConditionVariable &operator=(const ConditionVariable &) = delete;
+
+    Engine &_engine;
+
+    // Routines waiting for notification in order of arrival
+    std::deque<void *> _waiters;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_CONDITION_VARIABLE_H
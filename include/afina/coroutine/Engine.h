@@ -1,11 +1,17 @@
 #ifndef AFINA_COROUTINE_ENGINE_H
 #define AFINA_COROUTINE_ENGINE_H
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <map>
 #include <setjmp.h>
 #include <tuple>
+#include <utility>
+
+#include <afina/coroutine/Body.h>
+#include <afina/coroutine/StackPool.h>
 
 namespace Afina {
 namespace Coroutine {
@@ -13,14 +19,37 @@ namespace Coroutine {
 /**
  * # Entry point of coroutine library
  * Allows to run coroutine and schedule its execution. Not threadsafe
+ *
+ * Engine works in one of two modes:
+ * - CopyStack: all routines run on the stack of the thread called start, stack of the routine being suspended
+ *   is copied aside and the one of routine being resumed is copied back. Costs nothing but memory for idle
+ *   routine, switch costs memcpy of the whole live stack. Variables located on stack of one routine could not be
+ *   accessed from another one
+ * - SeparateStacks: every routine gets its own stack of fixed size, switch is a few register moves. Stacks are
+ *   taken from the pool owned by engine and go back there once routine is done
+ *
+ * Routine could be blocked, for example while it waits for IO or some other routine. Blocked routine is kept
+ * aside and doesn't get control until unblocked, so engine never polls routines which can't make progress.
+ * Once there is nothing ready to run, engine sleeps until the nearest timer if there is some or returns
+ * from start otherwise
  */
 class Engine final {
+public:
+    enum class Mode { CopyStack, SeparateStacks };
+
+    // Size of the routine stack in SeparateStacks mode if not specified
+    static constexpr std::size_t kDefaultStackSize = 64 * 1024;
+
 private:
     /**
      * A single coroutine instance which could be scheduled for execution
      * should be allocated on heap
      */
     struct context;
+
+    // Routines sleeping until given time
+    typedef std::multimap<std::chrono::steady_clock::time_point, struct context *> timers_t;
+
     typedef struct context {
         // coroutine stack start address
         char *Low = nullptr;
@@ -34,6 +63,25 @@ private:
         // Saved coroutine context (registers)
         jmp_buf Environment;
 
+        // Own stack of the routine, SeparateStacks mode only
+        char *StackMemory = nullptr;
+
+        // Saved machine context of the routine running on own stack, see Context.h
+        void *Machine = nullptr;
+
+        // What to run once routine gets control first time, SeparateStacks mode only
+        Body *Entry = nullptr;
+
+        // Routine which passed control to this one last time, sched(nullptr) returns there
+        struct context *caller = nullptr;
+
+        // Routine is in "blocked" list rather than "alive" one
+        bool blocked = false;
+
+        // Routine is blocked until timer fires, if so timer points to its entry in timers list
+        bool sleeping = false;
+        timers_t::iterator timer;
+
         // To include routine in the different lists, such as "alive", "blocked", e.t.c
         struct context *prev = nullptr;
         struct context *next = nullptr;
@@ -44,7 +92,7 @@ private:
      */
     char *StackBottom;
 
-    /**const int&
+    /**
      * Current coroutine
      */
     context *cur_routine;
@@ -54,11 +102,36 @@ private:
      */
     context *alive;
 
+    /**
+     * List of routines which can't run until unblocked
+     */
+    context *blocked;
+
+    /**
+     * Sleeping routines ordered by wakeup time
+     */
+    timers_t timers;
+
     /**
      * Context to be returned finally
      */
     context *idle_ctx;
 
+    /**
+     * How routines are kept
+     */
+    Mode mode;
+
+    /**
+     * Stacks for routines in SeparateStacks mode
+     */
+    StackPool stack_pool;
+
+    /**
+     * Routine which has finished on its own stack, the stack can't be freed until control leaves it
+     */
+    context *zombie;
+
 protected:
     /**
      * Save stack of the current coroutine in the given context
@@ -71,15 +144,82 @@ protected:
     void Restore(context &ctx);
 
     /**
-     * Suspend current coroutine execution and execute given context
+     * Drop all references to the finished routine from the ones still alive
+     */
+    void Forget(context *ctx);
+
+    /**
+     * Remove finished routine from the alive list and pick the one to pass control to
+     */
+    context *Retire(context *ctx);
+
+    /**
+     * Double linked list operations
+     */
+    static void Link(context *&list, context *ctx);
+    static void Unlink(context *&list, context *ctx);
+
+    /**
+     * Make routines whose timers have expired ready to run
+     */
+    void Wake();
+
+    /**
+     * Body of the engine itself: run ready routines, sleep until timers fire while there are sleeping ones
+     */
+    void Schedule();
+
+    /**
+     * Release all routines which are still blocked once engine is done
+     */
+    void Shutdown();
+
+    /**
+     * Allocate own stack for the routine and prepare it to start execution of ctx.Entry
      */
-    // void Enter(context& ctx);
+    void Prepare(context &ctx);
+
+    /**
+     * Switch from the current routine to the given one in SeparateStacks mode
+     */
+    void Switch(context &from, context &to);
+
+    /**
+     * Release routine finished on its own stack once some other stack is active
+     */
+    void Reap();
+
+    /**
+     * Free context along with all memory it holds
+     */
+    void Release(context *ctx);
+
+    /**
+     * First function executed on the own stack of the routine
+     */
+    static void Trampoline(void *engine);
+
+    /**
+     * Suspend current coroutine execution and execute given context, idle_ctx means the engine itself
+     */
+    void Enter(context &ctx);
 
 public:
-    Engine() : StackBottom(0), cur_routine(nullptr), alive(nullptr) {}
+    /**
+     * @param mode how to keep routine stacks
+     * @param stack_size size of each routine stack in SeparateStacks mode
+     */
+    explicit Engine(Mode mode = Mode::CopyStack, std::size_t stack_size = kDefaultStackSize)
+        : StackBottom(0), cur_routine(nullptr), alive(nullptr), blocked(nullptr), idle_ctx(nullptr), mode(mode),
+          stack_pool(stack_size), zombie(nullptr) {}
     Engine(Engine &&) = delete;
     Engine(const Engine &) = delete;
 
+    /**
+     * Stack usage statistics in SeparateStacks mode, could be used to tune stack size
+     */
+    inline const StackPool &stacks() const { return stack_pool; }
+
     /**
      * Gives up current routine execution and let engine to schedule other one. It is not defined when
      * routine will get execution back, for example if there are no other coroutines then executing could
@@ -96,9 +236,39 @@ public:
      *
      * If routine to pass execution to is not specified runtime will try to transfer execution back to caller
      * of the current routine, if there is no caller then this method has same semantics as yield
+     *
+     * Blocked routine can't get control, sched does nothing for it
      */
     void sched(void *routine);
 
+    /**
+     * Block given routine, so that engine won't pass control to it until unblocked. If routine isn't specified
+     * or it is the current one, current routine gets suspended and control goes to its caller if it is ready
+     * or to any other ready routine
+     */
+    void block(void *routine = nullptr);
+
+    /**
+     * Make routine ready to run again, it gets control once scheduled explicitly or implicitly
+     */
+    void unblock(void *routine);
+
+    /**
+     * Block current routine for the given time at least
+     */
+    void sleep(std::chrono::milliseconds timeout);
+
+    /**
+     * Routine currently running, nullptr if called from outside of the engine
+     */
+    inline void *current() const { return cur_routine; }
+
+    /**
+     * How long, in milliseconds, caller could wait for external events without delaying other routines: 0 if there
+     * are other ready ones, time till the nearest timer if there are sleeping ones, -1 if there is nobody to wait for
+     */
+    int idle_timeout() const;
+
     /**
      * Entry point into the engine. Prepare all internal mechanics and starts given function which is
      * considered as main.
@@ -115,19 +285,21 @@ public:
         this->StackBottom = &StackStartsHere;
 
         // Start routine execution
-        void *pc = run(main, std::forward<Ta>(args)...);
+        run(main, std::forward<Ta>(args)...);
         idle_ctx = new context();
 
-        if (setjmp(idle_ctx->Environment) > 0) {
-            // Here: correct finish of the coroutine section
-            yield();
-        } else if (pc != nullptr) {
-            Store(*idle_ctx);
-            sched(pc);
+        // Engine itself is the idle context, it gets control back whenever there is nobody else to pass control
+        // to. In CopyStack mode control comes back here by longjmp each time, so the state of this frame is saved
+        // once. In SeparateStacks mode it just returns from Enter
+        if (mode == Mode::CopyStack) {
+            if (setjmp(idle_ctx->Environment) == 0) {
+                Store(*idle_ctx);
+            }
         }
+        Schedule();
 
         // Shutdown runtime
-        delete idle_ctx;
+        Shutdown();
         this->StackBottom = 0;
     }
 
@@ -144,10 +316,15 @@ public:
         // New coroutine context that carries around all information enough to call function
         context *pc = new context();
 
-        // Store current state right here, i.e just before enter new coroutine, later, once it gets scheduled
-        // execution starts here. Note that we have to acquire stack of the current function call to ensure
-        // that function parameters will be passed along
-        if (setjmp(pc->Environment) > 0) {
+        // In CopyStack mode store current state right here, i.e just before enter new coroutine, later, once it gets
+        // scheduled execution starts here. Note that we have to acquire stack of the current function call to ensure
+        // that function parameters will be passed along.
+        //
+        // Routine with its own stack starts from scratch, so arguments are bound right now
+        if (mode == Mode::SeparateStacks) {
+            pc->Entry = new BoundBody<Ta...>(func, std::forward<Ta>(args)...);
+            Prepare(*pc);
+        } else if (setjmp(pc->Environment) > 0) {
             // Created routine got control in order to start execution. Note that all variables, such as
             // context pointer, arguments and a pointer to the function comes from restored stack
 
@@ -158,41 +335,29 @@ public:
             // to pass control after that. We never want to go backward by stack as that would mean to go backward in
             // time. Function run() has already return once (when setjmp returns 0), so return second return from run
             // would looks a bit awkward
-            if (pc->prev != nullptr) {
-                pc->prev->next = pc->next;
-            }
-
-            if (pc->next != nullptr) {
-                pc->next->prev = pc->prev;
-            }
-
-            if (alive == cur_routine) {
-                alive = alive->next;
-            }
+            context *next = Retire(pc);
 
             // current coroutine finished, and the pointer is not relevant now
             cur_routine = nullptr;
-            pc->prev = pc->next = nullptr;
-            delete std::get<0>(pc->Stack);
-            delete pc;
+            Release(pc);
 
             // We cannot return here, as this function "returned" once already, so here we must select some other
             // coroutine to run. As current coroutine is completed and can't be scheduled anymore, it is safe to
-            // just give up and ask scheduler code to select someone else, control will never returns to this one
-            Restore(*idle_ctx);
+            // pass control back to the routine which has called it. If there is no such then just give up and
+            // ask scheduler code to select someone else, control will never returns to this one
+            if (next != idle_ctx) {
+                cur_routine = next;
+            }
+            Restore(*next);
+        } else {
+            // setjmp remembers position from which routine could starts execution, but to make it correctly
+            // it is neccessary to save arguments, pointer to body function, pointer to context, e.t.c - i.e
+            // save stack.
+            Store(*pc);
         }
 
-        // setjmp remembers position from which routine could starts execution, but to make it correctly
-        // it is neccessary to save arguments, pointer to body function, pointer to context, e.t.c - i.e
-        // save stack.
-        Store(*pc);
-
         // Add routine as alive double-linked list
-        pc->next = alive;
-        alive = pc;
-        if (pc->next != nullptr) {
-            pc->next->prev = pc;
-        }
+        Link(alive, pc);
 
         return pc;
     }
@@ -0,0 +1,56 @@
+#ifndef AFINA_COROUTINE_MUTEX_H
+#define AFINA_COROUTINE_MUTEX_H
+
+#include <deque>
+
+namespace Afina {
+namespace Coroutine {
+
+// Forward declaration, see Engine.h
+class Engine;
+
+/**
+ * # Mutual exclusion between routines of the same engine
+ * Routine which fails to lock gets blocked in engine until mutex is handed to it, so waiting costs nothing.
+ * Mutex is passed to waiters in FIFO order directly on unlock, so the one who arrives later can't take it first.
+ * Compatible with std::lock_guard and std::unique_lock
+ *
+ * Not threadsafe, could be used only inside of engine routines
+ */
+class Mutex {
+public:
+    explicit Mutex(Engine &engine) : _engine(engine), _owner(nullptr) {}
+    ~Mutex() {}
+
+    /**
+     * Blocks current routine until it owns the mutex
+     */
+    void lock();
+
+    /**
+     * Takes mutex if it is free, never blocks
+     */
+    bool try_lock();
+
+    /**
+     * Releases mutex, passing it to the first waiter if there is some
+     */
+    void unlock();
+
+private:
+    Mutex(const Mutex &) = delete;
+    Mutex &operator=(const Mutex &) = delete;
+
+    Engine &_engine;
+
+    // Routine holding the mutex
+    void *_owner;
+
+    // Routines waiting for the mutex in order of arrival
+    std::deque<void *> _waiters;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_MUTEX_H
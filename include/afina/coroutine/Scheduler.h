@@ -0,0 +1,250 @@
+#ifndef AFINA_COROUTINE_SCHEDULER_H
+#define AFINA_COROUTINE_SCHEDULER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <afina/concurrency/WorkStealingDeque.h>
+#include <afina/coroutine/Body.h>
+#include <afina/coroutine/Engine.h>
+#include <afina/coroutine/StackPool.h>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # M:N coroutine scheduler
+ * Runs routines on a fixed number of threads, one processor per core. Each routine has its own stack and is
+ * not bound to any thread: it could be suspended on one processor and resumed on another.
+ *
+ * Every processor keeps ready routines in own Chase-Lev deque and runs them LIFO, so that routine woken up
+ * or spawned just now runs while its data is hot in cache. Processor which has run out of work steals the
+ * oldest routines from others, so that a few hot routines don't keep one core busy while the rest are idle.
+ *
+ * Routine waiting for IO is kept by the shared epoll instance only, its descriptor is armed in oneshot mode,
+ * so whichever processor gets the event takes the routine to its deque. Idle processors sleep in epoll_wait,
+ * busy ones check for events every few dozens of switches.
+ *
+ * Unlike Engine there is no explicit sched/block: routines communicate through IO only. Threadsafe
+ */
+class Scheduler final {
+public:
+    /**
+     * @param workers number of threads to run routines on
+     * @param stack_size size of each routine stack
+     */
+    explicit Scheduler(std::size_t workers, std::size_t stack_size = Engine::kDefaultStackSize);
+    ~Scheduler();
+
+    /**
+     * Spawns processor threads, routines registered before that start to run. Throws std::runtime_error if
+     * resources couldn't be allocated
+     */
+    void start();
+
+    /**
+     * Signal processors to exit once all routines are done. Routines waiting for IO have to be woken up
+     * by the caller somehow, for example by socket shutdown
+     */
+    void stop();
+
+    /**
+     * Blocks calling thread until processors are stopped
+     */
+    void join();
+
+    /**
+     * Register new routine, it runs on any processor. Could be called from routine as well as from outside,
+     * once stop is called new routines must be registered by routines still running only
+     */
+    template <typename... Ta> void run(void (*func)(Ta...), Ta &&... args) {
+        Spawn(new BoundBody<Ta...>(func, std::forward<Ta>(args)...));
+    }
+
+    /**
+     * Let other ready routines run. Current routine could continue on another processor afterwards. Yields
+     * the thread if called from outside of the scheduler
+     */
+    void yield();
+
+    /**
+     * Suspend current routine until descriptor reports any of the given epoll events. Descriptor stays
+     * registered in the scheduler epoll until closed, at most one routine could wait for the same descriptor
+     * at a time. Must be called from routine, throws std::runtime_error otherwise
+     *
+     * @return events reported by epoll, EPOLLERR if descriptor couldn't be watched
+     */
+    uint32_t wait(int fd, uint32_t events);
+
+    // Number of processor threads
+    inline std::size_t workers() const { return _processors.size(); }
+
+    // Routines registered and not finished yet
+    inline std::size_t alive() const { return _alive.load(std::memory_order_relaxed); }
+
+    // How many times routines have been taken from other processors
+    inline std::size_t steals() const { return _steals.load(std::memory_order_relaxed); }
+
+    // The most bytes of stack any finished routine has touched
+    std::size_t stack_high_water();
+
+private:
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    struct Processor;
+
+    // What routine asked its processor to do once it gets control back
+    enum class Action { kYield, kWait, kFinish };
+
+    /**
+     * Routine running on own stack
+     */
+    struct Routine {
+        // What to run once routine gets control first time
+        Body *entry = nullptr;
+
+        // Own stack of the routine and its saved machine context, see Context.h
+        char *stack = nullptr;
+        void *machine = nullptr;
+
+        // Processor which resumed routine last time
+        Processor *owner = nullptr;
+
+        // Request to processor made right before switch, processor completes it once routine is off the CPU
+        Action action = Action::kYield;
+        int fd = -1;
+        uint32_t events = 0;
+        uint32_t revents = 0;
+    };
+
+    /**
+     * One thread running routines
+     */
+    struct Processor {
+        Scheduler *scheduler = nullptr;
+        std::size_t index = 0;
+
+        // Routines ready to run on this processor, others steal from the top
+        Concurrency::WorkStealingDeque<Routine> ready;
+
+        // Context of the processor loop itself, routines switch here to suspend
+        void *machine = nullptr;
+
+        // Routine running at the moment
+        Routine *current = nullptr;
+
+        // Switches done, used to check for IO and global queue from time to time
+        uint32_t ticks = 0;
+
+        // State of generator picking victims to steal from
+        uint32_t seed = 0;
+
+        std::thread thread;
+    };
+
+    /**
+     * Make routine for the body and put it on the current processor or into the global queue
+     */
+    void Spawn(Body *body);
+
+    /**
+     * Processor thread body
+     */
+    void Loop(Processor &p);
+
+    /**
+     * Pick the next routine for the processor: local deque, global queue, other processors, in this order.
+     * Returns nullptr if there is nothing to run anywhere
+     */
+    Routine *Next(Processor &p);
+    Routine *Steal(Processor &p);
+    Routine *TakeGlobal();
+
+    /**
+     * Check for IO events and move woken routines to the processor deque. Returns number of routines woken
+     */
+    std::size_t Poll(Processor &p, int timeout);
+
+    /**
+     * Sleep in epoll until there is some work, returns false once processor should exit
+     */
+    bool Park(Processor &p);
+
+    /**
+     * Wake up one sleeping processor if there are any, called when new work appears
+     */
+    void Notify();
+
+    /**
+     * Switch to the routine and complete whatever it has asked for once it gets back
+     */
+    void Resume(Processor &p, Routine &r);
+
+    /**
+     * Pass control from the routine back to its processor
+     */
+    static void Suspend(Routine &r);
+
+    /**
+     * Register routine in epoll, it moves to some processor once event fires
+     */
+    void Arm(Processor &p, Routine &r);
+
+    /**
+     * Free finished routine along with its stack
+     */
+    void Release(Routine *r);
+
+    /**
+     * First function executed on the own stack of the routine
+     */
+    static void Trampoline(void *routine);
+
+    /**
+     * Routine running on the calling thread, nullptr if there is none
+     */
+    static Routine *Current();
+
+    std::vector<std::unique_ptr<Processor>> _processors;
+
+    // Routines registered from outside of processors
+    std::mutex _global_lock;
+    std::deque<Routine *> _global;
+    std::atomic<std::size_t> _global_size;
+
+    // Stacks are shared as routine could finish on another processor than it has started on
+    std::mutex _stacks_lock;
+    StackPool _stacks;
+
+    // Epoll instance all routines wait for IO in
+    int _epoll_fd;
+
+    // Wakes up one sleeping processor, edge triggered
+    int _wakeup_fd;
+
+    // Wakes up all processors once scheduler is done, level triggered
+    int _done_fd;
+
+    // Routines not finished yet, processors exit once it drops to zero after stop
+    std::atomic<std::size_t> _alive;
+
+    // Processors sleeping in epoll and whether one of them is being woken up already
+    std::atomic<std::size_t> _sleeping;
+    std::atomic<bool> _notified;
+
+    std::atomic<std::size_t> _steals;
+    std::atomic<bool> _stopping;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_SCHEDULER_H
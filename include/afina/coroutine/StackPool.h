@@ -0,0 +1,87 @@
+#ifndef AFINA_COROUTINE_STACK_POOL_H
+#define AFINA_COROUTINE_STACK_POOL_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Cache of coroutine stacks
+ * Stacks are mmap'd regions with PROT_NONE guard page below, so overflow crashes right away instead of
+ * corrupting the neighbour memory. Kernel commits stack pages only once they are touched, so idle routine
+ * costs as much RSS as deep its stack has been.
+ *
+ * Released stacks are kept for the next routine. Pages touched deeper than a few KB are given back to the
+ * kernel on release, so cached stacks don't pin memory of the deepest routine ever run on them.
+ *
+ * Not threadsafe
+ */
+class StackPool {
+public:
+    /**
+     * Pages at the top of stack which stay committed once stack is released
+     */
+    static constexpr std::size_t kKeepResident = 8 * 1024;
+
+    /**
+     * @param stack_size usable size of every stack, rounded up to page size
+     * @param max_cached how many released stacks to keep for reuse, the rest are unmapped
+     */
+    StackPool(std::size_t stack_size, std::size_t max_cached = 1024);
+    ~StackPool();
+
+    /**
+     * Returns lowest usable address of the stack of StackSize() bytes, throws std::runtime_error if memory
+     * couldn't be mapped
+     */
+    char *Acquire();
+
+    /**
+     * Returns stack got by Acquire back to the pool
+     */
+    void Release(char *stack);
+
+    // Usable size of every stack
+    inline std::size_t StackSize() const { return _stack_size; }
+
+    // Stacks given out and not released yet
+    inline std::size_t InUse() const { return _in_use; }
+
+    // Stacks ready to be reused
+    inline std::size_t Cached() const { return _free.size(); }
+
+    // The most bytes of stack any released routine has ever touched
+    inline std::size_t HighWater() const { return _high_water; }
+
+private:
+    StackPool(const StackPool &) = delete;
+    StackPool &operator=(const StackPool &) = delete;
+
+    /**
+     * How many bytes from the top of the stack are resident in memory
+     */
+    std::size_t Resident(char *stack);
+
+    const std::size_t _page_size;
+
+    const std::size_t _stack_size;
+
+    const std::size_t _max_cached;
+
+    std::size_t _in_use;
+
+    std::size_t _high_water;
+
+    // Released stacks, the most recently used is on the back as it is likely to be hot in cache
+    std::vector<char *> _free;
+
+    // Buffer for mincore results, one byte per stack page
+    std::vector<unsigned char> _residency;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_STACK_POOL_H
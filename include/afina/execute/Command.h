@@ -1,8 +1,12 @@
 #ifndef AFINA_EXECUTE_COMMAND_H
 #define AFINA_EXECUTE_COMMAND_H
 
+#include <cstdint>
+#include <ctime>
 #include <string>
 
+#include "Response.h"
+
 namespace Afina {
 
 class Storage;
@@ -19,6 +23,25 @@ public:
     virtual ~Command() {}
 
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Executes command and appends complete reply, including the final "\r\n", to the given response.
+     * Commands that could send stored values back override it to avoid copying values
+     */
+    virtual void Execute(Storage &storage, const std::string &args, Response &out) {
+        std::string result;
+        Execute(storage, args, result);
+        out.Append(result);
+        out.Append("\r\n", 2);
+    }
+
+protected:
+    /**
+     * Converts memcached <exptime> into unix time when item expires. If it's 0, the item never expires.
+     * Value up to 30 days is an offset in seconds from current time, bigger one is unix time already.
+     * Negative value means item is expired immediately
+     */
+    static time_t ExpireAt(int32_t exptime);
 };
 
 } // namespace Execute
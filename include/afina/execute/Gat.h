@@ -0,0 +1,39 @@
+#ifndef AFINA_EXECUTE_GAT_H
+#define AFINA_EXECUTE_GAT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Get.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Retrive values and update their expiration time
+ * gat <exptime> <key>*\r\n
+ * gats <exptime> <key>*\r\n
+ *
+ * Reply is the same as for get command, each found item gets new expiration time in the same storage
+ * lookup that retrives it. There is no CAS support, so gats behaves exactly as gat
+ */
+class Gat : public Get {
+public:
+    Gat(int32_t expire, const std::vector<std::string> &keys) : Get(keys), _expire(expire) {}
+    ~Gat() {}
+
+    inline const int32_t expire() const { return _expire; }
+
+protected:
+    // See Get.h
+    bool Fetch(Storage &storage, const std::string &key, StoredValue &value) override;
+
+private:
+    const int32_t _expire;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_GAT_H
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include <afina/Storage.h>
+
 #include "Command.h"
 
 namespace Afina {
@@ -18,13 +20,14 @@ namespace Execute {
  * the items have been transmitted, the server sends the string
  *
  * Each item sent by the server looks like this:
- * VALUE <key> <bytes>\r\n
+ * VALUE <key> <flags> <bytes>\r\n
  * <data>\r\n
  * VALUE ....
  * END
  *
- * Where <key> is the key for the value, <bytes> is the number of bytes in the
- * value and <data> is the value text
+ * Where <key> is the key for the value, <flags> are opaque flags given on store, <bytes> is the number
+ * of bytes in the value and <data> is the value text. In case if storage keeps header pre-rendered, item
+ * is sent as is, see StoredValue
  *
  * If some of the keys appearing in a retrieval request are not sent back
  * by the server in the item list this means that the server does not
@@ -41,6 +44,19 @@ public:
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    /**
+     * Builds reply out of header chunks and references to stored values, see Response.h
+     */
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+protected:
+    /**
+     * Looks up single item, see Storage::Get
+     */
+    virtual bool Fetch(Storage &storage, const std::string &key, StoredValue &value) {
+        return storage.Get(key, value);
+    }
+
 private:
     std::vector<std::string> _keys;
 };
@@ -0,0 +1,80 @@
+#ifndef AFINA_EXECUTE_META_COMMAND_H
+#define AFINA_EXECUTE_META_COMMAND_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Basic class for all meta commands
+ * Meta commands take a key followed by a list of single letter flags, some of flags carry a token
+ * right after the letter, for example "mg foo v t Oabc". Replies are short: two letter status code
+ * followed by flags client asked to return, in order they were requested.
+ *
+ * Flags shared by all meta commands:
+ * - q: quiet mode, do not reply on the "boring" outcome, see each command for details
+ * - O<token>: opaque value, returned back as is
+ * - k: return key
+ */
+class MetaCommand : public Command {
+public:
+    /**
+     * @param key item key
+     * @param flags flag tokens, each starts with a flag letter
+     * @param allowed letters of flags command supports, other letters make constructor throw
+     */
+    MetaCommand(const std::string &key, const std::vector<std::string> &flags, const std::string &allowed);
+    ~MetaCommand() {}
+
+    inline const std::string &key() const { return _key; }
+
+    /**
+     * Returns true if given flag is present in the command
+     */
+    bool has(char flag) const;
+
+    /**
+     * Returns token passed along with the given flag, empty string if flag isn't present
+     */
+    const std::string &token(char flag) const;
+
+    // Reply without final "\r\n", see Command.h
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    // See Command.h
+    void Execute(Storage &storage, const std::string &args, Response &out) override = 0;
+
+protected:
+    /**
+     * Appends return flags common for all meta commands, such as k and O, each prefixed by space
+     */
+    void AppendFlags(std::string &out) const;
+
+    /**
+     * Parses unsigned decimal number out of the flag token, throws std::runtime_error if token isn't a number
+     * or doesn't fit 32 bits
+     */
+    uint32_t NumberFlag(char flag) const;
+
+    /**
+     * Parses TTL out of the flag token, the same as <exptime> of set command. Any negative TTL is
+     * reported as -1 since item expires immediately anyway, one over INT32_MAX is refused
+     */
+    int32_t TtlFlag(char flag) const;
+
+    const std::string _key;
+
+    // Flag letter and token that follows it, in order client sent them
+    std::vector<std::pair<char, std::string>> _flags;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_COMMAND_H
@@ -0,0 +1,31 @@
+#ifndef AFINA_EXECUTE_META_DELETE_H
+#define AFINA_EXECUTE_META_DELETE_H
+
+#include <string>
+#include <vector>
+
+#include "MetaCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Remove item for the key
+ * md <key> <flags>*\r\n
+ *
+ * Supports k, O and q flags, see MetaCommand. Server replies with "HD <flags>*\r\n" if item was deleted
+ * and "NF <flags>*\r\n" if there was no such item, q suppresses both
+ */
+class MetaDelete : public MetaCommand {
+public:
+    MetaDelete(const std::string &key, const std::vector<std::string> &flags) : MetaCommand(key, flags, "kOq") {}
+    ~MetaDelete() {}
+
+    // See Command.h
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_DELETE_H
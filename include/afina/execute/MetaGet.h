@@ -0,0 +1,47 @@
+#ifndef AFINA_EXECUTE_META_GET_H
+#define AFINA_EXECUTE_META_GET_H
+
+#include <string>
+#include <vector>
+
+#include "MetaCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Retrieve value and/or item metadata for the key
+ * mg <key> <flags>*\r\n
+ *
+ * Supported flags:
+ * - v: return item value
+ * - f: return client flags as f<flags>
+ * - s: return value size as s<size>
+ * - t: return remaining TTL in seconds as t<ttl>, -1 if item never expires
+ * - T<ttl>: update item TTL within the same lookup, see Touch
+ * - k, O, q: see MetaCommand, q suppresses EN reply
+ *
+ * Server replies with "VA <size> <flags>*\r\n<data>\r\n" if v flag was given, "HD <flags>*\r\n" if
+ * item exists otherwise and "EN\r\n" in case of miss
+ */
+class MetaGet : public MetaCommand {
+public:
+    MetaGet(const std::string &key, const std::vector<std::string> &flags)
+        : MetaCommand(key, flags, "fkOqstTv"), _touch(has('T')), _ttl(_touch ? TtlFlag('T') : 0) {}
+    ~MetaGet() {}
+
+    /**
+     * Value is referred rather than copied in the reply, see Response.h
+     */
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+private:
+    // Update TTL along with retrieval
+    const bool _touch;
+    const int32_t _ttl;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_GET_H
@@ -0,0 +1,27 @@
+#ifndef AFINA_EXECUTE_META_NOOP_H
+#define AFINA_EXECUTE_META_NOOP_H
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Do nothing
+ * mn\r\n
+ *
+ * Server always replies with "MN\r\n". Clients send it after a batch of quiet meta commands to find
+ * out that all of them were processed
+ */
+class MetaNoop : public Command {
+public:
+    MetaNoop() {}
+    ~MetaNoop() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_NOOP_H
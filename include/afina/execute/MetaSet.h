@@ -0,0 +1,48 @@
+#ifndef AFINA_EXECUTE_META_SET_H
+#define AFINA_EXECUTE_META_SET_H
+
+#include <string>
+#include <vector>
+
+#include "MetaCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Store value for the key
+ * ms <key> <datalen> <flags>*\r\n
+ * <data>\r\n
+ *
+ * Supported flags:
+ * - F<flags>: client flags to be stored along with the value
+ * - T<ttl>: item time to live in seconds, the same as <exptime> of set command
+ * - M<mode>: store mode, one of
+ *   - S: set, default one
+ *   - E: add, store only if item doesn't exist
+ *   - R: replace, store only if item exists
+ *   - A: append data to the existing item
+ *   - P: prepend data to the existing item
+ * - k, O, q: see MetaCommand, q suppresses HD reply
+ *
+ * Server replies with "HD <flags>*\r\n" if item was stored and "NS <flags>*\r\n" otherwise. Append and
+ * prepend modes keep flags and TTL of the existing item
+ */
+class MetaSet : public MetaCommand {
+public:
+    MetaSet(const std::string &key, const std::vector<std::string> &flags);
+    ~MetaSet() {}
+
+    // See Command.h
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+private:
+    char _mode;
+    uint32_t _client_flags;
+    int32_t _ttl;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_SET_H
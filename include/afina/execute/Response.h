@@ -0,0 +1,86 @@
+#ifndef AFINA_EXECUTE_RESPONSE_H
+#define AFINA_EXECUTE_RESPONSE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Command reply
+ * Reply is a list of buffer segments to be sent one after another. Segment either owns its bytes or
+ * refers to the value kept by storage, so that network layer could hand values to writev without
+ * copying them.
+ *
+ * Response always holds complete reply including the final "\r\n"
+ */
+class Response {
+public:
+    /**
+     * Values smaller than that are copied into the reply, separate iovec for them costs more than copy
+     */
+    static constexpr std::size_t kMinPinnedSize = 256;
+
+    class Segment {
+    public:
+        explicit Segment(std::string &&data) : _data(std::move(data)), _ptr(nullptr), _size(0) {}
+        explicit Segment(const StoredValue &value) : _pinned(value.buffer), _ptr(value.data()), _size(value.size) {}
+
+        inline const char *data() const { return _ptr != nullptr ? _ptr : _data.data(); }
+        inline std::size_t size() const { return _ptr != nullptr ? _size : _data.size(); }
+
+        // Segment owns its bytes and could be extended
+        inline bool owned() const { return _ptr == nullptr; }
+        inline std::string &buffer() { return _data; }
+
+    private:
+        // Bytes owned by the segment
+        std::string _data;
+
+        // Storage buffer segment refers to, keeps it alive until segment is sent
+        std::shared_ptr<const std::string> _pinned;
+
+        // Beginning of referred bytes, nullptr if segment owns its data
+        const char *_ptr;
+
+        // Size of referred bytes
+        std::size_t _size;
+    };
+
+    Response() {}
+
+    /**
+     * Append bytes to the end of reply
+     */
+    void Append(const char *data, std::size_t size);
+    inline void Append(const std::string &data) { Append(data.data(), data.size()); }
+
+    /**
+     * Append stored value to the end of reply, large values are referred rather than copied
+     */
+    void Append(const StoredValue &value);
+
+    /**
+     * Copy whole reply into a single string
+     */
+    std::string str() const;
+
+    // Total reply size in bytes
+    std::size_t size() const;
+
+    inline bool empty() const { return _segments.empty(); }
+
+    inline std::vector<Segment> &segments() { return _segments; }
+
+private:
+    std::vector<Segment> _segments;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_RESPONSE_H
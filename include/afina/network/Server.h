@@ -1,7 +1,10 @@
 #ifndef AFINA_NETWORK_SERVER_H
 #define AFINA_NETWORK_SERVER_H
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace Afina {
@@ -11,6 +14,50 @@ class Service;
 }
 namespace Network {
 
+/**
+ * # Limits on data nonblocking connection buffers
+ * Once responses waiting for the client exceed the output high mark, connection stops reading and parsing
+ * commands till client takes them down to the low mark. So client pipelining requests without reading
+ * responses holds at most that much server memory, and if it doesn't drain in time it gets closed.
+ *
+ * Input can't be paused in the middle of a command, so there is a single mark: command argument bigger than
+ * that is refused. Zero disables the limit
+ */
+struct ConnectionLimits {
+    ConnectionLimits()
+        : input_high(1024 * 1024), output_high(4 * 1024 * 1024), output_low(1024 * 1024), drain_timeout(10000) {}
+
+    // Largest command argument accepted, in bytes
+    std::size_t input_high;
+
+    // Pending output bytes to stop reading at and to resume at
+    std::size_t output_high;
+    std::size_t output_low;
+
+    // Connection stopped by the output high mark is closed after that long
+    std::chrono::milliseconds drain_timeout;
+};
+
+/**
+ * # Placement of server threads on CPUs
+ * Thread i of a kind is pinned to the CPU i modulo list size, empty list leaves threads of that kind to the
+ * scheduler. Servers pin the threads they have, the rest is ignored.
+ *
+ * Once workers are pinned, incoming CPU matching steers connection to the worker running on the CPU which has
+ * handled its packets, see SO_INCOMING_CPU. Then socket buffers and connection state stay in the same cache,
+ * provided NIC queues interrupts are spread over the same CPUs
+ */
+struct ThreadPlacement {
+    ThreadPlacement() : incoming_cpu(false) {}
+
+    // CPUs for workers serving connections and for acceptors handing them over
+    std::vector<int> workers;
+    std::vector<int> acceptors;
+
+    // Match connections to workers by SO_INCOMING_CPU
+    bool incoming_cpu;
+};
+
 /**
  * # Network processors coordinator
  * Configure resources for the network processors and coordinates all work
@@ -18,9 +65,36 @@ namespace Network {
 class Server {
 public:
     Server(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-        : pStorage(ps), pLogging(pl) {}
+        : pStorage(ps), pLogging(pl), idle_timeout(0), read_timeout(5000) {}
     virtual ~Server() {}
 
+    /**
+     * Configure connection timeouts, must be called before Start. Zero disables timeout
+     *
+     * @param idle connection waiting for the next command is closed after that long
+     * @param read connection is closed if command hasn't arrived completely in that time since its first byte
+     */
+    void SetTimeouts(std::chrono::milliseconds idle, std::chrono::milliseconds read) {
+        idle_timeout = idle;
+        read_timeout = read;
+    }
+
+    /**
+     * Configure buffering limits of connections, must be called before Start
+     */
+    void SetLimits(const ConnectionLimits &limits) { this->limits = limits; }
+
+    /**
+     * Configure CPUs server threads run on, must be called before Start
+     */
+    void SetPlacement(const ThreadPlacement &placement) { this->placement = placement; }
+
+    /**
+     * Listen on the unix domain socket at the given path along with the TCP port, must be called before
+     * Start. Connections from both are served by the same threads. Empty path is for TCP only
+     */
+    void SetUnixSocket(const std::string &path) { unix_socket = path; }
+
     /**
      * Starts network service. After method returns process should
      * listen on the given interface/port pair to process  incomming
@@ -55,6 +129,27 @@ protected:
      * Logging service to be used in order to report application progress
      */
     std::shared_ptr<Afina::Logging::Service> pLogging;
+
+    /**
+     * Connection timeouts, see SetTimeouts
+     */
+    std::chrono::milliseconds idle_timeout;
+    std::chrono::milliseconds read_timeout;
+
+    /**
+     * Connection buffering limits, see SetLimits
+     */
+    ConnectionLimits limits;
+
+    /**
+     * Thread placement, see SetPlacement
+     */
+    ThreadPlacement placement;
+
+    /**
+     * Path of unix domain socket to listen on, see SetUnixSocket
+     */
+    std::string unix_socket;
 };
 
 } // namespace Network
@@ -1,5 +1,124 @@
 #include <afina/concurrency/Executor.h>
 
+#include <algorithm>
+
 namespace Afina {
-namespace Concurrency {}
+namespace Concurrency {
+
+// See Executor.h
+void perform(Executor *executor) {
+    std::unique_lock<std::mutex> lock(executor->mutex);
+    for (;;) {
+        bool timeout = false;
+        auto deadline = std::chrono::steady_clock::now() + executor->idle_time;
+        while (executor->tasks.empty() && executor->state == Executor::State::kRun && !timeout) {
+            timeout = (executor->empty_condition.wait_until(lock, deadline) == std::cv_status::timeout);
+        }
+
+        // Pool is stopping and every task is done, or thread is spare and has nothing to do for too long
+        if (executor->tasks.empty() &&
+            (executor->state != Executor::State::kRun || executor->threads > executor->low_watermark)) {
+            break;
+        }
+        if (executor->tasks.empty()) {
+            continue;
+        }
+
+        Task task = std::move(executor->tasks.front().task);
+        executor->queue_latency.Record(std::chrono::steady_clock::now() - executor->tasks.front().since);
+        executor->tasks.pop_front();
+        executor->busy_threads++;
+
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            // Task is responsible to report own errors, pool thread must survive anyway
+        }
+        lock.lock();
+        executor->busy_threads--;
+    }
+
+    // Nothing touches executor after the last thread reports, waiting Stop could destroy it right away
+    if (--executor->threads == 0 && executor->state != Executor::State::kRun) {
+        executor->state = Executor::State::kStopped;
+        executor->stop_condition.notify_all();
+    }
+}
+
+// See Executor.h
+Executor::Executor(std::string name, std::size_t low_watermark, std::size_t high_watermark,
+                   std::size_t max_queue_size, std::chrono::milliseconds idle_time)
+    : name(std::move(name)), low_watermark(low_watermark), high_watermark(std::max<std::size_t>(1, high_watermark)),
+      max_queue_size(max_queue_size), idle_time(idle_time), threads(0), busy_threads(0), state(State::kRun) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (threads < std::min(this->low_watermark, this->high_watermark)) {
+        Spawn();
+    }
+}
+
+// See Executor.h
+Executor::~Executor() { Stop(true); }
+
+// See Executor.h
+void Executor::Stop(bool await) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (state == State::kRun) {
+        state = (threads > 0) ? State::kStopping : State::kStopped;
+        empty_condition.notify_all();
+    }
+
+    while (await && state != State::kStopped) {
+        stop_condition.wait(lock);
+    }
+}
+
+// See Executor.h
+bool Executor::Post(Task &&task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (state != State::kRun) {
+        return false;
+    }
+
+    // Tasks which free threads are about to take don't count, only the ones left waiting for a thread do
+    std::size_t free_threads = threads - busy_threads;
+    if (tasks.size() >= free_threads + max_queue_size && threads >= high_watermark) {
+        return false;
+    }
+
+    // Enqueue new task, add one more thread if there is nobody free to take it
+    tasks.emplace_back(std::move(task));
+    if (tasks.size() > free_threads && threads < high_watermark) {
+        Spawn();
+    } else {
+        empty_condition.notify_one();
+    }
+    return true;
+}
+
+// See Executor.h
+std::size_t Executor::Threads() {
+    std::unique_lock<std::mutex> lock(mutex);
+    return threads;
+}
+
+// See Executor.h
+std::size_t Executor::BusyThreads() {
+    std::unique_lock<std::mutex> lock(mutex);
+    return busy_threads;
+}
+
+// See Executor.h
+std::size_t Executor::QueueSize() {
+    std::unique_lock<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+// See Executor.h
+void Executor::Spawn() {
+    std::thread(&perform, this).detach();
+    threads++;
+}
+
+} // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,94 @@
+#include <afina/concurrency/Histogram.h>
+
+namespace Afina {
+namespace Concurrency {
+
+constexpr std::size_t Histogram::kBuckets;
+
+// See Histogram.h
+Histogram::Histogram() { Reset(); }
+
+// See Histogram.h
+std::size_t Histogram::Bucket(uint64_t value) {
+    if (value < 4) {
+        return value;
+    }
+
+    // Power of two range, then one of four equal parts of it by the two bits following the leading one
+    std::size_t exponent = 63 - __builtin_clzll(value);
+    return 4 * (exponent - 1) + ((value >> (exponent - 2)) & 3);
+}
+
+// See Histogram.h
+uint64_t Histogram::UpperBound(std::size_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+
+    std::size_t exponent = bucket / 4 + 1;
+    uint64_t width = uint64_t(1) << (exponent - 2);
+    uint64_t lower = (4 + bucket % 4) * width;
+    return lower + (width - 1);
+}
+
+// See Histogram.h
+void Histogram::Record(std::chrono::nanoseconds value) {
+    uint64_t ns = (value.count() > 0) ? static_cast<uint64_t>(value.count()) : 0;
+    _buckets[Bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = _max.load(std::memory_order_relaxed);
+    while (ns > max && !_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+// See Histogram.h
+uint64_t Histogram::Count() const { return _count.load(std::memory_order_relaxed); }
+
+// See Histogram.h
+std::chrono::nanoseconds Histogram::Max() const {
+    return std::chrono::nanoseconds(_max.load(std::memory_order_relaxed));
+}
+
+// See Histogram.h
+std::chrono::nanoseconds Histogram::Percentile(double quantile) const {
+    uint64_t total = 0;
+    for (std::size_t i = 0; i < kBuckets; i++) {
+        total += _buckets[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+
+    // Rank of the value asked for, 1 based
+    uint64_t rank = static_cast<uint64_t>(quantile * total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    } else if (rank > total) {
+        rank = total;
+    }
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; i++) {
+        seen += _buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Bucket bound might be far above anything recorded for the top buckets
+            uint64_t bound = UpperBound(i);
+            uint64_t max = _max.load(std::memory_order_relaxed);
+            return std::chrono::nanoseconds(bound < max ? bound : max);
+        }
+    }
+    return Max();
+}
+
+// See Histogram.h
+void Histogram::Reset() {
+    for (std::size_t i = 0; i < kBuckets; i++) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,184 @@
+#include <afina/concurrency/StealingExecutor.h>
+
+#include <algorithm>
+
+namespace Afina {
+namespace Concurrency {
+
+// How often thread looks into the shared queue before own deque
+static constexpr uint32_t kSharedCheckInterval = 61;
+
+thread_local StealingExecutor::Worker *StealingExecutor::_current = nullptr;
+
+// See StealingExecutor.h
+StealingExecutor::StealingExecutor(std::string name, std::size_t threads, std::size_t max_queue_size)
+    : _name(std::move(name)), _max_queue_size(max_queue_size), _shared_size(0), _sleeping(0), _pending(0), _busy(0),
+      _steals(0), _running(true) {
+    threads = std::max<std::size_t>(1, threads);
+    for (std::size_t i = 0; i < threads; i++) {
+        _workers.emplace_back(new Worker(this, 2654435761u * (i + 1)));
+    }
+
+    // All deques must exist before any thread starts to steal
+    for (auto &worker : _workers) {
+        Worker *self = worker.get();
+        self->thread = std::thread([this, self] { Run(*self); });
+    }
+}
+
+// See StealingExecutor.h
+StealingExecutor::~StealingExecutor() { Stop(true); }
+
+// See StealingExecutor.h
+bool StealingExecutor::Post(Task &&task) {
+    // Count task before checking the state, so that threads can't exit while it is on the way to a queue
+    std::size_t pending = _pending.fetch_add(1);
+    std::size_t busy = _busy.load(std::memory_order_relaxed);
+    std::size_t free_threads = (busy < _workers.size()) ? _workers.size() - busy : 0;
+    if (!_running.load() || pending >= free_threads + _max_queue_size) {
+        _pending.fetch_sub(1);
+        return false;
+    }
+
+    Queued *queued = new Queued(std::move(task));
+    if (_current != nullptr && _current->owner == this) {
+        _current->tasks.Push(queued);
+    } else {
+        std::unique_lock<std::mutex> lock(_shared_lock);
+        _shared.push_back(queued);
+        _shared_size.fetch_add(1, std::memory_order_release);
+    }
+
+    Notify();
+    return true;
+}
+
+// See StealingExecutor.h
+void StealingExecutor::Stop(bool await) {
+    _running.store(false);
+    {
+        std::unique_lock<std::mutex> lock(_park_lock);
+        _park.notify_all();
+    }
+
+    if (await) {
+        std::unique_lock<std::mutex> lock(_stop_lock);
+        for (auto &worker : _workers) {
+            if (worker->thread.joinable() && worker->thread.get_id() != std::this_thread::get_id()) {
+                worker->thread.join();
+            }
+        }
+    }
+}
+
+// See StealingExecutor.h
+void StealingExecutor::Run(Worker &self) {
+    _current = &self;
+    for (;;) {
+        Queued *queued = Next(self);
+        if (queued != nullptr) {
+            _busy.fetch_add(1, std::memory_order_relaxed);
+            _pending.fetch_sub(1);
+            _queue_latency.Record(std::chrono::steady_clock::now() - queued->since);
+            try {
+                queued->task();
+            } catch (...) {
+                // Task is responsible to report own errors, pool thread must survive anyway
+            }
+            delete queued;
+            _busy.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // Pool is stopping and every task is done
+        if (!_running.load() && _pending.load() == 0) {
+            break;
+        }
+
+        // Sleeping counter is published before the check, Notify reads it after publishing the task,
+        // so at least one side sees the other
+        std::unique_lock<std::mutex> lock(_park_lock);
+        _sleeping.fetch_add(1);
+        while (!HasWork() && _running.load()) {
+            _park.wait(lock);
+        }
+        _sleeping.fetch_sub(1);
+    }
+    _current = nullptr;
+}
+
+// See StealingExecutor.h
+StealingExecutor::Queued *StealingExecutor::Next(Worker &self) {
+    Queued *queued = nullptr;
+    if (++self.ticks % kSharedCheckInterval == 0) {
+        queued = TakeShared();
+    }
+    if (queued == nullptr) {
+        queued = self.tasks.Pop();
+    }
+    if (queued == nullptr) {
+        queued = TakeShared();
+    }
+    if (queued == nullptr) {
+        queued = Steal(self);
+    }
+    return queued;
+}
+
+// See StealingExecutor.h
+StealingExecutor::Queued *StealingExecutor::Steal(Worker &self) {
+    std::size_t n = _workers.size();
+    if (n < 2) {
+        return nullptr;
+    }
+
+    // xorshift32, start from a random victim so that thieves don't all hit the same one
+    self.seed ^= self.seed << 13;
+    self.seed ^= self.seed >> 17;
+    self.seed ^= self.seed << 5;
+
+    std::size_t start = self.seed % n;
+    for (std::size_t i = 0; i < n; i++) {
+        Worker *victim = _workers[(start + i) % n].get();
+        if (victim == &self) {
+            continue;
+        }
+
+        Queued *queued = victim->tasks.Steal();
+        if (queued != nullptr) {
+            _steals.fetch_add(1, std::memory_order_relaxed);
+            return queued;
+        }
+    }
+    return nullptr;
+}
+
+// See StealingExecutor.h
+StealingExecutor::Queued *StealingExecutor::TakeShared() {
+    if (_shared_size.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(_shared_lock);
+    if (_shared.empty()) {
+        return nullptr;
+    }
+    Queued *queued = _shared.front();
+    _shared.pop_front();
+    _shared_size.fetch_sub(1, std::memory_order_relaxed);
+    return queued;
+}
+
+// See StealingExecutor.h
+bool StealingExecutor::HasWork() const { return _pending.load() > 0; }
+
+// See StealingExecutor.h
+void StealingExecutor::Notify() {
+    if (_sleeping.load() > 0) {
+        std::unique_lock<std::mutex> lock(_park_lock);
+        _park.notify_one();
+    }
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,264 @@
+#include <afina/concurrency/Topology.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+// Where kernel describes CPUs
+const char kSysfsRoot[] = "/sys/devices/system/cpu";
+
+/**
+ * Parse CPU list such as "0-3,8,10-11"
+ */
+std::vector<int> ParseList(const std::string &list) {
+    std::vector<int> result;
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+        std::size_t end = list.find(',', pos);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+
+        std::string range = list.substr(pos, end - pos);
+        std::size_t dash = range.find('-');
+        char *tail = nullptr;
+        long first = std::strtol(range.c_str(), &tail, 10);
+        long last = first;
+        if (dash != std::string::npos) {
+            last = std::strtol(range.c_str() + dash + 1, &tail, 10);
+        }
+        if (tail == range.c_str() || first < 0 || last < first) {
+            throw std::runtime_error("Malformed CPU list: " + list);
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            result.push_back(int(cpu));
+        }
+        pos = end + 1;
+    }
+    return result;
+}
+
+/**
+ * Single line of sysfs file, false if there is no such file
+ */
+bool ReadLine(const std::string &path, std::string &line) {
+    std::ifstream in(path);
+    if (!in || !std::getline(in, line)) {
+        return false;
+    }
+    while (!line.empty() && (line.back() == '\n' || line.back() == ' ')) {
+        line.pop_back();
+    }
+    return true;
+}
+
+// Integer from sysfs file or the fallback if there is none
+int ReadInt(const std::string &path, int fallback) {
+    std::string line;
+    if (!ReadLine(path, line) || line.empty()) {
+        return fallback;
+    }
+    return std::atoi(line.c_str());
+}
+
+// NUMA node CPU belongs to, kernel links it as nodeN in the CPU directory
+int ReadNode(const std::string &cpu_dir) {
+    DIR *dir = opendir(cpu_dir.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+
+    int node = 0;
+    while (struct dirent *entry = readdir(dir)) {
+        char *tail = nullptr;
+        if (std::strncmp(entry->d_name, "node", 4) == 0) {
+            long value = std::strtol(entry->d_name + 4, &tail, 10);
+            if (tail != entry->d_name + 4 && *tail == '\0') {
+                node = int(value);
+                break;
+            }
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+} // namespace
+
+// See Topology.h
+Topology::Topology(std::vector<Cpu> cpus) : _cpus(std::move(cpus)) {
+    std::sort(_cpus.begin(), _cpus.end(), [](const Cpu &a, const Cpu &b) { return a.id < b.id; });
+}
+
+// See Topology.h
+Topology Topology::Detect() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool masked = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    std::vector<Cpu> cpus;
+    try {
+        for (const Cpu &cpu : Read(kSysfsRoot).Cpus()) {
+            if (!masked || (cpu.id < CPU_SETSIZE && CPU_ISSET(cpu.id, &allowed))) {
+                cpus.push_back(cpu);
+            }
+        }
+    } catch (std::runtime_error &) {
+        cpus.clear();
+    }
+
+    if (cpus.empty()) {
+        int n = masked ? CPU_SETSIZE : int(std::max(1u, std::thread::hardware_concurrency()));
+        for (int id = 0; id < n; id++) {
+            if (!masked || CPU_ISSET(id, &allowed)) {
+                cpus.push_back(Cpu{id, id, 0, 0});
+            }
+        }
+    }
+    return Topology(std::move(cpus));
+}
+
+// See Topology.h
+Topology Topology::Read(const std::string &root) {
+    std::string online;
+    if (!ReadLine(root + "/online", online)) {
+        throw std::runtime_error("Failed to read online CPUs from " + root);
+    }
+
+    std::vector<Cpu> cpus;
+    for (int id : ParseList(online)) {
+        std::string dir = root + "/cpu" + std::to_string(id);
+        Cpu cpu;
+        cpu.id = id;
+        cpu.core = ReadInt(dir + "/topology/core_id", id);
+        cpu.package = ReadInt(dir + "/topology/physical_package_id", 0);
+        cpu.node = ReadNode(dir);
+        cpus.push_back(cpu);
+    }
+    return Topology(std::move(cpus));
+}
+
+// See Topology.h
+Topology::Placement Topology::ParsePlacement(const std::string &name) {
+    if (name == "none") {
+        return Placement::None;
+    } else if (name == "compact") {
+        return Placement::Compact;
+    } else if (name == "scatter") {
+        return Placement::Scatter;
+    }
+    throw std::runtime_error("Unknown placement: " + name);
+}
+
+// See Topology.h
+int Topology::Pin(std::thread &thread, int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return EINVAL;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+}
+
+// See Topology.h
+std::size_t Topology::Cores() const {
+    std::set<std::pair<int, int>> cores;
+    for (const Cpu &cpu : _cpus) {
+        cores.emplace(cpu.package, cpu.core);
+    }
+    return cores.size();
+}
+
+// See Topology.h
+std::size_t Topology::Nodes() const {
+    std::set<int> nodes;
+    for (const Cpu &cpu : _cpus) {
+        nodes.insert(cpu.node);
+    }
+    return nodes.size();
+}
+
+// See Topology.h
+std::vector<int> Topology::Order(Placement placement) const {
+    std::vector<int> result;
+    if (placement == Placement::None) {
+        return result;
+    }
+
+    // Nearest CPUs are next to each other: siblings of a core, cores of a package, packages of a node
+    std::vector<Cpu> cpus(_cpus);
+    std::sort(cpus.begin(), cpus.end(), [](const Cpu &a, const Cpu &b) {
+        return std::tie(a.node, a.package, a.core, a.id) < std::tie(b.node, b.package, b.core, b.id);
+    });
+
+    if (placement == Placement::Compact) {
+        for (const Cpu &cpu : cpus) {
+            result.push_back(cpu.id);
+        }
+        return result;
+    }
+
+    // Scatter: the first hyperthreads of all cores go before the second ones, and within each round packages
+    // take turns, so that consecutive threads land as far from each other as possible
+    std::map<std::pair<int, int>, int> siblings;
+    std::map<int, std::map<std::pair<int, int>, std::vector<int>>> rounds;
+    for (const Cpu &cpu : cpus) {
+        int sibling = siblings[std::make_pair(cpu.package, cpu.core)]++;
+        rounds[sibling][std::make_pair(cpu.node, cpu.package)].push_back(cpu.id);
+    }
+
+    for (auto &round : rounds) {
+        std::vector<std::pair<std::vector<int>::const_iterator, std::vector<int>::const_iterator>> packages;
+        for (auto &package : round.second) {
+            packages.emplace_back(package.second.begin(), package.second.end());
+        }
+
+        bool left = true;
+        while (left) {
+            left = false;
+            for (auto &package : packages) {
+                if (package.first != package.second) {
+                    result.push_back(*package.first++);
+                    left = true;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// See Topology.h
+std::vector<int> Topology::Leaders() const {
+    // CPUs are ordered by id, so the first one seen for a package is the lowest
+    std::map<std::pair<int, int>, int> leaders;
+    for (const Cpu &cpu : _cpus) {
+        leaders.emplace(std::make_pair(cpu.node, cpu.package), cpu.id);
+    }
+
+    std::vector<int> result;
+    for (auto &leader : leaders) {
+        result.push_back(leader.second);
+    }
+    return result;
+}
+
+} // namespace Concurrency
+} // namespace Afina
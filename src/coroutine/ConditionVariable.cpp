@@ -0,0 +1,34 @@
+#include <afina/coroutine/ConditionVariable.h>
+
+#include <afina/coroutine/Engine.h>
+
+namespace Afina {
+namespace Coroutine {
+
+// See ConditionVariable.h
+void ConditionVariable::wait(Mutex &mutex) {
+    // Engine is single threaded, so nobody could notify between unlock and block
+    _waiters.push_back(_engine.current());
+    mutex.unlock();
+    _engine.block();
+    mutex.lock();
+}
+
+// See ConditionVariable.h
+void ConditionVariable::notify_one() {
+    if (!_waiters.empty()) {
+        _engine.unblock(_waiters.front());
+        _waiters.pop_front();
+    }
+}
+
+// See ConditionVariable.h
+void ConditionVariable::notify_all() {
+    for (auto routine : _waiters) {
+        _engine.unblock(routine);
+    }
+    _waiters.clear();
+}
+
+} // namespace Coroutine
+} // namespace Afina
@@ -0,0 +1,132 @@
+#include "Context.h"
+
+#include <cstdint>
+
+#if !defined(__x86_64__)
+#include <new>
+#include <stdexcept>
+#include <ucontext.h>
+#endif
+
+namespace Afina {
+namespace Coroutine {
+
+#if defined(__x86_64__)
+
+extern "C" {
+void afina_coroutine_swap(void **from, void *to);
+void afina_coroutine_boot();
+}
+
+// Only callee saved registers have to survive the switch, everything else is already spilled by compiler
+// around the call. Fresh context gets entry and argument in r12/r13, boot moves them where ABI expects
+asm(R"(
+    .text
+    .globl afina_coroutine_swap
+    .type afina_coroutine_swap, @function
+afina_coroutine_swap:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size afina_coroutine_swap, .-afina_coroutine_swap
+
+    .globl afina_coroutine_boot
+    .type afina_coroutine_boot, @function
+afina_coroutine_boot:
+    movq %r13, %rdi
+    callq *%r12
+    ud2
+    .size afina_coroutine_boot, .-afina_coroutine_boot
+
+    .section .note.GNU-stack, "", @progbits
+    .text
+)");
+
+// See Context.h
+void *MakeContext(char *stack, std::size_t size, void (*entry)(void *), void *arg) {
+    // Stack pointer must be 16 bytes aligned once boot is entered by ret from swap
+    uintptr_t top = (reinterpret_cast<uintptr_t>(stack) + size) & ~uintptr_t(15);
+    void **sp = reinterpret_cast<void **>(top) - 7;
+
+    sp[0] = nullptr;                                           // r15
+    sp[1] = nullptr;                                           // r14
+    sp[2] = arg;                                               // r13
+    sp[3] = reinterpret_cast<void *>(entry);                   // r12
+    sp[4] = nullptr;                                           // rbx
+    sp[5] = nullptr;                                           // rbp
+    sp[6] = reinterpret_cast<void *>(&afina_coroutine_boot);   // return address
+    return sp;
+}
+
+// See Context.h
+void SwapContext(void **from, void *to) { afina_coroutine_swap(from, to); }
+
+// See Context.h
+void FreeContext(void *ctx) {}
+
+#else
+
+namespace {
+
+// ucontext based fallback for the rest of architectures, much slower as swapcontext does a syscall
+// to save signal mask
+struct UContext {
+    ucontext_t uc;
+    void (*entry)(void *);
+    void *arg;
+};
+
+// makecontext passes int arguments only, so pointer is split in halves
+void Boot(unsigned hi, unsigned lo) {
+    UContext *ctx = reinterpret_cast<UContext *>((uintptr_t(hi) << 32) | uintptr_t(lo));
+    ctx->entry(ctx->arg);
+}
+
+} // namespace
+
+// See Context.h
+void *MakeContext(char *stack, std::size_t size, void (*entry)(void *), void *arg) {
+    UContext *ctx = new UContext();
+    if (getcontext(&ctx->uc) != 0) {
+        delete ctx;
+        throw std::runtime_error("Failed to get context");
+    }
+
+    ctx->uc.uc_stack.ss_sp = stack;
+    ctx->uc.uc_stack.ss_size = size;
+    ctx->uc.uc_link = nullptr;
+    ctx->entry = entry;
+    ctx->arg = arg;
+
+    uintptr_t p = reinterpret_cast<uintptr_t>(ctx);
+    makecontext(&ctx->uc, reinterpret_cast<void (*)()>(&Boot), 2, unsigned(uint64_t(p) >> 32), unsigned(p));
+    return ctx;
+}
+
+// See Context.h
+void SwapContext(void **from, void *to) {
+    if (*from == nullptr) {
+        *from = new UContext();
+    }
+    swapcontext(&static_cast<UContext *>(*from)->uc, &static_cast<UContext *>(to)->uc);
+}
+
+// See Context.h
+void FreeContext(void *ctx) { delete static_cast<UContext *>(ctx); }
+
+#endif
+
+} // namespace Coroutine
+} // namespace Afina
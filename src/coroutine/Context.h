@@ -0,0 +1,38 @@
+#ifndef AFINA_COROUTINE_CONTEXT_H
+#define AFINA_COROUTINE_CONTEXT_H
+
+#include <cstddef>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Machine context of routine running on its own stack
+ * Context is an opaque handle: on x86-64 it is the stack pointer of suspended routine with callee saved
+ * registers pushed onto its stack, elsewhere it points to ucontext_t.
+ */
+
+/**
+ * Prepare fresh context which calls entry(arg) once switched to. Entry must never return
+ *
+ * @param stack lowest address of the memory to be used as stack
+ * @param size size of the stack memory
+ * @return handle to be passed to SwapContext
+ */
+void *MakeContext(char *stack, std::size_t size, void (*entry)(void *), void *arg);
+
+/**
+ * Save current context into *from and resume the given one. Returns once some other context switches
+ * back to the saved one
+ */
+void SwapContext(void **from, void *to);
+
+/**
+ * Release resources of the context made by MakeContext or saved by SwapContext, if there are any
+ */
+void FreeContext(void *ctx);
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_CONTEXT_H
@@ -1,19 +1,342 @@
 #include <afina/coroutine/Engine.h>
 
+#include <thread>
+
+#include <alloca.h>
 #include <setjmp.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "coroutine/Context.h"
+
 namespace Afina {
 namespace Coroutine {
 
-void Engine::Store(context &ctx) {}
+// See Engine.h
+void Engine::Store(context &ctx) {
+    // Stack grows down, so everything between current frame and the bottom belongs to the running routine
+    char StackStartsHere;
+    ctx.Low = ctx.Hight = StackBottom;
+    if (&StackStartsHere > StackBottom) {
+        ctx.Hight = &StackStartsHere;
+    } else {
+        ctx.Low = &StackStartsHere;
+    }
+
+    uint32_t size = ctx.Hight - ctx.Low;
+    char *&buffer = std::get<0>(ctx.Stack);
+    uint32_t &capacity = std::get<1>(ctx.Stack);
+    if (capacity < size) {
+        delete[] buffer;
+        buffer = new char[size];
+        capacity = size;
+    }
+    memcpy(buffer, ctx.Low, size);
+}
+
+// Copies saved stack back in place and jumps into it. Must have own frame below the region being restored as
+// everything in that region gets overwritten
+static void __attribute__((noinline)) CopyAndJump(char *dst, const char *src, std::size_t size, jmp_buf env) {
+    memcpy(dst, src, size);
+    longjmp(env, 1);
+}
+
+// See Engine.h
+void Engine::Restore(context &ctx) {
+    // Copying stack back overwrites the region current frame might live in. Move stack pointer below
+    // the region first, so that the frame doing copy doesn't destroy itself
+    char StackStartsHere;
+    if (&StackStartsHere >= ctx.Low) {
+        volatile char *pad = static_cast<char *>(alloca(&StackStartsHere - ctx.Low + 256));
+        pad[0] = 0;
+    }
+
+    CopyAndJump(ctx.Low, std::get<0>(ctx.Stack), ctx.Hight - ctx.Low, ctx.Environment);
+}
+
+// See Engine.h
+void Engine::Forget(context *ctx) {
+    for (context *list : {alive, blocked}) {
+        for (context *it = list; it != nullptr; it = it->next) {
+            if (it->caller == ctx) {
+                it->caller = nullptr;
+            }
+        }
+    }
+    if (idle_ctx != nullptr && idle_ctx->caller == ctx) {
+        idle_ctx->caller = nullptr;
+    }
+}
+
+// See Engine.h
+Engine::context *Engine::Retire(context *ctx) {
+    Unlink(alive, ctx);
+
+    // Nobody could return into the finished routine anymore
+    context *caller = ctx->caller;
+    Forget(ctx);
+
+    if (caller != nullptr && !caller->blocked) {
+        return caller;
+    }
+    return idle_ctx;
+}
+
+// See Engine.h
+void Engine::Link(context *&list, context *ctx) {
+    ctx->prev = nullptr;
+    ctx->next = list;
+    if (list != nullptr) {
+        list->prev = ctx;
+    }
+    list = ctx;
+}
+
+// See Engine.h
+void Engine::Unlink(context *&list, context *ctx) {
+    if (ctx->prev != nullptr) {
+        ctx->prev->next = ctx->next;
+    }
+
+    if (ctx->next != nullptr) {
+        ctx->next->prev = ctx->prev;
+    }
+
+    if (list == ctx) {
+        list = ctx->next;
+    }
+    ctx->prev = ctx->next = nullptr;
+}
+
+// See Engine.h
+void Engine::Prepare(context &ctx) {
+    ctx.StackMemory = stack_pool.Acquire();
+    ctx.Machine = MakeContext(ctx.StackMemory, stack_pool.StackSize(), &Engine::Trampoline, this);
+}
+
+// See Engine.h
+void Engine::Switch(context &from, context &to) {
+    SwapContext(&from.Machine, to.Machine);
+
+    // Routine which has switched here might have finished
+    Reap();
+}
+
+// See Engine.h
+void Engine::Reap() {
+    if (zombie == nullptr) {
+        return;
+    }
+
+    Release(zombie);
+    zombie = nullptr;
+}
+
+// See Engine.h
+void Engine::Release(context *ctx) {
+    FreeContext(ctx->Machine);
+    delete ctx->Entry;
+    if (ctx->StackMemory != nullptr) {
+        stack_pool.Release(ctx->StackMemory);
+    }
+    delete[] std::get<0>(ctx->Stack);
+    delete ctx;
+}
+
+// See Engine.h
+void Engine::Trampoline(void *engine) {
+    Engine *self = static_cast<Engine *>(engine);
+    self->Reap();
+
+    context *pc = self->cur_routine;
+    (*pc->Entry)();
+    delete pc->Entry;
+    pc->Entry = nullptr;
+
+    // Same as in CopyStack mode: pass control back to the caller or to the engine itself. Stack of the
+    // routine is still in use until the switch, so the one who gets control frees it
+    context *next = self->Retire(pc);
+    self->cur_routine = (next != self->idle_ctx) ? next : nullptr;
+    self->zombie = pc;
+    SwapContext(&pc->Machine, next->Machine);
+}
+
+// See Engine.h
+void Engine::Enter(context &ctx) {
+    context *from = cur_routine;
+    cur_routine = (&ctx != idle_ctx) ? &ctx : nullptr;
+
+    if (mode == Mode::SeparateStacks) {
+        Switch((from != nullptr) ? *from : *idle_ctx, ctx);
+        return;
+    }
+
+    // Remember where to continue once control gets back to the current routine. Engine itself (start) keeps
+    // its state in idle context once and always restarts from there
+    if (from != nullptr) {
+        if (setjmp(from->Environment) > 0) {
+            return;
+        }
+        Store(*from);
+    }
+    Restore(ctx);
+}
+
+// See Engine.h
+void Engine::Wake() {
+    if (timers.empty()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    while (!timers.empty() && timers.begin()->first <= now) {
+        context *ctx = timers.begin()->second;
+        timers.erase(timers.begin());
+        ctx->sleeping = false;
+        unblock(ctx);
+    }
+}
+
+// See Engine.h
+void Engine::Schedule() {
+    for (;;) {
+        Wake();
+        if (alive != nullptr) {
+            Enter(*alive);
+        } else if (!timers.empty()) {
+            std::this_thread::sleep_until(timers.begin()->first);
+        } else {
+            return;
+        }
+    }
+}
+
+// See Engine.h
+void Engine::Shutdown() {
+    Reap();
+
+    // Nobody could unblock routines left, so they never complete
+    while (blocked != nullptr) {
+        context *ctx = blocked;
+        Unlink(blocked, ctx);
+        Release(ctx);
+    }
+
+    Release(idle_ctx);
+    idle_ctx = nullptr;
+}
+
+// See Engine.h
+void Engine::yield() {
+    Wake();
+
+    // Round robin over ready routines, so that every one gets its turn
+    context *next = (cur_routine != nullptr) ? cur_routine->next : nullptr;
+    if (next == nullptr) {
+        next = alive;
+    }
+
+    if (next != nullptr && next != cur_routine) {
+        Enter(*next);
+    }
+}
+
+// See Engine.h
+void Engine::sched(void *routine_) {
+    context *ctx = static_cast<context *>(routine_);
+    if (ctx == nullptr) {
+        // Returning to the caller doesn't make current routine the caller of it
+        ctx = (cur_routine != nullptr) ? cur_routine->caller : nullptr;
+        if (ctx == nullptr || ctx->blocked) {
+            yield();
+        } else {
+            Enter(*ctx);
+        }
+        return;
+    }
+
+    if (ctx == cur_routine || ctx->blocked) {
+        return;
+    }
+
+    ctx->caller = cur_routine;
+    Enter(*ctx);
+}
+
+// See Engine.h
+void Engine::block(void *routine_) {
+    context *ctx = (routine_ != nullptr) ? static_cast<context *>(routine_) : cur_routine;
+    if (ctx == nullptr || ctx->blocked) {
+        return;
+    }
+
+    Unlink(alive, ctx);
+    Link(blocked, ctx);
+    ctx->blocked = true;
+    if (ctx != cur_routine) {
+        return;
+    }
+
+    // Current routine can't continue, pass control to its caller, any other ready routine or the engine itself
+    Wake();
+    context *next = ctx->caller;
+    if (next == nullptr || next->blocked) {
+        next = (alive != nullptr) ? alive : idle_ctx;
+    }
+    Enter(*next);
+}
+
+// See Engine.h
+void Engine::unblock(void *routine_) {
+    context *ctx = static_cast<context *>(routine_);
+    if (ctx == nullptr || !ctx->blocked) {
+        return;
+    }
+
+    if (ctx->sleeping) {
+        timers.erase(ctx->timer);
+        ctx->sleeping = false;
+    }
+
+    Unlink(blocked, ctx);
+    Link(alive, ctx);
+    ctx->blocked = false;
+}
+
+// See Engine.h
+void Engine::sleep(std::chrono::milliseconds timeout) {
+    if (cur_routine == nullptr) {
+        std::this_thread::sleep_for(timeout);
+        return;
+    }
+
+    cur_routine->timer = timers.emplace(std::chrono::steady_clock::now() + timeout, cur_routine);
+    cur_routine->sleeping = true;
+    block();
+}
+
+// See Engine.h
+int Engine::idle_timeout() const {
+    for (context *it = alive; it != nullptr; it = it->next) {
+        if (it != cur_routine) {
+            return 0;
+        }
+    }
 
-void Engine::Restore(context &ctx) {}
+    if (timers.empty()) {
+        return -1;
+    }
 
-void Engine::yield() {}
+    auto left = timers.begin()->first - std::chrono::steady_clock::now();
+    if (left.count() <= 0) {
+        return 0;
+    }
 
-void Engine::sched(void *routine_) {}
+    // Round up, otherwise caller would wake up a bit before the timer and spin
+    return std::chrono::duration_cast<std::chrono::milliseconds>(left + std::chrono::milliseconds(1) -
+                                                                  std::chrono::nanoseconds(1))
+        .count();
+}
 
 } // namespace Coroutine
 } // namespace Afina
@@ -0,0 +1,49 @@
+#include <afina/coroutine/Mutex.h>
+
+#include <stdexcept>
+
+#include <afina/coroutine/Engine.h>
+
+namespace Afina {
+namespace Coroutine {
+
+// See Mutex.h
+void Mutex::lock() {
+    void *self = _engine.current();
+    if (self == nullptr) {
+        throw std::runtime_error("Mutex could be locked by routine only");
+    }
+
+    if (_owner == nullptr) {
+        _owner = self;
+        return;
+    }
+
+    // Whoever unlocks hands the mutex over before unblocking us
+    _waiters.push_back(self);
+    _engine.block();
+}
+
+// See Mutex.h
+bool Mutex::try_lock() {
+    if (_owner != nullptr) {
+        return false;
+    }
+    _owner = _engine.current();
+    return true;
+}
+
+// See Mutex.h
+void Mutex::unlock() {
+    if (_waiters.empty()) {
+        _owner = nullptr;
+        return;
+    }
+
+    _owner = _waiters.front();
+    _waiters.pop_front();
+    _engine.unblock(_owner);
+}
+
+} // namespace Coroutine
+} // namespace Afina
@@ -0,0 +1,424 @@
+#include <afina/coroutine/Scheduler.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "coroutine/Context.h"
+
+namespace Afina {
+namespace Coroutine {
+
+namespace {
+
+// Processor served by the calling thread, nullptr for threads outside of any scheduler. Routine could move
+// to another thread at any switch, so it is read in out of line functions only, never cached across switch
+thread_local void *current_processor = nullptr;
+
+// How often busy processor looks for IO events and global queue, in switches. Prime, so that it doesn't
+// resonate with routines doing fixed number of steps between switches
+constexpr uint32_t kCheckInterval = 61;
+
+} // namespace
+
+// See Scheduler.h
+Scheduler::Scheduler(std::size_t workers, std::size_t stack_size)
+    : _global_size(0), _stacks(stack_size), _epoll_fd(-1), _wakeup_fd(-1), _done_fd(-1), _alive(0), _sleeping(0),
+      _notified(false), _steals(0), _stopping(false) {
+    if (workers == 0) {
+        workers = 1;
+    }
+
+    _processors.reserve(workers);
+    for (std::size_t i = 0; i < workers; i++) {
+        _processors.emplace_back(new Processor());
+        _processors.back()->scheduler = this;
+        _processors.back()->index = i;
+        _processors.back()->seed = 2654435761u * (i + 1);
+    }
+}
+
+// See Scheduler.h
+Scheduler::~Scheduler() {
+    bool running = false;
+    for (auto &p : _processors) {
+        running = running || p->thread.joinable();
+    }
+
+    if (running) {
+        stop();
+        join();
+    }
+
+    // Scheduler has never been started
+    for (Routine *r : _global) {
+        Release(r);
+    }
+}
+
+// See Scheduler.h
+void Scheduler::start() {
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    _done_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_wakeup_fd == -1 || _done_fd == -1) {
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+    }
+
+    // Each write makes an edge which wakes up a single processor
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLET;
+    event.data.ptr = &_wakeup_fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wakeup_fd, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    // Never read, so that every processor sees it
+    event.events = EPOLLIN;
+    event.data.ptr = &_done_fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _done_fd, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    for (auto &p : _processors) {
+        p->thread = std::thread(&Scheduler::Loop, this, std::ref(*p));
+    }
+}
+
+// See Scheduler.h
+void Scheduler::stop() {
+    _stopping.store(true);
+    if (_alive.load() == 0 && _done_fd != -1) {
+        eventfd_write(_done_fd, 1);
+    }
+}
+
+// See Scheduler.h
+void Scheduler::join() {
+    for (auto &p : _processors) {
+        if (p->thread.joinable()) {
+            p->thread.join();
+        }
+    }
+
+    for (int *fd : {&_epoll_fd, &_wakeup_fd, &_done_fd}) {
+        if (*fd != -1) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+// See Scheduler.h
+void Scheduler::yield() {
+    Routine *r = Current();
+    if (r == nullptr) {
+        std::this_thread::yield();
+        return;
+    }
+
+    r->action = Action::kYield;
+    Suspend(*r);
+}
+
+// See Scheduler.h
+uint32_t Scheduler::wait(int fd, uint32_t events) {
+    Routine *r = Current();
+    if (r == nullptr) {
+        throw std::runtime_error("Scheduler::wait called outside of routine");
+    }
+
+    r->action = Action::kWait;
+    r->fd = fd;
+    r->events = events;
+    r->revents = 0;
+    Suspend(*r);
+    return r->revents;
+}
+
+// See Scheduler.h
+std::size_t Scheduler::stack_high_water() {
+    std::lock_guard<std::mutex> lock(_stacks_lock);
+    return _stacks.HighWater();
+}
+
+// See Scheduler.h
+void Scheduler::Spawn(Body *body) {
+    Routine *r = new Routine();
+    r->entry = body;
+    try {
+        std::lock_guard<std::mutex> lock(_stacks_lock);
+        r->stack = _stacks.Acquire();
+    } catch (...) {
+        delete body;
+        delete r;
+        throw;
+    }
+    r->machine = MakeContext(r->stack, _stacks.StackSize(), &Scheduler::Trampoline, r);
+    _alive.fetch_add(1);
+
+    // Routine spawned by another one is likely to work on the same data, keep it on the same core
+    Processor *p = static_cast<Processor *>(current_processor);
+    if (p != nullptr && p->scheduler == this) {
+        p->ready.Push(r);
+    } else {
+        std::lock_guard<std::mutex> lock(_global_lock);
+        _global.push_back(r);
+        _global_size.fetch_add(1);
+    }
+    Notify();
+}
+
+// See Scheduler.h
+void Scheduler::Loop(Processor &p) {
+    current_processor = &p;
+    for (;;) {
+        Routine *r = Next(p);
+        if (r != nullptr) {
+            Resume(p, *r);
+        } else if (!Park(p)) {
+            break;
+        }
+    }
+    current_processor = nullptr;
+}
+
+// See Scheduler.h
+Scheduler::Routine *Scheduler::Next(Processor &p) {
+    // Local work might keep processor busy forever, so IO and routines from outside get checked from time to
+    // time anyway
+    if (++p.ticks % kCheckInterval == 0) {
+        Poll(p, 0);
+        Routine *r = TakeGlobal();
+        if (r != nullptr) {
+            return r;
+        }
+    }
+
+    Routine *r = p.ready.Pop();
+    if (r == nullptr) {
+        r = TakeGlobal();
+    }
+    if (r == nullptr && Poll(p, 0) > 0) {
+        r = p.ready.Pop();
+    }
+    if (r == nullptr) {
+        r = Steal(p);
+    }
+    return r;
+}
+
+// See Scheduler.h
+Scheduler::Routine *Scheduler::Steal(Processor &p) {
+    std::size_t n = _processors.size();
+    if (n < 2) {
+        return nullptr;
+    }
+
+    // Start from random victim, so that thieves don't line up after the same one
+    p.seed ^= p.seed << 13;
+    p.seed ^= p.seed >> 17;
+    p.seed ^= p.seed << 5;
+    std::size_t start = p.seed % n;
+    for (std::size_t i = 0; i < n; i++) {
+        Processor &victim = *_processors[(start + i) % n];
+        if (&victim == &p) {
+            continue;
+        }
+
+        Routine *r = victim.ready.Steal();
+        if (r != nullptr) {
+            _steals.fetch_add(1, std::memory_order_relaxed);
+
+            // Victim has more than it could run right now, let one more processor help it
+            if (!victim.ready.Empty()) {
+                Notify();
+            }
+            return r;
+        }
+    }
+    return nullptr;
+}
+
+// See Scheduler.h
+Scheduler::Routine *Scheduler::TakeGlobal() {
+    if (_global_size.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(_global_lock);
+    if (_global.empty()) {
+        return nullptr;
+    }
+
+    Routine *r = _global.front();
+    _global.pop_front();
+    _global_size.fetch_sub(1);
+    return r;
+}
+
+// See Scheduler.h
+std::size_t Scheduler::Poll(Processor &p, int timeout) {
+    std::array<struct epoll_event, 64> events;
+    int n = epoll_wait(_epoll_fd, &events[0], events.size(), timeout);
+    if (n <= 0) {
+        return 0;
+    }
+
+    std::size_t woken = 0;
+    bool forward = false;
+    for (int i = 0; i < n; i++) {
+        void *ptr = events[i].data.ptr;
+        if (ptr == &_wakeup_fd) {
+            eventfd_t value;
+            eventfd_read(_wakeup_fd, &value);
+            _notified.store(false);
+
+            // Busy processor has got wakeup meant for the sleeping one, pass it on
+            forward = (timeout == 0);
+        } else if (ptr != &_done_fd) {
+            Routine *r = static_cast<Routine *>(ptr);
+            r->revents = events[i].events;
+            p.ready.Push(r);
+            woken++;
+        }
+    }
+
+    // This processor could run one routine at a time, the rest are for idle ones to steal
+    if (forward || woken > 1) {
+        Notify();
+    }
+    return woken;
+}
+
+// See Scheduler.h
+bool Scheduler::Park(Processor &p) {
+    // Once processor is counted as sleeping anyone making new work wakes it up, so check for work made
+    // right before that once again
+    _sleeping.fetch_add(1);
+
+    bool idle = (_global_size.load() == 0);
+    for (std::size_t i = 0; idle && i < _processors.size(); i++) {
+        idle = _processors[i]->ready.Empty();
+    }
+
+    bool done = _stopping.load() && _alive.load() == 0;
+    if (idle && !done) {
+        Poll(p, -1);
+    }
+
+    _sleeping.fetch_sub(1);
+    return !(_stopping.load() && _alive.load() == 0);
+}
+
+// See Scheduler.h
+void Scheduler::Notify() {
+    // Pairs with increment in Park: either parking processor sees the new work or this one sees it parking
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    // One wakeup in flight is enough, woken processor wakes up the next one if there is more work
+    if (!_notified.exchange(true)) {
+        eventfd_write(_wakeup_fd, 1);
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Resume(Processor &p, Routine &r) {
+    r.owner = &p;
+    p.current = &r;
+    SwapContext(&p.machine, r.machine);
+    p.current = nullptr;
+
+    // Routine is off the CPU now, so it is safe to let other processors pick it up. Routine must not be
+    // touched once it is handed over
+    switch (r.action) {
+    case Action::kYield: {
+        // Local deque is LIFO, routine would get control right back. Put it after everyone else instead
+        {
+            std::lock_guard<std::mutex> lock(_global_lock);
+            _global.push_back(&r);
+            _global_size.fetch_add(1);
+        }
+        Notify();
+        break;
+    }
+
+    case Action::kWait:
+        Arm(p, r);
+        break;
+
+    case Action::kFinish:
+        Release(&r);
+        break;
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Suspend(Routine &r) { SwapContext(&r.machine, r.owner->machine); }
+
+// See Scheduler.h
+void Scheduler::Arm(Processor &p, Routine &r) {
+    // Oneshot: event fires once and descriptor stays disabled until routine waits for it again, so no other
+    // processor could take the routine twice
+    struct epoll_event event;
+    event.events = r.events | EPOLLONESHOT;
+    event.data.ptr = &r;
+
+    int fd = r.fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0) {
+        return;
+    }
+    if (errno == ENOENT && epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0) {
+        return;
+    }
+
+    r.revents = EPOLLERR;
+    p.ready.Push(&r);
+}
+
+// See Scheduler.h
+void Scheduler::Release(Routine *r) {
+    FreeContext(r->machine);
+    delete r->entry;
+    {
+        std::lock_guard<std::mutex> lock(_stacks_lock);
+        _stacks.Release(r->stack);
+    }
+    delete r;
+
+    if (_alive.fetch_sub(1) == 1 && _stopping.load() && _done_fd != -1) {
+        eventfd_write(_done_fd, 1);
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Trampoline(void *routine) {
+    Routine *r = static_cast<Routine *>(routine);
+    (*r->entry)();
+
+    // Processor frees the routine once it is off this stack
+    r->action = Action::kFinish;
+    Suspend(*r);
+}
+
+// See Scheduler.h
+Scheduler::Routine *Scheduler::Current() {
+    Processor *p = static_cast<Processor *>(current_processor);
+    return (p != nullptr) ? p->current : nullptr;
+}
+
+} // namespace Coroutine
+} // namespace Afina
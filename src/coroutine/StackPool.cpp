@@ -0,0 +1,91 @@
+#include <afina/coroutine/StackPool.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Coroutine {
+
+constexpr std::size_t StackPool::kKeepResident;
+
+// See StackPool.h
+StackPool::StackPool(std::size_t stack_size, std::size_t max_cached)
+    : _page_size(sysconf(_SC_PAGESIZE)), _stack_size((stack_size + _page_size - 1) / _page_size * _page_size),
+      _max_cached(max_cached), _in_use(0), _high_water(0), _residency(_stack_size / _page_size) {}
+
+// See StackPool.h
+StackPool::~StackPool() {
+    for (auto stack : _free) {
+        munmap(stack - _page_size, _stack_size + _page_size);
+    }
+}
+
+// See StackPool.h
+char *StackPool::Acquire() {
+    if (!_free.empty()) {
+        char *stack = _free.back();
+        _free.pop_back();
+        _in_use++;
+        return stack;
+    }
+
+    // Reserve address space only, pages get committed once routine touches them
+    void *region = mmap(nullptr, _stack_size + _page_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if (region == MAP_FAILED) {
+        throw std::runtime_error("Failed to map coroutine stack: " + std::string(strerror(errno)));
+    }
+
+    // Stack grows down, so guard is the lowest page
+    if (mprotect(region, _page_size, PROT_NONE) != 0) {
+        munmap(region, _stack_size + _page_size);
+        throw std::runtime_error("Failed to protect coroutine stack guard: " + std::string(strerror(errno)));
+    }
+
+    _in_use++;
+    return static_cast<char *>(region) + _page_size;
+}
+
+// See StackPool.h
+void StackPool::Release(char *stack) {
+    _in_use--;
+
+    std::size_t used = Resident(stack);
+    if (used > _high_water) {
+        _high_water = used;
+    }
+
+    if (_free.size() >= _max_cached) {
+        munmap(stack - _page_size, _stack_size + _page_size);
+        return;
+    }
+
+    // Give deep pages back, next routine on this stack would commit them again only if it needs that much
+    if (used > kKeepResident) {
+        madvise(stack, _stack_size - kKeepResident, MADV_DONTNEED);
+    }
+    _free.push_back(stack);
+}
+
+// See StackPool.h
+std::size_t StackPool::Resident(char *stack) {
+    if (mincore(stack, _stack_size, &_residency[0]) != 0) {
+        return 0;
+    }
+
+    // Lowest resident page marks how deep the stack has grown
+    for (std::size_t i = 0; i < _residency.size(); i++) {
+        if (_residency[i] & 1) {
+            return _stack_size - i * _page_size;
+        }
+    }
+    return 0;
+}
+
+} // namespace Coroutine
+} // namespace Afina
@@ -9,12 +9,18 @@ namespace Execute {
 // memcached protocol: "append" means "add this data to an existing key after existing data".
 void Append::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Append(" << _key << ")" << args << std::endl;
-    std::string value;
+    StoredValue value;
     if (!storage.Get(_key, value)) {
         out.assign("NOT_STORED");
         return;
     }
-    storage.Put(_key, value + args);
+
+    // Append doesn't change flags and expiration time of the item
+    std::string result;
+    result.reserve(value.size + args.size());
+    result.append(value.data(), value.size);
+    result.append(args);
+    storage.Put(_key, result, value.flags, value.expire);
     out.assign("STORED");
 }
 
@@ -1 +1,23 @@
 #include <afina/execute/Command.h>
+
+namespace Afina {
+namespace Execute {
+
+// Biggest exptime that memcached treats as relative
+static const int32_t kMaxRelativeExptime = 60 * 60 * 24 * 30;
+
+// See Command.h
+time_t Command::ExpireAt(int32_t exptime) {
+    if (exptime == 0) {
+        return 0;
+    } else if (exptime < 0) {
+        // Any moment in the past
+        return 1;
+    } else if (exptime > kMaxRelativeExptime) {
+        return exptime;
+    }
+    return time(nullptr) + exptime;
+}
+
+} // namespace Execute
+} // namespace Afina
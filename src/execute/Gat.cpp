@@ -0,0 +1,13 @@
+#include <afina/Storage.h>
+#include <afina/execute/Gat.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Gat.h
+bool Gat::Fetch(Storage &storage, const std::string &key, StoredValue &value) {
+    return storage.GetAndTouch(key, ExpireAt(_expire), value);
+}
+
+} // namespace Execute
+} // namespace Afina
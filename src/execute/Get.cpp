@@ -1,9 +1,7 @@
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
 
-#include <iostream>
-#include <iterator>
-#include <sstream>
+#include <string>
 
 namespace Afina {
 namespace Execute {
@@ -22,22 +20,43 @@ to indicate the end of response.
 */
 
 void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::stringstream keyStream;
-    copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
-    std::cout << "Get(" << keyStream.str() << ")" << std::endl;
+    Response response;
+    Execute(storage, args, response);
 
-    std::stringstream outStream;
+    // networking layer should add the last \r\n
+    out = response.str();
+    out.resize(out.size() - 2);
+}
 
-    std::string value;
+void Get::Execute(Storage &storage, const std::string &args, Response &out) {
+    StoredValue value;
+    std::string header;
     for (auto &key : _keys) {
-        if (!storage.Get(key, value))
+        if (!Fetch(storage, key, value)) {
             continue;
-        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
-        outStream << value << "\r\n";
-    }
-    outStream << "END"; // networking layer should add the last \r\n
+        }
 
-    out = outStream.str();
+        if (value.rendered) {
+            // Storage keeps header and trailing \r\n next to the value, send them all as a single span
+            value.size += value.offset + 2;
+            value.offset = 0;
+            out.Append(value);
+            continue;
+        }
+
+        header.assign("VALUE ", 6);
+        header.append(key);
+        header.push_back(' ');
+        header.append(std::to_string(value.flags));
+        header.push_back(' ');
+        header.append(std::to_string(value.size));
+        header.append("\r\n", 2);
+
+        out.Append(header);
+        out.Append(value);
+        out.Append("\r\n", 2);
+    }
+    out.Append("END\r\n", 5);
 }
 
 } // namespace Execute
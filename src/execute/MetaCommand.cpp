@@ -0,0 +1,107 @@
+#include <afina/execute/MetaCommand.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaCommand.h
+MetaCommand::MetaCommand(const std::string &key, const std::vector<std::string> &flags, const std::string &allowed)
+    : _key(key) {
+    _flags.reserve(flags.size());
+    for (auto &f : flags) {
+        if (f.empty()) {
+            continue;
+        }
+        if (allowed.find(f[0]) == std::string::npos) {
+            throw std::runtime_error("Invalid flag: " + f);
+        }
+        _flags.emplace_back(f[0], f.substr(1));
+    }
+}
+
+// See MetaCommand.h
+bool MetaCommand::has(char flag) const {
+    for (auto &f : _flags) {
+        if (f.first == flag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// See MetaCommand.h
+const std::string &MetaCommand::token(char flag) const {
+    static const std::string empty;
+    for (auto &f : _flags) {
+        if (f.first == flag) {
+            return f.second;
+        }
+    }
+    return empty;
+}
+
+// See MetaCommand.h
+void MetaCommand::Execute(Storage &storage, const std::string &args, std::string &out) {
+    Response response;
+    Execute(storage, args, response);
+
+    // networking layer should add the last \r\n
+    out = response.str();
+    if (out.size() >= 2) {
+        out.resize(out.size() - 2);
+    }
+}
+
+// See MetaCommand.h
+void MetaCommand::AppendFlags(std::string &out) const {
+    for (auto &f : _flags) {
+        if (f.first == 'k') {
+            out.append(" k");
+            out.append(_key);
+        } else if (f.first == 'O') {
+            out.append(" O");
+            out.append(f.second);
+        }
+    }
+}
+
+// See MetaCommand.h
+uint32_t MetaCommand::NumberFlag(char flag) const {
+    const std::string &value = token(flag);
+    if (value.empty()) {
+        throw std::runtime_error(std::string("Flag ") + flag + " requires numeric token");
+    }
+
+    uint32_t result = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') {
+            throw std::runtime_error(std::string("Flag ") + flag + " requires numeric token");
+        }
+        uint32_t d = c - '0';
+        if (result > (UINT32_MAX - d) / 10) {
+            throw std::runtime_error(std::string("Flag ") + flag + " overflow");
+        }
+        result = result * 10 + d;
+    }
+    return result;
+}
+
+// See MetaCommand.h
+int32_t MetaCommand::TtlFlag(char flag) const {
+    const std::string &value = token(flag);
+    if (!value.empty() && value[0] == '-') {
+        return -1;
+    }
+
+    // Same range as exptime of set command, anything bigger is refused rather than wrapped to a negative TTL
+    uint32_t result = NumberFlag(flag);
+    if (result > INT32_MAX) {
+        throw std::runtime_error(std::string("Flag ") + flag + " overflow");
+    }
+    return static_cast<int32_t>(result);
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,23 @@
+#include <afina/execute/MetaDelete.h>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaDelete.h
+void MetaDelete::Execute(Storage &storage, const std::string &args, Response &out) {
+    // Item is gone either way, quiet client doesn't care whether it was there
+    bool deleted = storage.Delete(_key);
+    if (has('q')) {
+        return;
+    }
+
+    std::string reply = deleted ? "HD" : "NF";
+    AppendFlags(reply);
+    reply += "\r\n";
+    out.Append(reply);
+}
+
+} // namespace Execute
+} // namespace Afina
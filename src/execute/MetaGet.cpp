@@ -0,0 +1,59 @@
+#include <afina/execute/MetaGet.h>
+
+#include <algorithm>
+#include <ctime>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaGet.h
+void MetaGet::Execute(Storage &storage, const std::string &args, Response &out) {
+    StoredValue value;
+    bool found = _touch ? storage.GetAndTouch(_key, ExpireAt(_ttl), value) : storage.Get(_key, value);
+    if (!found) {
+        if (!has('q')) {
+            out.Append("EN\r\n", 4);
+        }
+        return;
+    }
+
+    bool with_value = has('v');
+    std::string header = with_value ? "VA " + std::to_string(value.size) : "HD";
+    for (auto &f : _flags) {
+        switch (f.first) {
+        case 'f':
+            header += " f" + std::to_string(value.flags);
+            break;
+        case 's':
+            header += " s" + std::to_string(value.size);
+            break;
+        case 't': {
+            long ttl = -1;
+            if (value.expire != 0) {
+                ttl = std::max(0L, static_cast<long>(value.expire - time(nullptr)));
+            }
+            header += " t" + std::to_string(ttl);
+            break;
+        }
+        case 'k':
+            header += " k" + _key;
+            break;
+        case 'O':
+            header += " O" + f.second;
+            break;
+        }
+    }
+    header += "\r\n";
+    out.Append(header);
+
+    if (with_value) {
+        // offset points to the value itself even if header is pre-rendered
+        out.Append(value);
+        out.Append("\r\n", 2);
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
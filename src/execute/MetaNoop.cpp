@@ -0,0 +1,10 @@
+#include <afina/execute/MetaNoop.h>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaNoop.h
+void MetaNoop::Execute(Storage &storage, const std::string &args, std::string &out) { out = "MN"; }
+
+} // namespace Execute
+} // namespace Afina
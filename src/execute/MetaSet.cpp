@@ -0,0 +1,65 @@
+#include <afina/execute/MetaSet.h>
+
+#include <cctype>
+#include <stdexcept>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Execute {
+
+// See MetaSet.h
+MetaSet::MetaSet(const std::string &key, const std::vector<std::string> &flags)
+    : MetaCommand(key, flags, "FTMkOq"), _mode('S'), _client_flags(0), _ttl(0) {
+    if (has('M')) {
+        const std::string &mode = token('M');
+        if (mode.size() != 1 || std::string("SERAPserap").find(mode[0]) == std::string::npos) {
+            throw std::runtime_error("Invalid store mode: " + mode);
+        }
+        _mode = std::toupper(mode[0]);
+    }
+    if (has('F')) {
+        _client_flags = NumberFlag('F');
+    }
+    if (has('T')) {
+        _ttl = TtlFlag('T');
+    }
+}
+
+// See MetaSet.h
+void MetaSet::Execute(Storage &storage, const std::string &args, Response &out) {
+    bool stored = false;
+    switch (_mode) {
+    case 'S':
+        stored = storage.Put(_key, args, _client_flags, ExpireAt(_ttl));
+        break;
+    case 'E':
+        stored = storage.PutIfAbsent(_key, args, _client_flags, ExpireAt(_ttl));
+        break;
+    case 'R':
+        stored = storage.Set(_key, args, _client_flags, ExpireAt(_ttl));
+        break;
+    case 'A':
+    case 'P': {
+        StoredValue value;
+        if (storage.Get(_key, value)) {
+            std::string current(value.data(), value.size);
+            std::string result = (_mode == 'A') ? current + args : args + current;
+            stored = storage.Put(_key, result, value.flags, value.expire);
+        }
+        break;
+    }
+    }
+
+    if (stored && has('q')) {
+        return;
+    }
+
+    std::string reply = stored ? "HD" : "NS";
+    AppendFlags(reply);
+    reply += "\r\n";
+    out.Append(reply);
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,48 @@
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Response.h
+void Response::Append(const char *data, std::size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    // Glue small chunks together to keep number of iovecs low
+    if (_segments.empty() || !_segments.back().owned()) {
+        _segments.emplace_back(std::string());
+    }
+    _segments.back().buffer().append(data, size);
+}
+
+// See Response.h
+void Response::Append(const StoredValue &value) {
+    if (value.size < kMinPinnedSize) {
+        Append(value.data(), value.size);
+    } else {
+        _segments.emplace_back(value);
+    }
+}
+
+// See Response.h
+std::string Response::str() const {
+    std::string result;
+    result.reserve(size());
+    for (auto &s : _segments) {
+        result.append(s.data(), s.size());
+    }
+    return result;
+}
+
+// See Response.h
+std::size_t Response::size() const {
+    std::size_t result = 0;
+    for (auto &s : _segments) {
+        result += s.size();
+    }
+    return result;
+}
+
+} // namespace Execute
+} // namespace Afina
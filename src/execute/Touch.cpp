@@ -0,0 +1,13 @@
+#include <afina/Storage.h>
+#include <afina/execute/Touch.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Touch.h
+void Touch::Execute(Storage &storage, const std::string &args, std::string &out) {
+    out = storage.Touch(_key, ExpireAt(_expire)) ? "TOUCHED" : "NOT_FOUND";
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 
@@ -11,20 +13,47 @@
 
 #include <afina/Storage.h>
 #include <afina/Version.h>
+#include <afina/concurrency/Topology.h>
 #include <afina/logging/Service.h>
 #include <afina/network/Server.h>
 
 #include "logging/ServiceImpl.h"
 #include "network/mt_blocking/ServerImpl.h"
+#include "network/mt_coroutine/ServerImpl.h"
 #include "network/mt_nonblocking/ServerImpl.h"
+#include "network/mt_reuseport/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
+#include "network/st_coroutine/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
+#include "network/uring/ServerImpl.h"
 
 #include "storage/SimpleLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
 
 using namespace Afina;
 
+/**
+ * Size of thread pool given by option: number of threads or auto to take the suggested one
+ */
+static uint32_t PoolSize(const cxxopts::Options &options, const std::string &name, uint32_t deflt,
+                         std::size_t automatic) {
+    if (options.count(name) == 0) {
+        return deflt;
+    }
+
+    std::string value = options[name].as<std::string>();
+    if (value == "auto") {
+        return std::max<std::size_t>(automatic, 1);
+    }
+
+    char *end = nullptr;
+    unsigned long result = std::strtoul(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || result == 0 || result > 4096) {
+        throw std::runtime_error("Bad number of threads for " + name + ": " + value);
+    }
+    return result;
+}
+
 /**
  * Whole application class
  */
@@ -50,10 +79,16 @@ public:
             storage_type = options["storage"].as<std::string>();
         }
 
+        // Cache capacity in bytes
+        const size_t storage_size = 1024;
+
+        // Keep get reply headers rendered next to the values, so that read path doesn't format anything
+        bool render_headers = options.count("render-headers") > 0;
+
         if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
+            storage = std::make_shared<Afina::Backend::SimpleLRU>(storage_size, render_headers);
         } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(storage_size, render_headers);
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -67,14 +102,113 @@ public:
         if (network_type == "st_block") {
             server = std::make_shared<Afina::Network::STblocking::ServerImpl>(storage, logService);
         } else if (network_type == "mt_block") {
-            server = std::make_shared<Afina::Network::MTblocking::ServerImpl>(storage, logService);
+            std::size_t low = 4, high = 64, queue = 64, idle = 1000;
+            if (options.count("pool-low") > 0) {
+                low = options["pool-low"].as<std::size_t>();
+            }
+            if (options.count("pool-high") > 0) {
+                high = options["pool-high"].as<std::size_t>();
+            }
+            if (options.count("pool-queue") > 0) {
+                queue = options["pool-queue"].as<std::size_t>();
+            }
+            if (options.count("pool-idle") > 0) {
+                idle = options["pool-idle"].as<std::size_t>();
+            }
+            bool stealing = options.count("pool-stealing") > 0;
+            server = std::make_shared<Afina::Network::MTblocking::ServerImpl>(
+                storage, logService, low, high, queue, std::chrono::milliseconds(idle), stealing);
         } else if (network_type == "st_nonblock") {
             server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
         } else if (network_type == "mt_nonblock") {
-            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+            bool edge_triggered = options.count("edge-triggered") > 0;
+            std::size_t busy_poll = 0, socket_busy_poll = 0;
+            if (options.count("busy-poll") > 0) {
+                busy_poll = options["busy-poll"].as<std::size_t>();
+            }
+            if (options.count("socket-busy-poll") > 0) {
+                socket_busy_poll = options["socket-busy-poll"].as<std::size_t>();
+            }
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                storage, logService, edge_triggered, std::chrono::microseconds(busy_poll), int(socket_busy_poll));
+        } else if (network_type == "mt_reuseport") {
+            server = std::make_shared<Afina::Network::MTreuseport::ServerImpl>(storage, logService);
+        } else if (network_type == "uring") {
+            server = std::make_shared<Afina::Network::Uring::ServerImpl>(storage, logService);
+        } else if (network_type == "st_coroutine") {
+            server = std::make_shared<Afina::Network::STcoroutine::ServerImpl>(storage, logService);
+        } else if (network_type == "mt_coroutine") {
+            server = std::make_shared<Afina::Network::MTcoroutine::ServerImpl>(storage, logService);
         } else {
             throw std::runtime_error("Unknown network type");
         }
+
+        // Connection timeouts, servers are free to keep defaults if nothing is given
+        if ((options.count("idle-timeout") > 0 || options.count("read-timeout") > 0) &&
+            (network_type == "uring" || network_type == "st_coroutine" || network_type == "mt_coroutine")) {
+            throw std::runtime_error("Connection timeouts are not applied by " + network_type);
+        }
+        std::size_t idle_timeout = 0, read_timeout = 5000;
+        if (options.count("idle-timeout") > 0) {
+            idle_timeout = options["idle-timeout"].as<std::size_t>();
+        }
+        if (options.count("read-timeout") > 0) {
+            read_timeout = options["read-timeout"].as<std::size_t>();
+        }
+        server->SetTimeouts(std::chrono::milliseconds(idle_timeout), std::chrono::milliseconds(read_timeout));
+
+        // Buffering limits of nonblocking connections
+        Afina::Network::ConnectionLimits limits;
+        if (options.count("input-high") > 0) {
+            limits.input_high = options["input-high"].as<std::size_t>();
+        }
+        if (options.count("output-high") > 0) {
+            limits.output_high = options["output-high"].as<std::size_t>();
+        }
+        if (options.count("output-low") > 0) {
+            limits.output_low = options["output-low"].as<std::size_t>();
+        }
+        if (options.count("drain-timeout") > 0) {
+            limits.drain_timeout = std::chrono::milliseconds(options["drain-timeout"].as<std::size_t>());
+        }
+        if (options.count("drain-timeout") > 0 && network_type == "uring") {
+            throw std::runtime_error("Drain timeout is not applied by uring");
+        }
+        if (limits.output_high > 0 && limits.output_low >= limits.output_high) {
+            throw std::runtime_error("Output low mark must be below the high one");
+        }
+        server->SetLimits(limits);
+
+        // Step 3: threads and CPUs they run on. Automatic pools take a worker per CPU process may run on and an
+        // acceptor per NUMA node. Workers are spread over CPUs in the placement order, acceptors take the first
+        // CPU of each node so that they don't pile up on the CPUs of the first workers
+        Concurrency::Topology topology = Concurrency::Topology::Detect();
+        n_workers = PoolSize(options, "workers", 2, topology.Cpus().size());
+        n_acceptors = PoolSize(options, "acceptors", 2, topology.Nodes());
+
+        std::string affinity = options.count("pin-workers") > 0 ? "compact" : "none";
+        if (options.count("affinity") > 0) {
+            affinity = options["affinity"].as<std::string>();
+        }
+
+        Afina::Network::ThreadPlacement placement;
+        placement.workers = topology.Order(Concurrency::Topology::ParsePlacement(affinity));
+        if (!placement.workers.empty()) {
+            placement.acceptors = topology.Leaders();
+        }
+        placement.incoming_cpu = options.count("incoming-cpu") > 0;
+        if (placement.incoming_cpu && placement.workers.empty()) {
+            throw std::runtime_error("Incoming CPU matching needs workers pinned by --affinity");
+        }
+        server->SetPlacement(placement);
+
+        // Unix domain socket for clients on the same host, next to the TCP port
+        if (options.count("unix-socket") > 0) {
+            if (network_type == "uring" || network_type == "st_coroutine" || network_type == "mt_coroutine") {
+                throw std::runtime_error("Unix socket is not served by " + network_type);
+            }
+            server->SetUnixSocket(options["unix-socket"].as<std::string>());
+        }
     }
 
     // Start services in correct order
@@ -89,7 +223,7 @@ public:
         // TODO: configure network service
         const uint16_t port = 8080;
         log->warn("Start network on {}", port);
-        server->Start(port, 2, 2);
+        server->Start(port, n_acceptors, n_workers);
     }
 
     // Stop services in correct order
@@ -109,6 +243,10 @@ private:
 
     std::shared_ptr<Afina::Storage> storage;
     std::shared_ptr<Afina::Network::Server> server;
+
+    // Network thread pools sizes
+    uint32_t n_acceptors;
+    uint32_t n_workers;
 };
 
 // Signal set that to notify application about time to stop
@@ -129,6 +267,39 @@ int main(int argc, char **argv) {
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
+        options.add_options()("unix-socket", "Also listen on the unix domain socket at the given path",
+                              cxxopts::value<std::string>());
+        options.add_options()("render-headers", "Store get reply headers pre-rendered along with values");
+        options.add_options()("workers", "Network worker threads, auto for one per CPU", cxxopts::value<std::string>());
+        options.add_options()("acceptors", "Network acceptor threads, auto for one per NUMA node",
+                              cxxopts::value<std::string>());
+        options.add_options()("affinity", "Pin network threads to CPUs: none, compact or scatter",
+                              cxxopts::value<std::string>());
+        options.add_options()("pin-workers", "Same as --affinity compact");
+        options.add_options()("incoming-cpu", "Serve connection on the worker pinned to CPU it arrives on");
+        options.add_options()("edge-triggered", "Serve mt_nonblock connections by edge triggered epoll");
+        options.add_options()("busy-poll", "Microseconds mt_nonblock workers keep polling after the last event",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("socket-busy-poll", "Microseconds of SO_BUSY_POLL for mt_nonblock connections",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("pool-low", "Threads mt_block keeps ready", cxxopts::value<std::size_t>());
+        options.add_options()("pool-high", "Connections mt_block serves at once", cxxopts::value<std::size_t>());
+        options.add_options()("pool-queue", "Connections mt_block keeps waiting", cxxopts::value<std::size_t>());
+        options.add_options()("pool-idle", "Milliseconds spare mt_block thread lives idle",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("pool-stealing", "Serve mt_block connections on work stealing pool");
+        options.add_options()("idle-timeout", "Milliseconds connection may wait for the next command, 0 for ever",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("read-timeout", "Milliseconds connection may receive a single command, 0 for ever",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("input-high", "Largest command argument in bytes, 0 for any",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("output-high", "Pending output bytes to stop reading connection at, 0 for never",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("output-low", "Pending output bytes to resume reading connection at",
+                              cxxopts::value<std::size_t>());
+        options.add_options()("drain-timeout", "Milliseconds connection may stay over output high mark, 0 for ever",
+                              cxxopts::value<std::size_t>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
 
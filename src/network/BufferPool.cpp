@@ -0,0 +1,39 @@
+#include "BufferPool.h"
+
+namespace Afina {
+namespace Network {
+
+// See BufferPool.h
+BufferPool::BufferPool(std::size_t buffer_size, std::size_t max_cached)
+    : _buffer_size(buffer_size), _max_cached(max_cached), _in_use(0) {}
+
+// See BufferPool.h
+BufferPool::~BufferPool() {
+    for (auto buffer : _free) {
+        delete[] buffer;
+    }
+}
+
+// See BufferPool.h
+char *BufferPool::Acquire() {
+    _in_use++;
+    if (!_free.empty()) {
+        char *buffer = _free.back();
+        _free.pop_back();
+        return buffer;
+    }
+    return new char[_buffer_size];
+}
+
+// See BufferPool.h
+void BufferPool::Release(char *buffer) {
+    _in_use--;
+    if (_free.size() >= _max_cached) {
+        delete[] buffer;
+        return;
+    }
+    _free.push_back(buffer);
+}
+
+} // namespace Network
+} // namespace Afina
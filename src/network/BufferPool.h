@@ -0,0 +1,69 @@
+#ifndef AFINA_NETWORK_BUFFER_POOL_H
+#define AFINA_NETWORK_BUFFER_POOL_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Cache of read buffers
+ * Most connections are idle most of the time, and idle connection has nothing to keep in the read buffer.
+ * So instead of owning a buffer for its whole life, connection borrows one from the pool of the thread serving
+ * it only while there are bytes read but not parsed yet, and gives it back right after. Memory for reading
+ * is then proportional to the connections being active at once rather than to all of them.
+ *
+ * Released buffers are reused the most recent first, as it is likely to be hot in cache.
+ *
+ * Not threadsafe, meant to be owned by the thread serving connections
+ */
+class BufferPool {
+public:
+    /**
+     * @param buffer_size size of every buffer
+     * @param max_cached how many released buffers to keep for reuse, the rest are freed
+     */
+    BufferPool(std::size_t buffer_size, std::size_t max_cached = 1024);
+    ~BufferPool();
+
+    /**
+     * Returns buffer of BufferSize() bytes
+     */
+    char *Acquire();
+
+    /**
+     * Returns buffer got by Acquire back to the pool
+     */
+    void Release(char *buffer);
+
+    // Size of every buffer
+    inline std::size_t BufferSize() const { return _buffer_size; }
+
+    // Buffers given out and not released yet
+    inline std::size_t InUse() const { return _in_use; }
+
+    // Buffers ready to be reused
+    inline std::size_t Cached() const { return _free.size(); }
+
+    // Bytes allocated for buffers, both lent and cached
+    inline std::size_t Memory() const { return (_in_use + _free.size()) * _buffer_size; }
+
+private:
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    const std::size_t _buffer_size;
+
+    const std::size_t _max_cached;
+
+    std::size_t _in_use;
+
+    // Released buffers, the most recently used is on the back
+    std::vector<char *> _free;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_BUFFER_POOL_H
@@ -0,0 +1,220 @@
+#include "EpollConnection.h"
+
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+namespace Afina {
+namespace Network {
+
+// See EpollConnection.h
+EpollConnection::~EpollConnection() {
+    if (_read_buffer != nullptr) {
+        _buffers->Release(_read_buffer);
+    }
+}
+
+// See EpollConnection.h
+void EpollConnection::Start() {
+    _logger->debug("Start connection on descriptor {}", _socket);
+    _is_alive = true;
+    _eof = false;
+    _event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR;
+}
+
+// See EpollConnection.h
+void EpollConnection::Watch(TimerWheel &timers, std::chrono::milliseconds idle_timeout,
+                            std::chrono::milliseconds read_timeout) {
+    if (_throttled) {
+        // Client which doesn't take responses has limited time to drain them, counting from the moment it fell
+        // behind, no matter how it trickles on
+        if (!_draining || _drained) {
+            _draining = true;
+            _drained = false;
+            _reading = false;
+            if (_limits.drain_timeout.count() > 0) {
+                timers.Schedule(_timer, _limits.drain_timeout);
+            } else {
+                timers.Cancel(_timer);
+            }
+        }
+    } else if (!HasPartialCommand()) {
+        // Idle timeout counts from the last activity
+        _draining = false;
+        _drained = false;
+        _reading = false;
+        if (idle_timeout.count() > 0) {
+            timers.Schedule(_timer, idle_timeout);
+        } else {
+            timers.Cancel(_timer);
+        }
+    } else if (_draining || !_reading || _reading_executed != _pipeline.Executed()) {
+        // Read timeout counts from the first byte of the command, so that client trickling bytes one by one
+        // doesn't hold connection forever
+        _draining = false;
+        _drained = false;
+        _reading = true;
+        _reading_executed = _pipeline.Executed();
+        if (read_timeout.count() > 0) {
+            timers.Schedule(_timer, read_timeout);
+        } else {
+            timers.Cancel(_timer);
+        }
+    }
+}
+
+// See EpollConnection.h
+void EpollConnection::OnError() {
+    _logger->debug("Error on descriptor {}", _socket);
+    _is_alive = false;
+}
+
+// See EpollConnection.h
+void EpollConnection::OnClose() {
+    _logger->debug("Close connection on descriptor {}", _socket);
+    _is_alive = false;
+}
+
+// See EpollConnection.h
+void EpollConnection::DoRead() {
+    _read_pending = false;
+
+    // Client doesn't take responses, let the socket buffer fill up and hold it back
+    if (_throttled || _eof) {
+        return;
+    }
+
+    if (_read_buffer == nullptr) {
+        _read_buffer = _buffers->Acquire();
+    }
+
+    try {
+        int readed_bytes = -1;
+        std::size_t reads = 0;
+        while (!_throttled && !_eof && (readed_bytes = read(_socket, _read_buffer + _read_bytes,
+                                                            _buffers->BufferSize() - _read_bytes)) > 0) {
+            _logger->debug("Got {} bytes from socket", readed_bytes);
+            _read_bytes += readed_bytes;
+            Process();
+
+            // Let other connections of the thread run, socket might have more data
+            if (++reads == _read_budget) {
+                _read_pending = !_throttled && !_eof;
+                break;
+            }
+        }
+
+        if (_eof) {
+            _logger->debug("Stream is refused, stop reading");
+        } else if (_throttled) {
+            _logger->debug("Output is over {} bytes, stop reading", _limits.output_high);
+        } else if (_read_pending) {
+            _logger->debug("Read budget is over, {} bytes buffered", _read_bytes);
+        } else if (readed_bytes == 0) {
+            _logger->debug("Connection closed by peer");
+            _eof = true;
+        } else if (readed_bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            throw std::runtime_error(std::string(strerror(errno)));
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+        _eof = true;
+    }
+    ReleaseBuffer();
+
+    if (_eof) {
+        _event.events &= ~(EPOLLIN | EPOLLRDHUP);
+    }
+
+    // Responses for all commands found in the buffer are sent by a single writev, whatever socket
+    // doesn't accept right now waits for EPOLLOUT
+    DoWrite();
+}
+
+// See EpollConnection.h
+void EpollConnection::Process() {
+    try {
+        std::size_t offset = _pipeline.Process(_read_buffer, _read_bytes);
+
+        // Keep unparsed tail for the next read
+        if (offset > 0) {
+            std::memmove(_read_buffer, _read_buffer + offset, _read_bytes - offset);
+            _read_bytes -= offset;
+        }
+
+        // Client is that far behind, the rest waits till it catches up
+        if (_pipeline.Full()) {
+            _throttled = true;
+            _event.events &= ~(EPOLLIN | EPOLLRDHUP);
+        }
+    } catch (std::runtime_error &ex) {
+        // Nothing after the refused command can be trusted, just send what is queued already and close
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+        _read_bytes = 0;
+        _read_pending = false;
+        _throttled = false;
+        _eof = true;
+        _event.events &= ~(EPOLLIN | EPOLLRDHUP);
+    }
+}
+
+// See EpollConnection.h
+void EpollConnection::DoWrite() {
+    OutputQueue &output = _pipeline.Output();
+    for (;;) {
+        // Write till the socket refuses, edge triggered epoll reports it writable again only after EAGAIN
+        while (!output.Empty()) {
+            if (output.Write(_socket) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    _logger->error("Failed to send response on descriptor {}: {}", _socket, strerror(errno));
+                    OnError();
+                    return;
+                }
+                break;
+            }
+        }
+
+        // Client has caught up, go on with commands read already. Then socket must be read again, even if
+        // edge triggered epoll has nothing new to report
+        if (!_throttled || !_pipeline.Drained()) {
+            break;
+        }
+        _logger->debug("Output is down to {} bytes, resume reading", output.Size());
+        _throttled = false;
+        _drained = true;
+        if (!_eof) {
+            _event.events |= EPOLLIN | EPOLLRDHUP;
+        }
+        Process();
+        ReleaseBuffer();
+        _read_pending = !_eof && !_throttled;
+    }
+
+    if (output.Empty()) {
+        _event.events &= ~EPOLLOUT;
+        if (_eof) {
+            OnClose();
+        }
+    } else {
+        _event.events |= EPOLLOUT;
+    }
+}
+
+// See EpollConnection.h
+void EpollConnection::ReleaseBuffer() {
+    if (_read_bytes == 0 && _read_buffer != nullptr) {
+        _buffers->Release(_read_buffer);
+        _read_buffer = nullptr;
+    }
+}
+
+} // namespace Network
+} // namespace Afina
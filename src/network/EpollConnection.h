@@ -0,0 +1,141 @@
+#ifndef AFINA_NETWORK_EPOLL_CONNECTION_H
+#define AFINA_NETWORK_EPOLL_CONNECTION_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include <sys/epoll.h>
+
+#include <afina/network/Server.h>
+
+#include "network/BufferPool.h"
+#include "network/Pipeline.h"
+#include "network/TimerWheel.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+
+/**
+ * # Nonblocking connection served by epoll loop
+ * Reads the socket as long as it has data, runs commands through the pipeline and writes responses back,
+ * keeping epoll events in _event up to date for the loop to apply. Every nonblocking server serves a connection
+ * on a single thread, so the state needs no locking.
+ *
+ * Connection stops reading once output hits the high mark and goes on once it drains to the low one. Command
+ * that can't be taken, malformed one or one over the input limit, ends the stream: nothing after it runs,
+ * connection is closed as soon as responses for commands before it are sent
+ */
+class EpollConnection {
+public:
+    inline bool isAlive() const { return _is_alive; }
+
+    /**
+     * Output has hit the high mark, reading is stopped till it drains
+     */
+    inline bool isThrottled() const { return _throttled; }
+
+    /**
+     * Some command has been received partially
+     */
+    inline bool HasPartialCommand() const { return _read_bytes > 0 || _pipeline.HasPartialCommand(); }
+
+    void Start();
+
+    /**
+     * Schedule the timer closing connection by its state. Connection throttled by output high mark has the drain
+     * timeout counting from the moment it fell behind or drained last time, one receiving a command has the read
+     * timeout counting from the first byte of the command, the rest has the idle timeout counting from the last
+     * activity. Zero timeout is never
+     */
+    void Watch(TimerWheel &timers, std::chrono::milliseconds idle_timeout, std::chrono::milliseconds read_timeout);
+
+protected:
+    /**
+     * @param buffers pool to borrow read buffer from, must outlive connection
+     * @param read_budget reads from the socket at most in a single DoRead, 0 for no limit
+     */
+    EpollConnection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl,
+                    const ConnectionLimits &limits, BufferPool &buffers, std::size_t read_budget)
+        : _socket(s), _logger(pl), _limits(limits), _is_alive(false), _eof(false), _buffers(&buffers),
+          _read_buffer(nullptr), _read_bytes(0), _read_budget(read_budget), _read_pending(false),
+          _pipeline(ps, pl, limits, buffers.BufferSize()), _throttled(false), _drained(false), _reading(false),
+          _draining(false), _reading_executed(0) {
+        std::memset(&_event, 0, sizeof(struct epoll_event));
+    }
+    ~EpollConnection();
+
+    void OnError();
+    void OnClose();
+    void DoRead();
+    void DoWrite();
+
+    /**
+     * Execute commands found in the read buffer, as long as output stays below the high mark
+     */
+    void Process();
+
+    /**
+     * Give read buffer back to the pool once everything in it is processed
+     */
+    void ReleaseBuffer();
+
+    int _socket;
+    struct epoll_event _event;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Buffering limits
+    const ConnectionLimits _limits;
+
+    // Connection should be served further
+    bool _is_alive;
+
+    // Client has closed its side of the socket or stream can't be read further, no more commands will arrive
+    bool _eof;
+
+    // Bytes read from the socket but not processed yet. Buffer is borrowed from the pool only while there are
+    // such bytes, idle connection holds none
+    BufferPool *_buffers;
+    char *_read_buffer;
+    std::size_t _read_bytes;
+
+    // Reads from the socket at most in a single DoRead, 0 for no limit
+    const std::size_t _read_budget;
+
+    // The last DoRead has stopped on the budget rather than on EAGAIN, or reading has been resumed after
+    // output drained: socket might have data epoll won't report in edge triggered mode
+    bool _read_pending;
+
+    // Commands read so far and responses for them
+    Pipeline _pipeline;
+
+    // Output has exceeded the high mark and hasn't drained to the low one yet, and output has drained since
+    // the drain timer was set: client keeping up is throttled again and again, but it isn't stuck
+    bool _throttled;
+    bool _drained;
+
+    // Closes connection once it is idle, has been reading a command for too long or hasn't drained output in
+    // time. Reading flag is set along with the number of commands executed by the moment it was set, draining
+    // one is set while connection is throttled
+    TimerWheel::Timer _timer;
+    bool _reading;
+    bool _draining;
+    uint64_t _reading_executed;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_EPOLL_CONNECTION_H
@@ -0,0 +1,103 @@
+#include "OutputQueue.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace Afina {
+namespace Network {
+
+// Linux IOV_MAX, kernel refuses longer vectors
+static constexpr size_t kMaxIovecs = 1024;
+
+// See OutputQueue.h
+void OutputQueue::Push(std::string &&data) {
+    if (data.empty()) {
+        return;
+    }
+    _size += data.size();
+    _chunks.emplace_back(std::move(data));
+}
+
+// See OutputQueue.h
+void OutputQueue::Push(Execute::Response &&response) {
+    for (auto &segment : response.segments()) {
+        _size += segment.size();
+        _chunks.push_back(std::move(segment));
+    }
+    response.segments().clear();
+}
+
+// See OutputQueue.h
+ssize_t OutputQueue::Write(int fd) {
+    if (_chunks.empty()) {
+        return 0;
+    }
+
+    struct iovec iov[kMaxIovecs];
+    size_t iovcnt = Fill(iov, kMaxIovecs);
+
+    ssize_t written = writev(fd, iov, iovcnt);
+    if (written > 0) {
+        Consume(written);
+    }
+    return written;
+}
+
+// See OutputQueue.h
+size_t OutputQueue::Fill(struct iovec *iov, size_t iovcnt) const {
+    size_t result = 0;
+    for (auto it = _chunks.begin(); it != _chunks.end() && result < iovcnt; it++, result++) {
+        iov[result].iov_base = const_cast<char *>(it->data());
+        iov[result].iov_len = it->size();
+    }
+
+    if (result > 0) {
+        iov[0].iov_base = static_cast<char *>(iov[0].iov_base) + _head_offset;
+        iov[0].iov_len -= _head_offset;
+    }
+    return result;
+}
+
+// See OutputQueue.h
+void OutputQueue::Consume(size_t bytes) {
+    // Drop everything that was sent completely
+    _size -= bytes;
+    while (bytes > 0) {
+        size_t head_left = _chunks.front().size() - _head_offset;
+        if (bytes < head_left) {
+            _head_offset += bytes;
+            break;
+        }
+
+        bytes -= head_left;
+        _head_offset = 0;
+        _chunks.pop_front();
+    }
+}
+
+// See OutputQueue.h
+size_t OutputQueue::Flush(int fd) {
+    size_t calls = 0;
+    while (!_chunks.empty()) {
+        calls++;
+        if (Write(fd) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to send response: " + std::string(strerror(errno)));
+        }
+    }
+    return calls;
+}
+
+// See OutputQueue.h
+void OutputQueue::Clear() {
+    _chunks.clear();
+    _head_offset = 0;
+    _size = 0;
+}
+
+} // namespace Network
+} // namespace Afina
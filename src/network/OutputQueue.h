@@ -0,0 +1,95 @@
+#ifndef AFINA_NETWORK_OUTPUT_QUEUE_H
+#define AFINA_NETWORK_OUTPUT_QUEUE_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Responses pending to be sent into a connection
+ * Network layer collects results of all commands parsed out of a single read buffer here and then
+ * sends all of them at once with a single writev call instead of send call per command. Values
+ * referred by command replies are handed to writev as is, without copying.
+ *
+ * Not threadsafe
+ */
+class OutputQueue {
+public:
+    OutputQueue() : _head_offset(0), _size(0) {}
+
+    /**
+     * Enqueue new chunk of data to be sent after all already queued ones
+     */
+    void Push(std::string &&data);
+
+    /**
+     * Enqueue all segments of the command reply after already queued data
+     */
+    void Push(Execute::Response &&response);
+
+    /**
+     * Performs single writev call trying to send as much queued data as possible. Sent chunks get removed
+     * from the queue, partially sent chunk remains on the head.
+     *
+     * @param fd socket to write data to
+     * @return number of bytes written, -1 in case of error (errno is set by writev)
+     */
+    ssize_t Write(int fd);
+
+    /**
+     * Describes queued data as iovecs, starting from the oldest byte not sent yet. Chunks stay in the queue
+     * and keep their addresses until consumed, even if more data is pushed meanwhile, so the vector
+     * could be handed to asynchronous send
+     *
+     * @param iov array to fill
+     * @param iovcnt size of the array
+     * @return number of iovecs filled
+     */
+    size_t Fill(struct iovec *iov, size_t iovcnt) const;
+
+    /**
+     * Drops given number of bytes from the head of the queue once they are sent
+     */
+    void Consume(size_t bytes);
+
+    /**
+     * Blocks until all queued data is sent. Must be used with blocking sockets only
+     *
+     * @param fd socket to write data to
+     * @return number of writev calls issued, throws std::runtime_error in case of error
+     */
+    size_t Flush(int fd);
+
+    /**
+     * Drop all pending data
+     */
+    void Clear();
+
+    inline bool Empty() const { return _chunks.empty(); }
+
+    // Number of bytes not sent yet
+    inline size_t Size() const { return _size; }
+
+private:
+    // Chunks waiting to be sent, head is the oldest one
+    std::deque<Execute::Response::Segment> _chunks;
+
+    // How many bytes of the head chunk were already sent
+    size_t _head_offset;
+
+    // Total number of bytes not sent yet
+    size_t _size;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_OUTPUT_QUEUE_H
@@ -0,0 +1,99 @@
+#include "Pipeline.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Network {
+
+// See Pipeline.h
+Pipeline::Pipeline(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl,
+                   const ConnectionLimits &limits, std::size_t argument_reserve)
+    : _pStorage(ps), _logger(pl), _limits(limits), _argument_reserve(argument_reserve), _arg_remains(0),
+      _executed(0) {}
+
+// See Pipeline.h
+std::size_t Pipeline::Process(const char *data, std::size_t size) {
+    // Single block of data readed from the socket could trigger inside actions a multiple times,
+    // for example:
+    // - read#0: [<command1 start>]
+    // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+    std::size_t offset = 0;
+    try {
+        while (offset < size && !Full()) {
+            // There is no command yet
+            if (!_command_to_execute) {
+                std::size_t parsed = 0;
+                if (_parser.Parse(data + offset, size - offset, parsed)) {
+                    // Here we are, current chunk finished some command, process it
+                    _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
+                    _command_to_execute = _parser.Build(_arg_remains);
+                    if (_limits.input_high > 0 && _arg_remains > _limits.input_high) {
+                        throw std::runtime_error("Argument of " + std::to_string(_arg_remains) +
+                                                 " bytes exceeds the limit");
+                    }
+                    if (_arg_remains > 0) {
+                        _arg_remains += 2;
+                    }
+                }
+
+                // Parsed might fails to consume any bytes from input stream. In real life that could happens,
+                // for example, because we are working with UTF-16 chars and only 1 byte left in stream
+                if (parsed == 0) {
+                    break;
+                }
+                offset += parsed;
+            }
+
+            // There is command, but we still wait for argument to arrive...
+            if (_command_to_execute && _arg_remains > 0) {
+                _logger->debug("Fill argument: {} bytes of {}", size - offset, _arg_remains);
+                std::size_t to_read = std::min(_arg_remains, size - offset);
+                _argument_for_command.append(data + offset, to_read);
+
+                offset += to_read;
+                _arg_remains -= to_read;
+            }
+
+            // Thre is command & argument - RUN!
+            if (_command_to_execute && _arg_remains == 0) {
+                _logger->debug("Start command execution");
+
+                Execute::Response result;
+                if (_argument_for_command.size() >= 2) {
+                    _argument_for_command.resize(_argument_for_command.size() - 2);
+                }
+                _command_to_execute->Execute(*_pStorage, _argument_for_command, result);
+                _executed++;
+
+                // Queue response, it will be sent along with the rest of responses for this read
+                _output.Push(std::move(result));
+
+                // Prepare for the next command, big argument shouldn't pin its memory till connection closes
+                Reset();
+            }
+        }
+    } catch (std::runtime_error &) {
+        Reset();
+        throw;
+    }
+    return offset;
+}
+
+// See Pipeline.h
+void Pipeline::Reset() {
+    _command_to_execute.reset();
+    _arg_remains = 0;
+    _argument_for_command.resize(0);
+    if (_argument_for_command.capacity() > _argument_reserve) {
+        std::string().swap(_argument_for_command);
+    }
+    _parser.Reset();
+}
+
+} // namespace Network
+} // namespace Afina
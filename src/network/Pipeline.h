@@ -0,0 +1,109 @@
+#ifndef AFINA_NETWORK_PIPELINE_H
+#define AFINA_NETWORK_PIPELINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <afina/execute/Command.h>
+#include <afina/network/Server.h>
+
+#include "network/OutputQueue.h"
+#include "protocol/Parser.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+
+/**
+ * # Commands pipelined by a client
+ * Parses commands out of the byte stream of a nonblocking connection as it arrives, executes them in order and
+ * queues responses. Stream may be cut anywhere, the command started in one chunk is finished by the next ones.
+ * Servers only move bytes between socket and pipeline, and apply connection limits the same way:
+ * - commands are no longer taken once queued responses reach the output high mark, see Full
+ * - command with an argument over the input limit is refused before any of the argument is taken
+ */
+class Pipeline {
+public:
+    /**
+     * @param argument_reserve argument buffer capacity kept between commands, bigger one is freed
+     */
+    Pipeline(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl, const ConnectionLimits &limits,
+             std::size_t argument_reserve);
+
+    /**
+     * Execute commands found in the data as long as output stays below the high mark. Returns number of bytes
+     * taken, the rest has to be passed again once more data arrives or output drains.
+     *
+     * Throws std::runtime_error on malformed command or argument over the input limit. Pipeline is reset then:
+     * no part of the refused command runs, and the stream can't be trusted anymore, so connection is to be
+     * closed once responses queued before the error are sent
+     */
+    std::size_t Process(const char *data, std::size_t size);
+
+    /**
+     * Drop command being read, responses queued already are kept
+     */
+    void Reset();
+
+    /**
+     * Responses have reached the output high mark, no commands are taken till they drain
+     */
+    inline bool Full() const { return _limits.output_high > 0 && _output.Size() >= _limits.output_high; }
+
+    /**
+     * Responses are down to the output low mark, throttled connection goes on
+     */
+    inline bool Drained() const { return _output.Size() <= _limits.output_low; }
+
+    /**
+     * Some command has been received partially
+     */
+    inline bool HasPartialCommand() const { return _command_to_execute || _parser.Started(); }
+
+    // Responses waiting to be sent
+    inline OutputQueue &Output() { return _output; }
+
+    // Commands executed so far
+    inline uint64_t Executed() const { return _executed; }
+
+private:
+    // afina services
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Buffering limits
+    const ConnectionLimits _limits;
+    const std::size_t _argument_reserve;
+
+    // Here is connection state
+    // - parser: parse state of the stream
+    // - command_to_execute: last command parsed out of stream
+    // - arg_remains: how many bytes to read from stream to get command argument
+    // - argument_for_command: buffer stores argument
+    Protocol::Parser _parser;
+    std::size_t _arg_remains;
+    std::string _argument_for_command;
+    std::unique_ptr<Execute::Command> _command_to_execute;
+
+    // Responses waiting for the socket to become writable
+    OutputQueue _output;
+
+    // Commands executed so far
+    uint64_t _executed;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_PIPELINE_H
@@ -0,0 +1,114 @@
+#ifndef AFINA_NETWORK_SLAB_H
+#define AFINA_NETWORK_SLAB_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Slab allocator for objects of a single type
+ * Memory is taken from the heap in slabs of kSlabObjects slots. Destroyed object leaves its slot on the free
+ * list, and the next object created reuses the most recently freed slot, likely to be hot in cache. So
+ * under connection churn the thread owning the slab recycles the same few slabs instead of calling malloc
+ * and free per connection, and objects never cross threads on the way back to the allocator.
+ *
+ * Slabs are given back to the heap all at once when the whole slab is destroyed. Objects still alive at that
+ * moment must have been destroyed by the owner before.
+ *
+ * Not threadsafe, meant to be owned by the thread serving objects
+ */
+template <typename T> class Slab {
+public:
+    /**
+     * Objects in a single slab
+     */
+    static constexpr std::size_t kSlabObjects = 64;
+
+    Slab() : _free(nullptr), _in_use(0) {}
+
+    /**
+     * Construct object in a free slot, taking new slab if there is none. Slot is given back if constructor
+     * throws
+     */
+    template <typename... Args> T *Create(Args &&... args) {
+        if (_free == nullptr) {
+            Grow();
+        }
+
+        Slot *slot = _free;
+        _free = slot->next;
+        try {
+            T *object = new (&slot->storage) T(std::forward<Args>(args)...);
+            _in_use++;
+            return object;
+        } catch (...) {
+            slot->next = _free;
+            _free = slot;
+            throw;
+        }
+    }
+
+    /**
+     * Destroy object got by Create and put its slot on the free list
+     */
+    void Destroy(T *object) {
+        object->~T();
+
+        Slot *slot = reinterpret_cast<Slot *>(object);
+        slot->next = _free;
+        _free = slot;
+        _in_use--;
+    }
+
+    // Objects created and not destroyed yet
+    inline std::size_t InUse() const { return _in_use; }
+
+    // Slots in all slabs, free or not
+    inline std::size_t Capacity() const { return _slabs.size() * kSlabObjects; }
+
+    // Bytes taken by slabs
+    inline std::size_t Memory() const { return _slabs.size() * kSlabObjects * sizeof(Slot); }
+
+private:
+    Slab(const Slab &) = delete;
+    Slab &operator=(const Slab &) = delete;
+
+    // Free slot holds the link to the next one, busy one holds the object
+    union Slot {
+        Slot *next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    /**
+     * Take new slab and put all its slots on the free list, the lowest one on the head
+     */
+    void Grow() {
+        std::unique_ptr<Slot[]> slab(new Slot[kSlabObjects]);
+        for (std::size_t i = kSlabObjects; i > 0; i--) {
+            slab[i - 1].next = _free;
+            _free = &slab[i - 1];
+        }
+        _slabs.push_back(std::move(slab));
+    }
+
+    // All slabs taken so far
+    std::vector<std::unique_ptr<Slot[]>> _slabs;
+
+    // Head of the free slots list
+    Slot *_free;
+
+    std::size_t _in_use;
+};
+
+template <typename T> constexpr std::size_t Slab<T>::kSlabObjects;
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_SLAB_H
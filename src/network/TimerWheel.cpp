@@ -0,0 +1,176 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+namespace Afina {
+namespace Network {
+
+constexpr std::size_t TimerWheel::kSlotBits;
+constexpr std::size_t TimerWheel::kSlots;
+constexpr std::size_t TimerWheel::kLevels;
+
+// See TimerWheel.h
+TimerWheel::Timer::~Timer() {
+    if (Pending()) {
+        _wheel->Cancel(*this);
+    }
+}
+
+// See TimerWheel.h
+TimerWheel::TimerWheel(std::chrono::milliseconds resolution, Clock::time_point now)
+    : _resolution(std::max(resolution, std::chrono::milliseconds(1))), _start(now), _current(0), _size(0) {
+    std::fill(&_slots[0][0], &_slots[0][0] + kLevels * kSlots, nullptr);
+}
+
+// See TimerWheel.h
+TimerWheel::~TimerWheel() {
+    // Timers might outlive the wheel, make sure they don't refer to it
+    for (std::size_t level = 0; level < kLevels; level++) {
+        for (std::size_t slot = 0; slot < kSlots; slot++) {
+            while (_slots[level][slot] != nullptr) {
+                Unlink(*_slots[level][slot]);
+            }
+        }
+    }
+}
+
+// See TimerWheel.h
+void TimerWheel::Schedule(Timer &timer, std::chrono::milliseconds after, Clock::time_point now) {
+    if (timer.Pending()) {
+        Unlink(timer);
+    }
+
+    // Round up, so that timer never fires early, and don't let it land on the tick handled already. Wheel might
+    // be behind the clock if Advance hasn't been called for a while, the delay counts from now anyway
+    auto deadline = std::max(now, _start) + std::max(after, std::chrono::milliseconds(0)) - _start;
+    uint64_t expires = (deadline + _resolution - std::chrono::nanoseconds(1)) / _resolution;
+    expires = std::max<uint64_t>(expires, _current + 1);
+    expires = std::min<uint64_t>(expires, _current + (uint64_t(1) << (kSlotBits * kLevels)) - 1);
+
+    timer._expires = expires;
+    Link(timer);
+}
+
+// See TimerWheel.h
+void TimerWheel::Cancel(Timer &timer) {
+    if (timer.Pending()) {
+        Unlink(timer);
+    }
+}
+
+// See TimerWheel.h
+std::size_t TimerWheel::Advance(Clock::time_point now) {
+    uint64_t target = (now > _start) ? (now - _start) / _resolution : 0;
+    if (_size == 0) {
+        _current = std::max(_current, target);
+        return 0;
+    }
+
+    std::size_t fired = 0;
+    while (_current < target) {
+        _current++;
+
+        // Lower wheel has turned around, time to take the next slot of the upper one
+        for (std::size_t level = 1; level < kLevels; level++) {
+            if ((_current & ((uint64_t(1) << (kSlotBits * level)) - 1)) != 0) {
+                break;
+            }
+            Cascade(level);
+        }
+
+        // Timer is unlinked before callback, so that callback could do anything with it or with the others
+        Timer **slot = &_slots[0][_current & (kSlots - 1)];
+        while (*slot != nullptr) {
+            Timer *timer = *slot;
+            Unlink(*timer);
+            fired++;
+            if (timer->callback) {
+                timer->callback();
+            }
+        }
+
+        // Nothing else to wait for, jump right to the end
+        if (_size == 0) {
+            _current = target;
+        }
+    }
+    return fired;
+}
+
+// See TimerWheel.h
+int TimerWheel::Timeout(Clock::time_point now) const {
+    if (_size == 0) {
+        return -1;
+    }
+
+    // The nearest non empty slot of the lowest wheel, or its turnaround where upper wheel cascades down
+    uint64_t ticks = 1;
+    while (ticks < kSlots - (_current & (kSlots - 1)) && _slots[0][(_current + ticks) & (kSlots - 1)] == nullptr) {
+        ticks++;
+    }
+
+    auto deadline = _start + _resolution * static_cast<int64_t>(_current + ticks);
+    if (deadline <= now) {
+        return 0;
+    }
+
+    // Round up, waking up a bit early would only make Advance do nothing
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+    if (left < deadline - now) {
+        left += std::chrono::milliseconds(1);
+    }
+    return static_cast<int>(left.count());
+}
+
+// See TimerWheel.h
+void TimerWheel::Link(Timer &timer) {
+    uint64_t delta = timer._expires - _current;
+
+    // The lowest wheel which covers the delay, slot by the bits of expiration tick belonging to that wheel
+    std::size_t level = 0;
+    while (level + 1 < kLevels && delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+        level++;
+    }
+    Timer **head = &_slots[level][(timer._expires >> (kSlotBits * level)) & (kSlots - 1)];
+
+    timer._wheel = this;
+    timer._head = head;
+    timer._prev = nullptr;
+    timer._next = *head;
+    if (*head != nullptr) {
+        (*head)->_prev = &timer;
+    }
+    *head = &timer;
+    _size++;
+}
+
+// See TimerWheel.h
+void TimerWheel::Unlink(Timer &timer) {
+    if (timer._prev != nullptr) {
+        timer._prev->_next = timer._next;
+    } else {
+        *timer._head = timer._next;
+    }
+    if (timer._next != nullptr) {
+        timer._next->_prev = timer._prev;
+    }
+
+    timer._wheel = nullptr;
+    timer._head = nullptr;
+    timer._next = nullptr;
+    timer._prev = nullptr;
+    _size--;
+}
+
+// See TimerWheel.h
+void TimerWheel::Cascade(std::size_t level) {
+    Timer **slot = &_slots[level][(_current >> (kSlotBits * level)) & (kSlots - 1)];
+    while (*slot != nullptr) {
+        Timer *timer = *slot;
+        Unlink(*timer);
+        Link(*timer);
+    }
+}
+
+} // namespace Network
+} // namespace Afina
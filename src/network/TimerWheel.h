@@ -0,0 +1,127 @@
+#ifndef AFINA_NETWORK_TIMER_WHEEL_H
+#define AFINA_NETWORK_TIMER_WHEEL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Hierarchical timing wheel
+ * Time is split into ticks of the given resolution. Timers due within 64 ticks sit in the slot of the lowest
+ * wheel by their tick, later ones sit in the coarser wheels, each 64 times slower than the one below. Once
+ * the lower wheel turns around, the next slot of the upper one is spread over it. So both Schedule and Cancel
+ * are O(1) list operations, and Advance touches each timer at most once per wheel.
+ *
+ * Timers are intrusive: owner keeps Timer inside itself, wheel only links them together, so there are no
+ * allocations on the way. Timer fires at most a tick later than asked, never earlier.
+ *
+ * Not threadsafe, meant to be owned by the thread running epoll
+ */
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Slots in each wheel and number of wheels: 2^24 ticks ahead, longer timeouts are cut down to that
+    static constexpr std::size_t kSlotBits = 6;
+    static constexpr std::size_t kSlots = 1 << kSlotBits;
+    static constexpr std::size_t kLevels = 4;
+
+    class Timer {
+    public:
+        Timer() : _wheel(nullptr), _next(nullptr), _prev(nullptr), _head(nullptr), _expires(0) {}
+        explicit Timer(std::function<void()> callback) : Timer() { this->callback = std::move(callback); }
+
+        // Pending timer is cancelled
+        ~Timer();
+
+        /**
+         * Timer is scheduled and hasn't fired yet
+         */
+        inline bool Pending() const { return _head != nullptr; }
+
+        // Called once timer expires, timer is not pending anymore at that moment
+        std::function<void()> callback;
+
+    private:
+        friend class TimerWheel;
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+        // Wheel timer is pending in
+        TimerWheel *_wheel;
+
+        // Neighbours in the slot list and the slot itself
+        Timer *_next;
+        Timer *_prev;
+        Timer **_head;
+
+        // Tick to fire at
+        uint64_t _expires;
+    };
+
+    /**
+     * @param resolution length of a tick
+     * @param now time of tick 0
+     */
+    explicit TimerWheel(std::chrono::milliseconds resolution, Clock::time_point now = Clock::now());
+    ~TimerWheel();
+
+    /**
+     * Fire timer after the given time, rescheduling it if pending
+     */
+    void Schedule(Timer &timer, std::chrono::milliseconds after, Clock::time_point now = Clock::now());
+
+    /**
+     * Make sure timer won't fire, nothing happens if it isn't pending
+     */
+    void Cancel(Timer &timer);
+
+    /**
+     * Fire all timers due by now. Callbacks are free to schedule and cancel any timers, including the fired
+     * one. Returns the number of timers fired
+     */
+    std::size_t Advance(Clock::time_point now = Clock::now());
+
+    /**
+     * Milliseconds till Advance has something to do, -1 if no timers are pending: suitable as epoll_wait
+     * timeout. Might be shorter than the time till the earliest timer, but never longer
+     */
+    int Timeout(Clock::time_point now = Clock::now()) const;
+
+    // Number of pending timers
+    inline std::size_t Size() const { return _size; }
+
+private:
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    /**
+     * Put timer into the slot by its expiration tick and take it out of there
+     */
+    void Link(Timer &timer);
+    void Unlink(Timer &timer);
+
+    /**
+     * Spread the current slot of the given wheel over the lower ones
+     */
+    void Cascade(std::size_t level);
+
+    const std::chrono::milliseconds _resolution;
+    const Clock::time_point _start;
+
+    // Tick handled last
+    uint64_t _current;
+
+    std::size_t _size;
+    Timer *_slots[kLevels][kSlots];
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_TIMER_WHEEL_H
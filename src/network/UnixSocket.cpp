@@ -0,0 +1,72 @@
+#include "UnixSocket.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+
+// See UnixSocket.h
+int ListenUnixSocket(const std::string &path, int backlog) {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Bad unix socket path: " + path);
+    }
+    std::memcpy(addr.sun_path, path.data(), path.size());
+
+    int result = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (result == -1) {
+        throw std::runtime_error("Failed to open unix socket: " + std::string(strerror(errno)));
+    }
+
+    // Nobody answers on the stale socket, so it is safe to take the path over
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            close(result);
+            throw std::runtime_error("Path of unix socket is taken: " + path);
+        }
+
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool alive = probe != -1 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+        if (probe != -1) {
+            close(probe);
+        }
+        if (alive) {
+            close(result);
+            throw std::runtime_error("Unix socket is in use: " + path);
+        }
+        unlink(path.c_str());
+    }
+
+    if (bind(result, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(result);
+        throw std::runtime_error("Unix socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(result, backlog) == -1) {
+        close(result);
+        unlink(path.c_str());
+        throw std::runtime_error("Unix socket listen() failed: " + std::string(strerror(errno)));
+    }
+    return result;
+}
+
+// See UnixSocket.h
+void CloseUnixSocket(int socket, const std::string &path) {
+    if (socket != -1) {
+        close(socket);
+        unlink(path.c_str());
+    }
+}
+
+} // namespace Network
+} // namespace Afina
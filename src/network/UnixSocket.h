@@ -0,0 +1,28 @@
+#ifndef AFINA_NETWORK_UNIX_SOCKET_H
+#define AFINA_NETWORK_UNIX_SOCKET_H
+
+#include <string>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Unix domain socket listener
+ * Clients on the same host skip the whole TCP stack: no checksums, no segmentation, no ack clocking, data is
+ * put right into the receive queue of the peer. The listener is a nonblocking AF_UNIX stream socket, so that
+ * connections accepted on it are served by the same code as TCP ones.
+ *
+ * Socket left at the path by the previous run which wasn't stopped cleanly is replaced. The one some other
+ * process still listens on, or anything that isn't a socket, is refused with std::runtime_error
+ */
+int ListenUnixSocket(const std::string &path, int backlog);
+
+/**
+ * Close listener opened by ListenUnixSocket and remove its path, nothing happens for -1
+ */
+void CloseUnixSocket(int socket, const std::string &path);
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_UNIX_SOCKET_H
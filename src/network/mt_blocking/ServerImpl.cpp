@@ -9,6 +9,7 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <pthread.h>
 #include <signal.h>
 #include <sys/socket.h>
@@ -18,9 +19,13 @@
 #include <spdlog/logger.h>
 
 #include <afina/Storage.h>
+#include <afina/concurrency/Executor.h>
+#include <afina/concurrency/StealingExecutor.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 
+#include "network/OutputQueue.h"
+#include "network/UnixSocket.h"
 #include "protocol/Parser.h"
 
 namespace Afina {
@@ -28,8 +33,11 @@ namespace Network {
 namespace MTblocking {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
-    : Server(ps, pl), max_workers(5) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+                       std::size_t low_watermark, std::size_t high_watermark, std::size_t max_queue_size,
+                       std::chrono::milliseconds idle_time, bool work_stealing)
+    : Server(ps, pl), _unix_socket(-1), low_watermark(low_watermark), high_watermark(high_watermark),
+      max_queue_size(max_queue_size), idle_time(idle_time), work_stealing(work_stealing) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -68,11 +76,28 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
         throw std::runtime_error("Socket bind() failed");
     }
 
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, SOMAXCONN) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed");
     }
 
+    // Connections from both listeners are served the same way, accept loop waits for any of them
+    if (!unix_socket.empty()) {
+        try {
+            _unix_socket = ListenUnixSocket(unix_socket, SOMAXCONN);
+        } catch (std::runtime_error &) {
+            close(_server_socket);
+            throw;
+        }
+    }
+
+    if (work_stealing) {
+        executor.reset(new Afina::Concurrency::StealingExecutor("mt_blocking", high_watermark, max_queue_size));
+    } else {
+        executor.reset(
+            new Afina::Concurrency::Executor("mt_blocking", low_watermark, high_watermark, max_queue_size, idle_time));
+    }
+
     running.store(true);
     _thread = std::thread(&ServerImpl::OnRun, this);
 }
@@ -81,6 +106,9 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
 void ServerImpl::Stop() {
     running.store(false);
     shutdown(_server_socket, SHUT_RDWR);
+    if (_unix_socket != -1) {
+        shutdown(_unix_socket, SHUT_RDWR);
+    }
     {
         std::unique_lock<std::mutex> lock(mutex);
         for (auto workers_iter = workers.begin(); workers_iter != workers.end(); ++workers_iter) {
@@ -91,14 +119,21 @@ void ServerImpl::Stop() {
 
 // See Server.h
 void ServerImpl::Join() {
-    {
-        std::unique_lock<std::mutex> lock(mutex);
-        while (!workers.empty() && running.load()) {
-            workers_cv.wait(lock);
-        }
-    }
     assert(_thread.joinable());
     _thread.join();
+
+    // Connections still queued see server isn't running and close right away
+    executor->Stop(true);
+
+    // How long accepted connections have been waiting for a free thread
+    auto &latency = executor->QueueLatency();
+    _logger->info("Connections queued {}: p50 {}us, p99 {}us, max {}us", latency.Count(),
+                  latency.Percentile(0.5).count() / 1000, latency.Percentile(0.99).count() / 1000,
+                  latency.Max().count() / 1000);
+    executor.reset();
+    close(_server_socket);
+    CloseUnixSocket(_unix_socket, unix_socket);
+    _unix_socket = -1;
 }
 
 // See Server.h
@@ -116,11 +151,19 @@ void ServerImpl::OnRun() {
     while (running.load()) {
         _logger->debug("waiting for connection...");
 
-        // The call to accept() blocks until the incoming connection arrives
+        // The call to poll() blocks until the incoming connection arrives on any listener, negative descriptor of
+        // missing unix socket is skipped. Unix listener is nonblocking, so connection taken by the time accept() is
+        // called doesn't hold the loop
+        struct pollfd listeners[2] = {{_server_socket, POLLIN, 0}, {_unix_socket, POLLIN, 0}};
+        if (poll(listeners, 2, -1) <= 0) {
+            continue;
+        }
+        int listener = listeners[0].revents != 0 ? _server_socket : _unix_socket;
+
         int client_socket;
         struct sockaddr client_addr;
         socklen_t client_addr_len = sizeof(client_addr);
-        if ((client_socket = accept(_server_socket, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
+        if ((client_socket = accept(listener, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
             continue;
         }
 
@@ -137,19 +180,27 @@ void ServerImpl::OnRun() {
             _logger->debug("Accepted connection on descriptor {} (host={}, port={})\n", client_socket, host, port);
         }
 
-        // Configure read timeout
-        struct timeval tv;
-        tv.tv_sec = 5; // TODO: make it configurable
-        tv.tv_usec = 0;
-        setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
+        // Configure read timeout: blocking read can't tell waiting for the next command from waiting for
+        // the rest of the current one, so each read is bounded by the shorter of both timeouts
+        std::chrono::milliseconds timeout = read_timeout;
+        if (idle_timeout.count() > 0 && (timeout.count() == 0 || idle_timeout < timeout)) {
+            timeout = idle_timeout;
+        }
+        if (timeout.count() > 0) {
+            struct timeval tv;
+            tv.tv_sec = timeout.count() / 1000;
+            tv.tv_usec = (timeout.count() % 1000) * 1000;
+            setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
+        }
 
+        // Socket is registered before the handler could start, so that Stop reaches queued connections as well
         {
             std::unique_lock<std::mutex> lock(mutex);
-            if (workers.size() < max_workers) {
-                workers.insert(client_socket);
-                std::thread worker(&ServerImpl::ClientHandler, this, client_socket);
-                worker.detach();
-            } else {
+            workers.insert(client_socket);
+            if (!executor->Execute(&ServerImpl::ClientHandler, this, client_socket)) {
+                _logger->warn("Refuse connection on descriptor {}: {} connections queued already", client_socket,
+                              max_queue_size);
+                workers.erase(client_socket);
                 close(client_socket);
             }
         }
@@ -163,6 +214,7 @@ void ServerImpl::ClientHandler(int client_socket) {
     Protocol::Parser parser;
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
+    OutputQueue output;
 
     std::size_t arg_remains;
     size_t buf_size = 4096;
@@ -218,14 +270,14 @@ void ServerImpl::ClientHandler(int client_socket) {
                 if (command_to_execute && arg_remains == 0) {
                     _logger->debug("Start command execution");
 
-                    std::string result;
+                    Execute::Response result;
+                    if (argument_for_command.size() >= 2) {
+                        argument_for_command.resize(argument_for_command.size() - 2);
+                    }
                     command_to_execute->Execute(*pStorage, argument_for_command, result);
 
-                    // Send response
-                    result += "\r\n";
-                    if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                        throw std::runtime_error("Failed to send response");
-                    }
+                    // Queue response, it will be sent along with the rest of responses for this read
+                    output.Push(std::move(result));
 
                     // Prepare for the next command
                     command_to_execute.reset();
@@ -233,6 +285,12 @@ void ServerImpl::ClientHandler(int client_socket) {
                     parser.Reset();
                 }
             }
+
+            // Send responses for all commands found in this block by a single syscall
+            if (!output.Empty()) {
+                _logger->debug("Send {} bytes of responses", output.Size());
+                output.Flush(client_socket);
+            }
         }
 
         if ((read_bytes == 0) || (!running.load())) {
@@ -251,17 +309,11 @@ void ServerImpl::ClientHandler(int client_socket) {
     argument_for_command.resize(0);
     parser.Reset();
 
-    // We are done with this connection
-    close(client_socket);
-
-    // Deleting socket from set
+    // We are done with this connection. Descriptor is closed under lock, otherwise acceptor could get the same
+    // number for the new connection before this one is erased from the set
     std::unique_lock<std::mutex> lock(mutex); // to work with map
     workers.erase(client_socket);
-
-    // If server thread is waiting for us to stop
-    if (!running.load() && workers.empty()) {
-        workers_cv.notify_all();
-    }
+    close(client_socket);
 }
 
 } // namespace MTblocking
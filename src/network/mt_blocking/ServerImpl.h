@@ -2,11 +2,14 @@
 #define AFINA_NETWORK_MT_BLOCKING_SERVER_H
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_set>
 
+#include <afina/concurrency/TaskExecutor.h>
 #include <afina/network/Server.h>
 
 namespace spdlog {
@@ -19,11 +22,24 @@ namespace MTblocking {
 
 /**
  * # Network resource manager implementation
- * Server that is spawning a separate thread for each connection
+ * Server serving each connection by a blocking loop on a thread taken from the pool. Pool grows up to the
+ * high watermark, connections accepted beyond that wait in the pool queue and get refused only once the queue
+ * is full.
+ *
+ * Work stealing pool could be used instead, it starts all high watermark threads right away and never shrinks
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    /**
+     * @param low_watermark threads started right away
+     * @param high_watermark connections served at once at most
+     * @param max_queue_size connections waiting for a free thread at most
+     * @param idle_time how long spare thread waits for a connection before exit
+     * @param work_stealing serve connections on StealingExecutor rather than Executor
+     */
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+               std::size_t low_watermark = 4, std::size_t high_watermark = 64, std::size_t max_queue_size = 64,
+               std::chrono::milliseconds idle_time = std::chrono::milliseconds(1000), bool work_stealing = false);
     ~ServerImpl();
 
     // See Server.h
@@ -53,21 +69,28 @@ private:
     // Server socket to accept connections on
     int _server_socket;
 
+    // Unix domain socket listener, -1 if there is none
+    int _unix_socket;
+
     // Thread to run network on
     std::thread _thread;
 
-    // Max number of workers
-    size_t max_workers;
+    // Pool limits, see constructor
+    size_t low_watermark;
+    size_t high_watermark;
+    size_t max_queue_size;
+    std::chrono::milliseconds idle_time;
+    bool work_stealing;
 
-    // Sock_ids
+    // Threads serving connections
+    std::unique_ptr<Afina::Concurrency::TaskExecutor> executor;
+
+    // Sockets of connections being served or waiting in the pool queue
     std::unordered_set<int> workers;
 
-    // Locking to wait for client workers
+    // Locking to access sockets set
     std::mutex mutex;
 
-    // Wait for client workers
-    std::condition_variable workers_cv;
-
     void ClientHandler(int client_socket);
 };
 
@@ -0,0 +1,311 @@
+#include "ServerImpl.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/execute/Command.h>
+#include <afina/logging/Service.h>
+
+#include "network/OutputQueue.h"
+#include "protocol/Parser.h"
+
+namespace Afina {
+namespace Network {
+namespace MTcoroutine {
+
+// See ServerImpl.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _server_socket(-1), _running(false) {}
+
+// See ServerImpl.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start mt_coroutine network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _running.store(true);
+    _scheduler.reset(new Afina::Coroutine::Scheduler(n_workers));
+    _scheduler->run(&ServerImpl::Accept, this);
+    _scheduler->start();
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+
+    // Shutdown sockets so that every coroutine gets EOF or error and completes, accept loop included
+    {
+        std::lock_guard<std::mutex> lock(_connections_lock);
+        _running.store(false);
+        shutdown(_server_socket, SHUT_RDWR);
+        for (auto pc : _connections) {
+            shutdown(pc->socket, SHUT_RDWR);
+        }
+    }
+    _scheduler->stop();
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    _scheduler->join();
+    _logger->info("Coroutine scheduler: {} steals, stacks high water {} bytes", _scheduler->steals(),
+                  _scheduler->stack_high_water());
+    _scheduler.reset();
+
+    close(_server_socket);
+    _logger->warn("Network stopped");
+}
+
+// See ServerImpl.h
+void ServerImpl::Accept(ServerImpl *self) { self->OnAccept(); }
+
+// See ServerImpl.h
+void ServerImpl::OnAccept() {
+    while (_running.load()) {
+        struct sockaddr in_addr;
+        socklen_t in_len;
+
+        // No need to make these sockets non blocking since accept4() takes care of it.
+        in_len = sizeof in_addr;
+        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                _scheduler->wait(_server_socket, EPOLLIN);
+            } else if (errno != EINTR && errno != ECONNABORTED) {
+                if (_running.load()) {
+                    _logger->error("Failed to accept socket: {}", strerror(errno));
+                }
+                break;
+            }
+            continue;
+        }
+
+        // Print host and service info.
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        int retval =
+            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+        if (retval == 0) {
+            _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        }
+
+        Connection *pc = new (std::nothrow) Connection;
+        if (pc == nullptr) {
+            throw std::runtime_error("Failed to allocate connection");
+        }
+        pc->socket = infd;
+        pc->read_bytes = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(_connections_lock);
+            if (!_running.load()) {
+                close(infd);
+                delete pc;
+                break;
+            }
+            _connections.insert(pc);
+        }
+
+        // New coroutine lands on this processor, idle ones steal it if this one is busy
+        _scheduler->run(&ServerImpl::Serve, this, *pc);
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::Serve(ServerImpl *self, Connection &conn) { self->OnConnection(conn); }
+
+// See ServerImpl.h
+void ServerImpl::OnConnection(Connection &conn) {
+    _logger->debug("Start connection on descriptor {}", conn.socket);
+
+    // Here is connection state
+    // - parser: parse state of the stream
+    // - command_to_execute: last command parsed out of stream
+    // - arg_remains: how many bytes to read from stream to get command argument
+    // - argument_for_command: buffer stores argument
+    // - output: responses waiting to be sent
+    std::size_t arg_remains = 0;
+    Protocol::Parser parser;
+    std::string argument_for_command;
+    std::unique_ptr<Execute::Command> command_to_execute;
+    OutputQueue output;
+
+    // Process connection:
+    // - read commands until socket alive
+    // - execute each command
+    // - send response
+    // Any call that would block passes control to other coroutines instead
+    try {
+        ssize_t readed_bytes = -1;
+        char *client_buffer = conn.read_buffer;
+        while ((readed_bytes = Read(conn, client_buffer + conn.read_bytes,
+                                    sizeof(conn.read_buffer) - conn.read_bytes)) > 0) {
+            _logger->debug("Got {} bytes from socket", readed_bytes);
+            conn.read_bytes += readed_bytes;
+
+            // Single block of data readed from the socket could trigger inside actions a multiple times,
+            // for example:
+            // - read#0: [<command1 start>]
+            // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+            std::size_t offset = 0;
+            while (offset < conn.read_bytes) {
+                // There is no command yet
+                if (!command_to_execute) {
+                    std::size_t parsed = 0;
+                    if (parser.Parse(client_buffer + offset, conn.read_bytes - offset, parsed)) {
+                        // There is no command to be launched, continue to parse input stream
+                        // Here we are, current chunk finished some command, process it
+                        _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
+                        command_to_execute = parser.Build(arg_remains);
+                        if (arg_remains > 0) {
+                            arg_remains += 2;
+                        }
+                    }
+
+                    // Parsed might fails to consume any bytes from input stream. In real life that could happens,
+                    // for example, because we are working with UTF-16 chars and only 1 byte left in stream
+                    if (parsed == 0) {
+                        break;
+                    }
+                    offset += parsed;
+                }
+
+                // There is command, but we still wait for argument to arrive...
+                if (command_to_execute && arg_remains > 0) {
+                    _logger->debug("Fill argument: {} bytes of {}", conn.read_bytes - offset, arg_remains);
+                    std::size_t to_read = std::min(arg_remains, conn.read_bytes - offset);
+                    argument_for_command.append(client_buffer + offset, to_read);
+
+                    offset += to_read;
+                    arg_remains -= to_read;
+                }
+
+                // Thre is command & argument - RUN!
+                if (command_to_execute && arg_remains == 0) {
+                    _logger->debug("Start command execution");
+
+                    Execute::Response result;
+                    if (argument_for_command.size() >= 2) {
+                        argument_for_command.resize(argument_for_command.size() - 2);
+                    }
+                    command_to_execute->Execute(*pStorage, argument_for_command, result);
+
+                    // Queue response, it will be sent along with the rest of responses for this read
+                    output.Push(std::move(result));
+
+                    // Prepare for the next command
+                    command_to_execute.reset();
+                    argument_for_command.resize(0);
+                    parser.Reset();
+                }
+            }
+
+            // Keep unparsed tail for the next read
+            if (offset > 0) {
+                std::memmove(client_buffer, client_buffer + offset, conn.read_bytes - offset);
+                conn.read_bytes -= offset;
+            }
+
+            // Send responses for all commands found in this block
+            if (!output.Empty()) {
+                _logger->debug("Send {} bytes of responses", output.Size());
+                Send(conn, output);
+            }
+        }
+
+        if (readed_bytes == 0) {
+            _logger->debug("Connection closed");
+        } else {
+            throw std::runtime_error(std::string(strerror(errno)));
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", conn.socket, ex.what());
+    }
+
+    // We are done with this connection, closed socket leaves epoll by itself
+    {
+        std::lock_guard<std::mutex> lock(_connections_lock);
+        _connections.erase(&conn);
+        close(conn.socket);
+    }
+    delete &conn;
+}
+
+// See ServerImpl.h
+ssize_t ServerImpl::Read(Connection &conn, char *buffer, std::size_t size) {
+    for (;;) {
+        ssize_t result = read(conn.socket, buffer, size);
+        if (result >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return result;
+        }
+        if (errno != EINTR) {
+            _scheduler->wait(conn.socket, EPOLLIN | EPOLLRDHUP);
+        }
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::Send(Connection &conn, OutputQueue &output) {
+    while (!output.Empty()) {
+        if (output.Write(conn.socket) < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                _scheduler->wait(conn.socket, EPOLLOUT);
+            } else if (errno != EINTR) {
+                throw std::runtime_error("Failed to send response: " + std::string(strerror(errno)));
+            }
+        }
+    }
+}
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,97 @@
+#ifndef AFINA_NETWORK_MT_COROUTINE_SERVER_H
+#define AFINA_NETWORK_MT_COROUTINE_SERVER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include <sys/types.h>
+
+#include <afina/coroutine/Scheduler.h>
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+
+// Forward declaration, see network/OutputQueue.h
+class OutputQueue;
+
+namespace MTcoroutine {
+
+/**
+ * # Network resource manager implementation
+ * Multithreaded flavour of st_coroutine: each connection is a coroutine with plain blocking style loop, but
+ * coroutines run on M:N scheduler with processor per worker. Connection isn't bound to the thread which has
+ * accepted it, idle processors steal ready coroutines from busy ones, so a few hot clients get spread over
+ * all cores instead of overloading one of them
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    // See Server.h, acceptors are ignored as single coroutine accepts connections
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+protected:
+    // Per connection state, owned by its coroutine
+    struct Connection {
+        int socket;
+
+        // Bytes read from the socket but not processed yet
+        char read_buffer[4096];
+        std::size_t read_bytes;
+    };
+
+    /**
+     * Body of accepting coroutine, returns once server is stopped
+     */
+    static void Accept(ServerImpl *self);
+    void OnAccept();
+
+    /**
+     * Body of connection coroutine, returns once connection is closed
+     */
+    static void Serve(ServerImpl *self, Connection &conn);
+    void OnConnection(Connection &conn);
+
+    /**
+     * Blocking style IO: suspend current coroutine until socket is ready instead of blocking the thread
+     */
+    ssize_t Read(Connection &conn, char *buffer, std::size_t size);
+    void Send(Connection &conn, OutputQueue &output);
+
+private:
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Socket to accept new connection on
+    int _server_socket;
+
+    // Processors running all coroutines
+    std::unique_ptr<Afina::Coroutine::Scheduler> _scheduler;
+
+    // Server accepts new connections
+    std::atomic<bool> _running;
+
+    // Connections served at the moment, so that Stop could wake up all of them
+    std::mutex _connections_lock;
+    std::set<Connection *> _connections;
+};
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_COROUTINE_SERVER_H
@@ -1,37 +1,64 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
-#include <cstring>
+#include <cstdint>
+#include <memory>
 
-#include <sys/epoll.h>
+#include <afina/network/Server.h>
+
+#include "network/BufferPool.h"
+#include "network/EpollConnection.h"
+#include "network/TimerWheel.h"
+
+namespace spdlog {
+class logger;
+}
 
 namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
 namespace Network {
 namespace MTnonblock {
 
-class Connection {
+/**
+ * # Client connection served by worker
+ * Acceptor hands accepted socket over to one of workers, which creates connection for it and serves it on own
+ * thread till the end, so the connection state needs no locking
+ */
+class Connection : public EpollConnection {
 public:
-    Connection(int s) : _socket(s) {
-        std::memset(&_event, 0, sizeof(struct epoll_event));
-        _event.data.ptr = this;
-    }
-
-    inline bool isAlive() const { return true; }
+    /**
+     * Size of read buffers connections borrow, big enough for deeply pipelined clients to be served with
+     * fewer syscalls
+     */
+    static constexpr std::size_t kReadBuffer = 16 * 1024;
 
-    void Start();
+    /**
+     * Reads from the socket at most in a single DoRead, so that a client flooding the server doesn't keep
+     * the rest of worker connections waiting
+     */
+    static constexpr std::size_t kReadBudget = 16;
 
-protected:
-    void OnError();
-    void OnClose();
-    void DoRead();
-    void DoWrite();
+    /**
+     * @param buffers pool to borrow read buffer from, must outlive connection
+     */
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl,
+               const ConnectionLimits &limits, BufferPool &buffers)
+        : EpollConnection(s, ps, pl, limits, buffers, kReadBudget), _armed_events(0), _resume(false) {
+        _event.data.ptr = this;
+    }
 
 private:
     friend class Worker;
     friend class ServerImpl;
 
-    int _socket;
-    struct epoll_event _event;
+    // Events epoll is watching for at the moment, 0 if connection isn't registered
+    uint32_t _armed_events;
+
+    // Connection is in the worker list of ones to read again without waiting for epoll
+    bool _resume;
 };
 
 } // namespace MTnonblock
@@ -1,5 +1,6 @@
 #include "ServerImpl.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -19,18 +20,23 @@
 #include <spdlog/logger.h>
 
 #include <afina/Storage.h>
+#include <afina/concurrency/Topology.h>
 #include <afina/logging/Service.h>
 
-#include "Connection.h"
 #include "Utils.h"
 #include "Worker.h"
+#include "network/UnixSocket.h"
 
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, bool edge_triggered,
+                       std::chrono::microseconds busy_poll, int socket_busy_poll)
+    : Server(ps, pl), _unix_socket(-1), _edge_triggered(edge_triggered), _busy_poll(busy_poll),
+      _socket_busy_poll(socket_busy_poll), _next_worker(0),
+      _dropped(0) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -65,6 +71,13 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
     }
 
+    // Accepted sockets inherit busy poll from the listener. Raising it over net.core.busy_read takes
+    // CAP_NET_ADMIN, server runs without it then
+    if (_socket_busy_poll > 0 &&
+        setsockopt(_server_socket, SOL_SOCKET, SO_BUSY_POLL, &_socket_busy_poll, sizeof(_socket_busy_poll))) {
+        _logger->warn("Failed to set socket busy poll: {}", strerror(errno));
+    }
+
     if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
@@ -76,34 +89,48 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
 
-    // Start IO workers
-    _data_epoll_fd = epoll_create1(0);
-    if (_data_epoll_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    if (!unix_socket.empty()) {
+        try {
+            _unix_socket = ListenUnixSocket(unix_socket, SOMAXCONN);
+        } catch (std::runtime_error &) {
+            close(_server_socket);
+            throw;
+        }
     }
 
     _event_fd = eventfd(0, EFD_NONBLOCK);
     if (_event_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
-
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.ptr = nullptr;
-    if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
-        throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        close(_server_socket);
+        CloseUnixSocket(_unix_socket, unix_socket);
+        _unix_socket = -1;
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
     }
 
+    // Start IO workers, each one has private epoll
+    const std::vector<int> &worker_cpus = placement.workers;
     _workers.reserve(n_workers);
     for (int i = 0; i < n_workers; i++) {
-        _workers.emplace_back(pStorage, pLogging);
-        _workers.back().Start(_data_epoll_fd);
+        int cpu = worker_cpus.empty() ? -1 : worker_cpus[i % worker_cpus.size()];
+        _workers.emplace_back(
+            new Worker(pStorage, pLogging, _edge_triggered, idle_timeout, read_timeout, limits, _busy_poll));
+        _workers.back()->Start(cpu);
+        if (placement.incoming_cpu && cpu >= 0) {
+            _cpu_workers[cpu].push_back(_workers.back().get());
+        }
     }
 
     // Start acceptors
+    const std::vector<int> &acceptor_cpus = placement.acceptors;
     _acceptors.reserve(n_acceptors);
     for (int i = 0; i < n_acceptors; i++) {
         _acceptors.emplace_back(&ServerImpl::OnRun, this);
+        if (!acceptor_cpus.empty()) {
+            int cpu = acceptor_cpus[i % acceptor_cpus.size()];
+            int err = Concurrency::Topology::Pin(_acceptors.back(), cpu);
+            if (err != 0) {
+                _logger->warn("Failed to pin acceptor to cpu {}: {}", cpu, strerror(err));
+            }
+        }
     }
 }
 
@@ -112,12 +139,12 @@ void ServerImpl::Stop() {
     _logger->warn("Stop network service");
     // Said workers to stop
     for (auto &w : _workers) {
-        w.Stop();
+        w->Stop();
     }
 
-    // Wakeup threads that are sleep on epoll_wait
+    // Wakeup acceptors that are sleep on epoll_wait
     if (eventfd_write(_event_fd, 1)) {
-        throw std::runtime_error("Failed to wakeup workers");
+        throw std::runtime_error("Failed to wakeup acceptors");
     }
 }
 
@@ -127,9 +154,91 @@ void ServerImpl::Join() {
         t.join();
     }
 
+    if (Dropped() > 0) {
+        _logger->warn("Dropped {} connections, inbox of every worker was full", Dropped());
+    }
+
+    // Workers close connections left
     for (auto &w : _workers) {
-        w.Join();
+        w->Join();
     }
+    _workers.clear();
+    _cpu_workers.clear();
+
+    close(_event_fd);
+    close(_server_socket);
+    CloseUnixSocket(_unix_socket, unix_socket);
+    _unix_socket = -1;
+}
+
+// See ServerImpl.h
+Worker &ServerImpl::PickWorker() {
+    std::size_t n = _workers.size();
+    std::size_t start = _next_worker.fetch_add(1, std::memory_order_relaxed) % n;
+
+    Worker *best = _workers[start].get();
+    uint64_t best_load = best->Load();
+    for (std::size_t i = 1; i < n && best_load > 0; i++) {
+        Worker *w = _workers[(start + i) % n].get();
+        uint64_t load = w->Load();
+        if (load < best_load) {
+            best = w;
+            best_load = load;
+        }
+    }
+    return *best;
+}
+
+// See ServerImpl.h
+Worker &ServerImpl::MatchWorker(int socket) {
+    int cpu = -1;
+    socklen_t len = sizeof(cpu);
+    if (_cpu_workers.empty() || getsockopt(socket, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) || cpu < 0) {
+        return PickWorker();
+    }
+
+    auto it = _cpu_workers.find(cpu);
+    if (it == _cpu_workers.end()) {
+        return PickWorker();
+    }
+
+    // Several workers might share the CPU if there are more workers than CPUs
+    Worker *best = it->second.front();
+    for (Worker *w : it->second) {
+        if (w->Load() < best->Load()) {
+            best = w;
+        }
+    }
+    return *best;
+}
+
+// See ServerImpl.h
+bool ServerImpl::Assign(int socket) {
+    Worker &matched = MatchWorker(socket);
+    _logger->debug("Assign descriptor {} to worker with {} connections, {} events/s", socket, matched.Connections(),
+                   matched.EventRate());
+    if (matched.Assign(socket)) {
+        return true;
+    }
+
+    // Worker is that far behind, better let another one serve the connection than refuse it
+    std::vector<Worker *> rest;
+    rest.reserve(_workers.size());
+    for (auto &w : _workers) {
+        if (w.get() != &matched) {
+            rest.push_back(w.get());
+        }
+    }
+    std::sort(rest.begin(), rest.end(), [](const Worker *a, const Worker *b) { return a->Load() < b->Load(); });
+    for (Worker *w : rest) {
+        _logger->debug("Worker inbox is full, assign descriptor {} to worker with {} connections", socket,
+                       w->Connections());
+        if (w->Assign(socket)) {
+            return true;
+        }
+    }
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
 }
 
 // See ServerImpl.h
@@ -154,6 +263,15 @@ void ServerImpl::OnRun() {
         throw std::runtime_error("Failed to add file descriptor to epoll");
     }
 
+    if (_unix_socket != -1) {
+        struct epoll_event event3;
+        event3.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event3.data.fd = _unix_socket;
+        if (epoll_ctl(acceptor_epoll, EPOLL_CTL_ADD, _unix_socket, &event3)) {
+            throw std::runtime_error("Failed to add file descriptor to epoll");
+        }
+    }
+
     bool run = true;
     std::array<struct epoll_event, 64> mod_list;
     while (run) {
@@ -174,7 +292,7 @@ void ServerImpl::OnRun() {
 
                 // No need to make these sockets non blocking since accept4() takes care of it.
                 in_len = sizeof in_addr;
-                int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                int infd = accept4(current_event.data.fd, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
                 if (infd == -1) {
                     if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
                         break; // We have processed all incoming connections.
@@ -192,26 +310,15 @@ void ServerImpl::OnRun() {
                     _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
                 }
 
-                // Register the new FD to be monitored by epoll.
-                Connection *pc = new Connection(infd);
-                if (pc == nullptr) {
-                    throw std::runtime_error("Failed to allocate connection");
-                }
-
-                // Register connection in worker's epoll
-                pc->Start();
-                if (pc->isAlive()) {
-                    pc->_event.events |= EPOLLONESHOT;
-                    int epoll_ctl_retval;
-                    if ((epoll_ctl_retval = epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event))) {
-                        _logger->debug("epoll_ctl failed during connection register in workers'epoll: error {}", epoll_ctl_retval);
-                        pc->OnError();
-                        delete pc;
-                    }
+                // Worker creates connection for the new FD, registers it in its epoll and owns it from now on
+                if (!Assign(infd)) {
+                    _logger->warn("Every worker inbox is full, drop connection on descriptor {}", infd);
+                    close(infd);
                 }
             }
         }
     }
+    close(acceptor_epoll);
     _logger->warn("Acceptor stopped");
 }
 
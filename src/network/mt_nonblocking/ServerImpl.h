@@ -1,7 +1,12 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <afina/network/Server.h>
@@ -19,11 +24,18 @@ class Worker;
 
 /**
  * # Network resource manager implementation
- * Epoll based server
+ * Epoll based server. Acceptors hand every new connection over to the least loaded worker, which serves it on
+ * the private epoll till the end
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    /**
+     * @param edge_triggered serve connections by edge triggered epoll, see Worker.h
+     * @param busy_poll time workers keep polling after the last event, 0 to block right away, see Worker.h
+     * @param socket_busy_poll SO_BUSY_POLL microseconds for connection sockets, 0 to leave system default
+     */
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, bool edge_triggered = false,
+               std::chrono::microseconds busy_poll = std::chrono::microseconds(0), int socket_busy_poll = 0);
     ~ServerImpl();
 
     // See Server.h
@@ -35,10 +47,31 @@ public:
     // See Server.h
     void Join() override;
 
+    // Connections dropped since inbox of every worker was full
+    inline uint64_t Dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
 protected:
     void OnRun();
     void OnNewConnection();
 
+    /**
+     * Worker with the least load, see Worker::Load. Ties are broken round robin, so that burst of connections
+     * accepted at once doesn't go to the same worker
+     */
+    Worker &PickWorker();
+
+    /**
+     * Worker pinned to the CPU which has handled packets of the socket, or the one picked by load if there is
+     * no such worker. See ThreadPlacement
+     */
+    Worker &MatchWorker(int socket);
+
+    /**
+     * Hand accepted socket over to the matched worker. If its inbox is full, the rest of workers are tried
+     * the least loaded first. Returns false if every inbox is full, then socket stays with the caller
+     */
+    bool Assign(int socket);
+
 private:
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
@@ -51,18 +84,34 @@ private:
     // Socket to accept new connection on, shared between acceptors
     int _server_socket;
 
+    // Unix domain socket listener shared between acceptors the same way, -1 if there is none
+    int _unix_socket;
+
     // Threads that accepts new connections, each has private epoll instance
     // but share global server socket
     std::vector<std::thread> _acceptors;
 
-    // EPOLL instance shared between workers
-    int _data_epoll_fd;
+    // Workers register connections with EPOLLET
+    bool _edge_triggered;
 
-    // Curstom event "device" used to wakeup workers
+    // Busy poll settings, see constructor
+    std::chrono::microseconds _busy_poll;
+    int _socket_busy_poll;
+
+    // Curstom event "device" used to wakeup acceptors
     int _event_fd;
 
     // threads serving read/write requests
-    std::vector<Worker> _workers;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Worker to start looking for the least loaded one from
+    std::atomic<std::size_t> _next_worker;
+
+    // Connections dropped since inbox of every worker was full
+    std::atomic<uint64_t> _dropped;
+
+    // Workers pinned to each CPU, filled only if connections are matched by incoming CPU
+    std::unordered_map<int, std::vector<Worker *>> _cpu_workers;
 };
 
 } // namespace MTnonblock
@@ -1,16 +1,22 @@
 #include "Worker.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstring>
 #include <functional>
-#include <iostream>
+#include <stdexcept>
 
 #include <netdb.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <spdlog/logger.h>
 
+#include <afina/concurrency/Topology.h>
 #include <afina/logging/Service.h>
 
 #include "Connection.h"
@@ -20,117 +26,307 @@ namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
-// See Worker.h
-Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1) {
-    // TODO: implementation here
-}
+constexpr uint64_t Worker::kBusyConnectionRate;
+constexpr std::size_t Worker::kInboxSize;
+constexpr std::chrono::milliseconds Worker::kTimerResolution;
 
-// See Worker.h
-Worker::~Worker() {
-    // TODO: implementation here
-}
+// How often event rate is recalculated
+static constexpr std::chrono::milliseconds kRatePeriod(1000);
 
 // See Worker.h
-Worker::Worker(Worker &&other) { *this = std::move(other); }
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl,
+               bool edge_triggered, std::chrono::milliseconds idle_timeout, std::chrono::milliseconds read_timeout,
+               const ConnectionLimits &limits, std::chrono::microseconds busy_poll)
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _event_fd(-1), _inbox(kInboxSize),
+      _edge_triggered(edge_triggered), _idle_timeout(idle_timeout), _read_timeout(read_timeout), _limits(limits),
+      _busy_poll(busy_poll), _buffers(Connection::kReadBuffer), _timers(kTimerResolution), _assigned(0), _events(0),
+      _event_rate(0), _memory_per_connection(0), _spins(0), _spin_hits(0), _parks(0), _overflows(0) {}
 
 // See Worker.h
-Worker &Worker::operator=(Worker &&other) {
-    _pStorage = std::move(other._pStorage);
-    _pLogging = std::move(other._pLogging);
-    _logger = std::move(other._logger);
-    _thread = std::move(other._thread);
-    _epoll_fd = other._epoll_fd;
-
-    other._epoll_fd = -1;
-    return *this;
-}
+Worker::~Worker() {}
 
 // See Worker.h
-void Worker::Start(int epoll_fd) {
+void Worker::Start(int cpu) {
     if (isRunning.exchange(true) == false) {
         assert(_epoll_fd == -1);
-        _epoll_fd = epoll_fd;
         _logger = _pLogging->select("network.worker");
+
+        _epoll_fd = epoll_create1(0);
+        if (_epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+
+        _event_fd = eventfd(0, EFD_NONBLOCK);
+        if (_event_fd == -1) {
+            throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+        }
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
+
+        _events_since = std::chrono::steady_clock::now();
         _thread = std::thread(&Worker::OnRun, this);
+        if (cpu >= 0) {
+            int err = Concurrency::Topology::Pin(_thread, cpu);
+            if (err != 0) {
+                _logger->warn("Failed to pin worker to cpu {}: {}", cpu, strerror(err));
+            }
+        }
     }
 }
 
 // See Worker.h
-void Worker::Stop() { isRunning = false; }
+void Worker::Stop() {
+    isRunning = false;
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
 
 // See Worker.h
 void Worker::Join() {
     assert(_thread.joinable());
     _thread.join();
+
+    // Idle connections hold no read buffer, so that's mostly connection itself
+    if (!_connections.empty()) {
+        _logger->info("Worker memory: {} connections, {} bytes per connection, {} read buffers in use",
+                      _connections.size(), MeasureMemory(), _buffers.InUse());
+    }
+    if (_busy_poll.count() > 0) {
+        _logger->info("Worker busy poll: {} empty spins, {} spins caught events, {} parks", Spins(), SpinHits(),
+                      Parks());
+    }
+    if (Overflows() > 0) {
+        _logger->info("Worker inbox: {} sockets refused while full", Overflows());
+    }
+
+    // Sockets assigned too late are never served
+    _inbox.Consume([](int socket) { close(socket); });
+    while (!_connections.empty()) {
+        Close(*_connections.begin());
+    }
+
+    close(_event_fd);
+    close(_epoll_fd);
 }
 
+// See Worker.h
+bool Worker::Assign(int socket) {
+    _assigned.fetch_add(1, std::memory_order_relaxed);
+
+    bool was_empty;
+    if (!_inbox.Push(socket, was_empty)) {
+        _assigned.fetch_sub(1, std::memory_order_relaxed);
+        _overflows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (was_empty && eventfd_write(_event_fd, 1)) {
+        _logger->error("Failed to wakeup worker: {}", strerror(errno));
+    }
+    return true;
+}
+
+// See Worker.h
+uint64_t Worker::Load() const { return Connections() * kBusyConnectionRate + EventRate(); }
+
 // See Worker.h
 void Worker::OnRun() {
     assert(_epoll_fd >= 0);
     _logger->trace("OnRun");
 
-    // Process connection events
-    //
-    // Do not forget to use EPOLLEXCLUSIVE flag when register socket
-    // for events to avoid thundering herd type behavior.
-    int timeout = -1;
     std::array<struct epoll_event, 64> mod_list;
+    std::vector<Connection *> resume;
+    auto last_event = std::chrono::steady_clock::now();
     while (isRunning) {
+        // Wake up now and then to keep event rate up to date while there are connections and in time for the
+        // nearest timer, don't sleep at all if some connections have data to read already
+        int timeout = _connections.empty() ? -1 : kRatePeriod.count();
+        int timers_timeout = _timers.Timeout();
+        if (timers_timeout >= 0 && (timeout < 0 || timers_timeout < timeout)) {
+            timeout = timers_timeout;
+        }
+        if (!_ready.empty()) {
+            timeout = 0;
+        }
+
+        // Busy poll: the next event is likely to come soon after the last one, so keep polling till the budget
+        // runs out, then block as usual
+        bool spinning = false;
+        if (timeout != 0 && _busy_poll.count() > 0 && std::chrono::steady_clock::now() - last_event < _busy_poll) {
+            timeout = 0;
+            spinning = true;
+        }
+
         int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), timeout);
-        _logger->debug("Worker wokeup: {} events", nmod);
+        if (spinning) {
+            (nmod > 0 ? _spin_hits : _spins).fetch_add(1, std::memory_order_relaxed);
+        } else if (timeout != 0) {
+            _parks.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (nmod > 0) {
+            last_event = std::chrono::steady_clock::now();
+        }
+        if (!spinning || nmod != 0) {
+            _logger->debug("Worker wokeup: {} events", nmod);
+        }
 
         for (int i = 0; i < nmod; i++) {
             struct epoll_event &current_event = mod_list[i];
 
-            // nullptr is used by server for event_fd "interface", if we got here then server
-            // signals us to wakeup to process some state change, ignore it in INNER loop, react
-            // on changes in OUTHER loop
+            // nullptr is used for event_fd "interface": acceptors have put connections into the inbox or
+            // server signals us to stop, the latter is checked in OUTHER loop
             if (current_event.data.ptr == nullptr) {
+                eventfd_t value;
+                eventfd_read(_event_fd, &value);
+                OnAssigned();
                 continue;
             }
 
             // Some connection gets new data
-            Connection *pconn = static_cast<Connection *>(current_event.data.ptr);
-            if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
-                _logger->debug("Got EPOLLERR or EPOLLHUP, value of returned events: {}", current_event.events);
-                pconn->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                _logger->debug("Got EPOLLRDHUP, value of returned events: {}", current_event.events);
-                pconn->OnClose();
-            } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
-                    _logger->trace("Got EPOLLIN");
-                    pconn->DoRead();
-                }
-                if (current_event.events & EPOLLOUT) {
-                    _logger->trace("Got EPOLLOUT");
-                    pconn->DoWrite();
-                }
-            }
+            Serve(static_cast<Connection *>(current_event.data.ptr), current_event.events);
+        }
 
-            // Rearm connection
-            if (pconn->isAlive()) {
-                pconn->_event.events |= EPOLLONESHOT;
-                int epoll_ctl_retval;
-                if ((epoll_ctl_retval = epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event))) {
-                    _logger->debug("epoll_ctl failed during connection rearm: error {}", epoll_ctl_retval);
-                    pconn->OnError();
-                    delete pconn;
-                }
+        // Connections stopped by the read budget on the previous iteration go after the ones epoll reported
+        resume.swap(_ready);
+        for (Connection *pconn : resume) {
+            pconn->_resume = false;
+            Serve(pconn, EPOLLIN);
+        }
+        resume.clear();
+
+        // Close timed out connections, only now when no event refers to them anymore
+        _timers.Advance();
+        OnEvents(nmod > 0 ? nmod : 0);
+    }
+    _logger->warn("Worker stopped");
+}
+
+// See Worker.h
+void Worker::Serve(Connection *pconn, uint32_t events) {
+    if (events & EPOLLERR) {
+        _logger->debug("Got EPOLLERR, value of returned events: {}", events);
+        pconn->OnError();
+    } else {
+        // Depends on what connection wants... Note that peer might close its side right after
+        // the last command, so commands must be read out even if EPOLLRDHUP is set
+        if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+            _logger->trace("Got EPOLLIN");
+            pconn->DoRead();
+        }
+        if (pconn->isAlive() && (events & EPOLLOUT)) {
+            _logger->trace("Got EPOLLOUT");
+            pconn->DoWrite();
+        }
+    }
+
+    if (_edge_triggered) {
+        // Registration stays as is, but epoll won't report data left in the socket
+        if (pconn->isAlive() && pconn->_read_pending && !pconn->_resume) {
+            pconn->_resume = true;
+            _ready.push_back(pconn);
+        }
+    } else if (pconn->isAlive() && pconn->_event.events != pconn->_armed_events) {
+        // Connection is served by this thread only, so epoll needs to know only about the changes
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event)) {
+            _logger->error("Failed to rearm connection on descriptor {}: {}", pconn->_socket, strerror(errno));
+            pconn->OnError();
+        } else {
+            pconn->_armed_events = pconn->_event.events;
+        }
+    }
+
+    // Or delete closed one
+    if (!pconn->isAlive()) {
+        Close(pconn);
+    } else {
+        pconn->Watch(_timers, _idle_timeout, _read_timeout);
+    }
+}
+
+// See Worker.h
+void Worker::OnAssigned() {
+    _inbox.Consume([this](int socket) {
+        Connection *pc = _slab.Create(socket, _pStorage, _logger, _limits, _buffers);
+        _connections.insert(pc);
+        pc->_timer.callback = [this, pc]() {
+            _logger->debug("Connection on descriptor {} timed out", pc->_socket);
+            Close(pc);
+        };
+        pc->Start();
+        if (pc->isAlive()) {
+            // Edge triggered connection waits for everything from the very beginning, so that its
+            // registration never changes
+            if (_edge_triggered) {
+                pc->_event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
             }
-            // Or delete closed one
-            else {
-                if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
-                    std::cerr << "Failed to delete connection!" << std::endl;
-                }
-                delete pconn;
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+                _logger->error("Failed to register connection on descriptor {}: {}", pc->_socket, strerror(errno));
+                pc->OnError();
+            } else {
+                pc->_armed_events = pc->_event.events;
             }
         }
-        // TODO: Select timeout...
+
+        if (!pc->isAlive()) {
+            Close(pc);
+        } else {
+            pc->Watch(_timers, _idle_timeout, _read_timeout);
+        }
+    });
+}
+
+// See Worker.h
+void Worker::OnEvents(std::size_t n) {
+    _events += n;
+
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _events_since);
+    if (elapsed >= kRatePeriod) {
+        _event_rate.store(_events * 1000 / elapsed.count(), std::memory_order_relaxed);
+        _events = 0;
+        _events_since = now;
+        _logger->debug("Worker memory: {} connections, {} bytes per connection", _connections.size(),
+                       MeasureMemory());
+        if (_busy_poll.count() > 0) {
+            _logger->debug("Worker busy poll: {} empty spins, {} spins caught events, {} parks", Spins(), SpinHits(),
+                           Parks());
+        }
+    }
+}
+
+// See Worker.h
+std::size_t Worker::MeasureMemory() {
+    std::size_t result = 0;
+    if (!_connections.empty()) {
+        result = (_slab.Memory() + _buffers.Memory()) / _connections.size();
+    }
+    _memory_per_connection.store(result, std::memory_order_relaxed);
+    return result;
+}
+
+// See Worker.h
+void Worker::Close(Connection *pc) {
+    if (pc->_armed_events != 0 && epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
+        _logger->error("Failed to delete connection from epoll");
+    }
+
+    if (pc->_resume) {
+        _ready.erase(std::find(_ready.begin(), _ready.end(), pc));
+    }
+
+    _connections.erase(pc);
+    close(pc->_socket);
+    _slab.Destroy(pc);
+
+    // Nothing to serve, nothing to measure
+    if (_assigned.fetch_sub(1, std::memory_order_relaxed) == 1) {
+        _event_rate.store(0, std::memory_order_relaxed);
     }
-    _logger->warn("Worker stopped");
 }
 
 } // namespace MTnonblock
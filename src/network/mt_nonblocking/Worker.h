@@ -2,8 +2,20 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_WORKER_H
 
 #include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <afina/concurrency/MpscQueue.h>
+#include <afina/network/Server.h>
+
+#include "network/BufferPool.h"
+#include "network/Slab.h"
+#include "network/TimerWheel.h"
 
 namespace spdlog {
 class logger;
@@ -20,25 +32,65 @@ class Service;
 namespace Network {
 namespace MTnonblock {
 
+// Forward declaration, see Connection.h
+class Connection;
+
 /**
  * # Thread running epoll
- * On Start spaws background thread that is doing epoll on the given server
- * socket and process incoming connections and its data
+ * Worker serves connections assigned to it on the private epoll till the end. Acceptors hand accepted sockets
+ * over through the inbox and wake worker up by the eventfd, only when inbox turns non empty. Worker takes the
+ * whole inbox at once and creates connections in its own slab, so connection memory never crosses threads.
+ *
+ * Load of the worker is published for acceptors to pick the least loaded one, see Load.
+ *
+ * In edge triggered mode connection is registered once for everything it might ever wait for, and epoll
+ * registration is never touched again. Epoll doesn't report data already there, so connection which has
+ * run out of read budget is resumed by the worker itself on the next iteration.
+ *
+ * Connection timeouts are kept in the timing wheel of the worker, which also sets epoll_wait timeout. Connection
+ * throttled by the output high mark isn't read till output drains, after that it is resumed the same way.
+ *
+ * In busy poll mode worker doesn't sleep in epoll_wait for a while after the last event but polls epoll with
+ * zero timeout, so that the next request is picked up without the wakeup latency. Once nothing has arrived
+ * for the whole spin budget worker parks in the blocking wait again, so idle worker costs no CPU. Spins and
+ * parks are counted to see how much CPU goes for latency
  */
 class Worker {
 public:
-    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
+    /**
+     * Events per second making connection as heavy as one more idle connection
+     */
+    static constexpr uint64_t kBusyConnectionRate = 1000;
+
+    /**
+     * Length of the timing wheel tick
+     */
+    static constexpr std::chrono::milliseconds kTimerResolution{10};
+
+    /**
+     * @param edge_triggered register connections with EPOLLET, see class description
+     * @param idle_timeout close connection waiting for the next command that long, 0 to never
+     * @param read_timeout close connection receiving a command that long, 0 to never
+     * @param limits buffering limits of connections
+     * @param busy_poll time to keep polling epoll after the last event before blocking, 0 to block right away
+     */
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl, bool edge_triggered,
+           std::chrono::milliseconds idle_timeout, std::chrono::milliseconds read_timeout,
+           const ConnectionLimits &limits, std::chrono::microseconds busy_poll);
     ~Worker();
 
-    Worker(Worker &&);
-    Worker &operator=(Worker &&);
+    /**
+     * Sockets inbox holds at once
+     */
+    static constexpr std::size_t kInboxSize = 1024;
 
     /**
-     * Spaws new background thread that is doing epoll on the given server
-     * socket. Once connection accepted it must be registered and being processed
-     * on this thread
+     * Spaws new background thread that is doing epoll on the private epoll instance. Throws
+     * std::runtime_error if epoll couldn't be set up
+     *
+     * @param cpu to pin thread to, -1 to let scheduler decide
      */
-    void Start(int epoll_fd);
+    void Start(int cpu);
 
     /**
      * Signal background thread to stop. After that signal thread must stop to
@@ -50,19 +102,69 @@ public:
 
     /**
      * Blocks calling thread until background one for this worker is actually
-     * been destoryed
+     * been destoryed, then closes all connections left
      */
     void Join();
 
+    /**
+     * Hand accepted socket over to the worker, any thread. Worker serves and closes it from now on. Returns
+     * false if the inbox is full, then socket stays with the caller
+     */
+    bool Assign(int socket);
+
+    /**
+     * Connections assigned to the worker, including ones still in the inbox, along with the event rate in
+     * kBusyConnectionRate units: a worker serving a few busy clients looks as loaded as one serving many idle
+     */
+    uint64_t Load() const;
+
+    // Connections assigned and events per second measured lately
+    inline std::size_t Connections() const { return _assigned.load(std::memory_order_relaxed); }
+    inline uint64_t EventRate() const { return _event_rate.load(std::memory_order_relaxed); }
+
+    // Bytes connection costs the worker: connection itself and read buffers, both lent and cached, spread over
+    // connections. Measured along with the event rate
+    inline std::size_t MemoryPerConnection() const { return _memory_per_connection.load(std::memory_order_relaxed); }
+
+    // Busy poll counters: polls that found nothing, polls that caught events, blocking waits
+    inline uint64_t Spins() const { return _spins.load(std::memory_order_relaxed); }
+    inline uint64_t SpinHits() const { return _spin_hits.load(std::memory_order_relaxed); }
+    inline uint64_t Parks() const { return _parks.load(std::memory_order_relaxed); }
+
+    // Sockets refused by Assign since inbox was full, acceptors hand them to other workers then
+    inline uint64_t Overflows() const { return _overflows.load(std::memory_order_relaxed); }
+
 protected:
     /**
      * Method executing by background thread
      */
     void OnRun();
 
+    /**
+     * Create connections for sockets from the inbox and register them in epoll
+     */
+    void OnAssigned();
+
+    /**
+     * Process events connection got, then update epoll registration or close connection
+     */
+    void Serve(Connection *pc, uint32_t events);
+
+    /**
+     * Account events processed, recalculate rate and memory per connection once per period
+     */
+    void OnEvents(std::size_t n);
+
+    /**
+     * Recalculate memory per connection
+     */
+    std::size_t MeasureMemory();
+
 private:
-    Worker(Worker &) = delete;
-    Worker &operator=(Worker &) = delete;
+    Worker(const Worker &) = delete;
+    Worker &operator=(const Worker &) = delete;
+
+    void Close(Connection *pc);
 
     // afina services
     std::shared_ptr<Afina::Storage> _pStorage;
@@ -79,8 +181,56 @@ private:
     // Thread serving requests in this worker
     std::thread _thread;
 
-    // EPOLL descriptor using for events processing
+    // EPOLL descriptor using for events processing, private for this worker
     int _epoll_fd;
+
+    // Curstom event "device" used to wakeup worker
+    int _event_fd;
+
+    // Sockets handed over by acceptors but not served yet. Lock free ring of preallocated cells, so handover
+    // neither blocks acceptors nor allocates
+    Concurrency::MpscQueue<int> _inbox;
+
+    // Connections are registered with EPOLLET
+    const bool _edge_triggered;
+
+    // Connection timeouts, see constructor
+    const std::chrono::milliseconds _idle_timeout;
+    const std::chrono::milliseconds _read_timeout;
+
+    // Buffering limits of connections
+    const ConnectionLimits _limits;
+
+    // Time to keep polling after the last event
+    const std::chrono::microseconds _busy_poll;
+
+    // Connections, buffers they read into and their timers, accessed by worker thread only
+    Slab<Connection> _slab;
+    BufferPool _buffers;
+    TimerWheel _timers;
+
+    // Connections owned by the worker, accessed by its thread only
+    std::unordered_set<Connection *> _connections;
+
+    // Connections which have run out of read budget in edge triggered mode
+    std::vector<Connection *> _ready;
+
+    // Connections assigned, published for acceptors
+    std::atomic<std::size_t> _assigned;
+
+    // Events processed since the rate has been calculated last time and the rate itself
+    uint64_t _events;
+    std::chrono::steady_clock::time_point _events_since;
+    std::atomic<uint64_t> _event_rate;
+    std::atomic<std::size_t> _memory_per_connection;
+
+    // Busy poll counters, written by the worker thread only
+    std::atomic<uint64_t> _spins;
+    std::atomic<uint64_t> _spin_hits;
+    std::atomic<uint64_t> _parks;
+
+    // Sockets refused since inbox was full, written by acceptors
+    std::atomic<uint64_t> _overflows;
 };
 
 } // namespace MTnonblock
@@ -0,0 +1,82 @@
+#include "ServerImpl.h"
+
+#include <stdexcept>
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include "Worker.h"
+#include "network/UnixSocket.h"
+
+namespace Afina {
+namespace Network {
+namespace MTreuseport {
+
+// See ServerImpl.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _unix_socket(-1) {}
+
+// See ServerImpl.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start mt_reuseport network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    if (!unix_socket.empty()) {
+        _unix_socket = ListenUnixSocket(unix_socket, SOMAXCONN);
+    }
+
+    // Worker that fails to start closes what it has opened, the ones started already are stopped here
+    const std::vector<int> &cpus = placement.workers;
+    _workers.reserve(n_workers);
+    try {
+        for (uint32_t i = 0; i < n_workers; i++) {
+            _workers.emplace_back(new Worker(pStorage, _logger, idle_timeout, read_timeout, limits));
+            _workers.back()->Start(port, cpus.empty() ? -1 : cpus[i % cpus.size()], placement.incoming_cpu,
+                                   _unix_socket);
+        }
+    } catch (std::runtime_error &) {
+        _workers.clear();
+        CloseUnixSocket(_unix_socket, unix_socket);
+        _unix_socket = -1;
+        throw;
+    }
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+    for (auto &w : _workers) {
+        w->Stop();
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    for (auto &w : _workers) {
+        w->Join();
+    }
+    _workers.clear();
+
+    CloseUnixSocket(_unix_socket, unix_socket);
+    _unix_socket = -1;
+}
+
+} // namespace MTreuseport
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,55 @@
+#ifndef AFINA_NETWORK_MT_REUSEPORT_SERVER_H
+#define AFINA_NETWORK_MT_REUSEPORT_SERVER_H
+
+#include <memory>
+#include <vector>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace MTreuseport {
+
+// Forward declaration, see Worker.h
+class Worker;
+
+/**
+ * # Network resource manager implementation
+ * Shared nothing epoll based server: each worker owns listening socket bound to the same port with
+ * SO_REUSEPORT, epoll instance and all connections it has accepted. Kernel balances incoming connections
+ * between listeners, so there is neither handoff between threads nor shared epoll to rearm
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    // See Server.h, acceptors are ignored as each worker accepts its own connections
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+private:
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Threads serving connections end to end
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Unix domain socket listener shared by workers, -1 if there is none
+    int _unix_socket;
+};
+
+} // namespace MTreuseport
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_REUSEPORT_SERVER_H
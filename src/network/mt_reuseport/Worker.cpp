@@ -0,0 +1,284 @@
+#include "Worker.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/Topology.h>
+
+#include "network/st_nonblocking/Connection.h"
+
+namespace Afina {
+namespace Network {
+namespace MTreuseport {
+
+using STnonblock::Connection;
+
+// See Worker.h
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl,
+               std::chrono::milliseconds idle_timeout, std::chrono::milliseconds read_timeout,
+               const ConnectionLimits &limits)
+    : _pStorage(ps), _logger(pl), _idle_timeout(idle_timeout), _read_timeout(read_timeout), _limits(limits), _server_socket(-1), _unix_socket(-1), _epoll_fd(-1), _event_fd(-1),
+      _buffers(Connection::kReadBuffer), _timers(std::chrono::milliseconds(100)) {}
+
+// See Worker.h
+Worker::~Worker() {
+    if (_thread.joinable()) {
+        Stop();
+        Join();
+    }
+}
+
+// See Worker.h
+void Worker::Start(uint16_t port, int cpu, bool incoming_cpu, int unix_socket) {
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    // Every worker binds the same port, kernel spreads incoming connections between them
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_KEEPALIVE, &opts, sizeof(opts)) == -1) {
+        CloseDescriptors();
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    // Ask kernel to prefer this listener for connections whose packets are handled by the worker CPU
+    if (incoming_cpu && cpu >= 0 && setsockopt(_server_socket, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu))) {
+        _logger->warn("Failed to match listener to cpu {}: {}", cpu, strerror(errno));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        CloseDescriptors();
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        CloseDescriptors();
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd == -1) {
+        CloseDescriptors();
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_event_fd == -1) {
+        CloseDescriptors();
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &_server_socket;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
+        CloseDescriptors();
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    event.events = EPOLLIN;
+    event.data.ptr = &_event_fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+        CloseDescriptors();
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    // Unix socket can't be reused by port, so workers share the single listener, and only one of them is woken
+    // up for each connection
+    _unix_socket = unix_socket;
+    if (_unix_socket != -1) {
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.ptr = &_unix_socket;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _unix_socket, &event)) {
+            CloseDescriptors();
+            throw std::runtime_error("Failed to add file descriptor to epoll");
+        }
+    }
+
+    _thread = std::thread(&Worker::OnRun, this);
+    if (cpu >= 0) {
+        int err = Concurrency::Topology::Pin(_thread, cpu);
+        if (err != 0) {
+            _logger->warn("Failed to pin worker to cpu {}: {}", cpu, strerror(err));
+        }
+    }
+}
+
+// See Worker.h
+void Worker::Stop() {
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
+
+// See Worker.h
+void Worker::Join() {
+    _thread.join();
+
+    // Idle connections hold no read buffer, so that's mostly connection itself
+    if (!_connections.empty()) {
+        _logger->info("Worker memory: {} connections, {} bytes per connection, {} read buffers in use",
+                      _connections.size(),
+                      (_slab.Memory() + _buffers.Memory()) / _connections.size(),
+                      _buffers.InUse());
+    }
+
+    for (auto pc : _connections) {
+        close(pc->_socket);
+        _slab.Destroy(pc);
+    }
+    _connections.clear();
+
+    CloseDescriptors();
+}
+
+// See Worker.h
+void Worker::CloseDescriptors() {
+    for (int *fd : {&_server_socket, &_event_fd, &_epoll_fd}) {
+        if (*fd != -1) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    _logger->info("Start worker");
+
+    bool run = true;
+    std::array<struct epoll_event, 64> mod_list;
+    while (run) {
+        int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), _timers.Timeout());
+        _logger->debug("Worker wokeup: {} events", nmod);
+
+        for (int i = 0; i < nmod; i++) {
+            struct epoll_event &current_event = mod_list[i];
+            if (current_event.data.ptr == &_event_fd) {
+                _logger->debug("Break worker due to stop signal");
+                run = false;
+                continue;
+            } else if (current_event.data.ptr == &_server_socket) {
+                OnNewConnection(_server_socket);
+                continue;
+            } else if (current_event.data.ptr == &_unix_socket) {
+                OnNewConnection(_unix_socket);
+                continue;
+            }
+
+            // That is some connection!
+            Connection *pc = static_cast<Connection *>(current_event.data.ptr);
+
+            auto old_mask = pc->_event.events;
+            if (current_event.events & EPOLLERR) {
+                pc->OnError();
+            } else {
+                // Depends on what connection wants... Note that peer might close its side right after
+                // the last command, so commands must be read out even if EPOLLRDHUP is set
+                if (current_event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+                    pc->DoRead();
+                }
+                if (pc->isAlive() && (current_event.events & EPOLLOUT)) {
+                    pc->DoWrite();
+                }
+            }
+
+            // Does it alive?
+            if (!pc->isAlive()) {
+                Close(pc);
+            } else if (pc->_event.events != old_mask &&
+                       epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pc->_socket, &pc->_event)) {
+                _logger->error("Failed to change connection event mask");
+                pc->OnClose();
+                Close(pc);
+            } else {
+                pc->Watch(_timers, _idle_timeout, _read_timeout);
+            }
+        }
+
+        // Close connections which have timed out, only now when no event refers to them
+        _timers.Advance();
+    }
+    _logger->warn("Worker stopped");
+}
+
+// See Worker.h
+void Worker::OnNewConnection(int listener) {
+    for (;;) {
+        struct sockaddr in_addr;
+        socklen_t in_len;
+
+        // No need to make these sockets non blocking since accept4() takes care of it.
+        in_len = sizeof in_addr;
+        int infd = accept4(listener, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                _logger->error("Failed to accept socket");
+            }
+            break;
+        }
+
+        // Print host and service info.
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        int retval =
+            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+        if (retval == 0) {
+            _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        }
+
+        Connection *pc = _slab.Create(infd, _pStorage, _logger, _limits, _buffers);
+        pc->_timer.callback = [this, pc]() {
+            _logger->debug("Connection on descriptor {} timed out", pc->_socket);
+            Close(pc);
+        };
+
+        pc->Start();
+        if (pc->isAlive()) {
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+                pc->OnError();
+                close(pc->_socket);
+                _slab.Destroy(pc);
+            } else {
+                _connections.insert(pc);
+                pc->Watch(_timers, _idle_timeout, _read_timeout);
+            }
+        }
+    }
+}
+
+// See Worker.h
+void Worker::Close(Connection *pc) {
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
+        _logger->error("Failed to delete connection from epoll");
+    }
+
+    _connections.erase(pc);
+    close(pc->_socket);
+    _slab.Destroy(pc);
+}
+
+} // namespace MTreuseport
+} // namespace Network
+} // namespace Afina
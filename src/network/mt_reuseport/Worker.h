@@ -0,0 +1,133 @@
+#ifndef AFINA_NETWORK_MT_REUSEPORT_WORKER_H
+#define AFINA_NETWORK_MT_REUSEPORT_WORKER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+
+#include <afina/network/Server.h>
+
+#include "network/BufferPool.h"
+#include "network/Slab.h"
+#include "network/TimerWheel.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+namespace STnonblock {
+class Connection;
+} // namespace STnonblock
+
+namespace MTreuseport {
+
+/**
+ * # Thread serving its own listener
+ * Worker accepts connections on the private SO_REUSEPORT socket and processes them on the same thread
+ * till the end. Connections never migrate, so st_nonblocking connections are used as is
+ */
+class Worker {
+public:
+    /**
+     * @param idle_timeout close connection waiting for the next command that long, 0 to never
+     * @param read_timeout close connection receiving a command that long, 0 to never
+     * @param limits buffering limits of connections
+     */
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl,
+           std::chrono::milliseconds idle_timeout, std::chrono::milliseconds read_timeout,
+           const ConnectionLimits &limits);
+    ~Worker();
+
+    /**
+     * Opens listening socket on the given port and spawns background thread serving it. Throws
+     * std::runtime_error if socket couldn't be set up
+     *
+     * @param port to listen on, shared with other workers
+     * @param cpu to pin thread to, -1 to let scheduler decide
+     * @param incoming_cpu prefer this listener for connections arriving on that CPU, see SO_INCOMING_CPU
+     * @param unix_socket listener shared by all workers, owned by the server, -1 if there is none
+     */
+    void Start(uint16_t port, int cpu, bool incoming_cpu, int unix_socket);
+
+    /**
+     * Signal background thread to stop
+     */
+    void Stop();
+
+    /**
+     * Blocks calling thread until background one is stopped, then closes all connections left
+     */
+    void Join();
+
+protected:
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+    void OnNewConnection(int listener);
+
+    /**
+     * Unregister connection and destroy it
+     */
+    void Close(STnonblock::Connection *pc);
+
+    /**
+     * Close listener, epoll and event descriptors opened so far, so that failed Start leaves nothing behind.
+     * Unix socket is owned by the server
+     */
+    void CloseDescriptors();
+
+private:
+    Worker(const Worker &) = delete;
+    Worker &operator=(const Worker &) = delete;
+
+    // afina services
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Connection timeouts, zero is never
+    const std::chrono::milliseconds _idle_timeout;
+    const std::chrono::milliseconds _read_timeout;
+
+    // Buffering limits of connections
+    const ConnectionLimits _limits;
+
+    // Socket to accept new connection on, private for this worker
+    int _server_socket;
+
+    // Unix domain socket listener shared by all workers, -1 if there is none
+    int _unix_socket;
+
+    // EPOLL descriptor watching listener and all connections of this worker
+    int _epoll_fd;
+
+    // Curstom event "device" used to wakeup worker
+    int _event_fd;
+
+    // Connections owned by the worker, accessed by its thread only
+    std::set<STnonblock::Connection *> _connections;
+
+    // Connections, buffers they read into and their timers, accessed by worker thread only
+    Slab<STnonblock::Connection> _slab;
+    BufferPool _buffers;
+    TimerWheel _timers;
+
+    // Thread serving requests in this worker
+    std::thread _thread;
+};
+
+} // namespace MTreuseport
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_REUSEPORT_WORKER_H
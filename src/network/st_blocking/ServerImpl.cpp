@@ -9,6 +9,7 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <pthread.h>
 #include <signal.h>
 #include <sys/socket.h>
@@ -21,6 +22,8 @@
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 
+#include "network/OutputQueue.h"
+#include "network/UnixSocket.h"
 #include "protocol/Parser.h"
 
 namespace Afina {
@@ -28,7 +31,8 @@ namespace Network {
 namespace STblocking {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _unix_socket(-1) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -101,6 +105,16 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
         throw std::runtime_error("Socket listen() failed");
     }
 
+    // Connections from both listeners are served the same way, accept loop waits for any of them
+    if (!unix_socket.empty()) {
+        try {
+            _unix_socket = ListenUnixSocket(unix_socket, 5);
+        } catch (std::runtime_error &) {
+            close(_server_socket);
+            throw;
+        }
+    }
+
     running.store(true);
     _thread = std::thread(&ServerImpl::OnRun, this);
 }
@@ -109,6 +123,9 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
 void ServerImpl::Stop() {
     running.store(false);
     shutdown(_server_socket, SHUT_RDWR);
+    if (_unix_socket != -1) {
+        shutdown(_unix_socket, SHUT_RDWR);
+    }
 }
 
 // See Server.h
@@ -116,6 +133,8 @@ void ServerImpl::Join() {
     assert(_thread.joinable());
     _thread.join();
     close(_server_socket);
+    CloseUnixSocket(_unix_socket, unix_socket);
+    _unix_socket = -1;
 }
 
 // See Server.h
@@ -125,18 +144,28 @@ void ServerImpl::OnRun() {
     // - command_to_execute: last command parsed out of stream
     // - arg_remains: how many bytes to read from stream to get command argument
     // - argument_for_command: buffer stores argument
+    // - output: responses waiting to be sent
     std::size_t arg_remains;
     Protocol::Parser parser;
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
+    OutputQueue output;
     while (running.load()) {
         _logger->debug("waiting for connection...");
 
-        // The call to accept() blocks until the incoming connection arrives
+        // The call to poll() blocks until the incoming connection arrives on any listener, negative descriptor of
+        // missing unix socket is skipped. Unix listener is nonblocking, so connection taken by the time accept() is
+        // called doesn't hold the loop
+        struct pollfd listeners[2] = {{_server_socket, POLLIN, 0}, {_unix_socket, POLLIN, 0}};
+        if (poll(listeners, 2, -1) <= 0) {
+            continue;
+        }
+        int listener = listeners[0].revents != 0 ? _server_socket : _unix_socket;
+
         int client_socket;
         struct sockaddr client_addr;
         socklen_t client_addr_len = sizeof(client_addr);
-        if ((client_socket = accept(_server_socket, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
+        if ((client_socket = accept(listener, (struct sockaddr *)&client_addr, &client_addr_len)) == -1) {
             continue;
         }
 
@@ -153,11 +182,16 @@ void ServerImpl::OnRun() {
             _logger->debug("Accepted connection on descriptor {} (host={}, port={})\n", client_socket, host, port);
         }
 
-        // Configure read timeout
-        {
+        // Configure read timeout: blocking read can't tell waiting for the next command from waiting for
+        // the rest of the current one, so each read is bounded by the shorter of both timeouts
+        std::chrono::milliseconds timeout = read_timeout;
+        if (idle_timeout.count() > 0 && (timeout.count() == 0 || idle_timeout < timeout)) {
+            timeout = idle_timeout;
+        }
+        if (timeout.count() > 0) {
             struct timeval tv;
-            tv.tv_sec = 5; // TODO: make it configurable
-            tv.tv_usec = 0;
+            tv.tv_sec = timeout.count() / 1000;
+            tv.tv_usec = (timeout.count() % 1000) * 1000;
             setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
         }
 
@@ -216,14 +250,14 @@ void ServerImpl::OnRun() {
                     if (command_to_execute && arg_remains == 0) {
                         _logger->debug("Start command execution");
 
-                        std::string result;
+                        Execute::Response result;
+                        if (argument_for_command.size() >= 2) {
+                            argument_for_command.resize(argument_for_command.size() - 2);
+                        }
                         command_to_execute->Execute(*pStorage, argument_for_command, result);
 
-                        // Send response
-                        result += "\r\n";
-                        if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                            throw std::runtime_error("Failed to send response");
-                        }
+                        // Queue response, it will be sent along with the rest of responses for this read
+                        output.Push(std::move(result));
 
                         // Prepare for the next command
                         command_to_execute.reset();
@@ -231,6 +265,12 @@ void ServerImpl::OnRun() {
                         parser.Reset();
                     }
                 } // while (readed_bytes)
+
+                // Send responses for all commands found in this block by a single syscall
+                if (!output.Empty()) {
+                    _logger->debug("Send {} bytes of responses", output.Size());
+                    output.Flush(client_socket);
+                }
             }
 
             if (readed_bytes == 0) {
@@ -249,6 +289,7 @@ void ServerImpl::OnRun() {
         command_to_execute.reset();
         argument_for_command.resize(0);
         parser.Reset();
+        output.Clear();
     }
 
     // Cleanup on exit...
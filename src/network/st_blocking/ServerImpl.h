@@ -50,6 +50,9 @@ private:
     // Server socket to accept connections on
     int _server_socket;
 
+    // Unix domain socket listener, -1 if there is none
+    int _unix_socket;
+
     // Thread to run network on
     std::thread _thread;
 };
@@ -0,0 +1,55 @@
+#include "ServerImpl.h"
+
+#include <stdexcept>
+
+#include <pthread.h>
+#include <signal.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include "Worker.h"
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+// See ServerImpl.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+
+// See ServerImpl.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start st_coroutine network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    _worker.reset(new Worker(pStorage, _logger));
+    _worker->Start(port);
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+    _worker->Stop();
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    _worker->Join();
+    _worker.reset();
+}
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
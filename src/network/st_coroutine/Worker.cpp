@@ -0,0 +1,386 @@
+#include "Worker.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/execute/Command.h>
+
+#include "network/OutputQueue.h"
+#include "protocol/Parser.h"
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+// See Worker.h
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl)
+    : _pStorage(ps), _logger(pl), _server_socket(-1), _epoll_fd(-1), _event_fd(-1),
+      _engine(Afina::Coroutine::Engine::Mode::SeparateStacks) {}
+
+// See Worker.h
+Worker::~Worker() {
+    if (_thread.joinable()) {
+        Stop();
+        Join();
+    }
+}
+
+// See Worker.h
+void Worker::Start(uint16_t port) {
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    // Workers of mt_coroutine bind the same port, kernel spreads incoming connections between them
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &_server_socket;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    event.events = EPOLLIN;
+    event.data.ptr = &_event_fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    _thread = std::thread(&Worker::OnRun, this);
+}
+
+// See Worker.h
+void Worker::Stop() {
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
+
+// See Worker.h
+void Worker::Join() {
+    _thread.join();
+
+    close(_server_socket);
+    close(_event_fd);
+    close(_epoll_fd);
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    _logger->info("Start coroutine worker");
+
+    // Returns once event loop and all connection coroutines are done
+    _engine.start(&Worker::Loop, this);
+
+    // Deepest stack any connection has used, stack size could be tuned after that
+    auto &stacks = _engine.stacks();
+    _logger->info("Coroutine stacks high water {} bytes of {}", stacks.HighWater(), stacks.StackSize());
+    _logger->warn("Worker stopped");
+}
+
+// See Worker.h
+void Worker::Loop(Worker *self) { self->OnLoop(); }
+
+// See Worker.h
+void Worker::OnLoop() {
+    bool run = true;
+    std::array<struct epoll_event, 64> mod_list;
+    while (run) {
+        // Don't sleep in kernel while some coroutine is ready to run or its timer is about to expire
+        int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), _engine.idle_timeout());
+        if (nmod == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _logger->error("Failed to wait for events: {}", strerror(errno));
+            break;
+        }
+        _logger->debug("Worker wokeup: {} events", nmod);
+
+        for (int i = 0; i < nmod; i++) {
+            struct epoll_event &current_event = mod_list[i];
+            if (current_event.data.ptr == &_event_fd) {
+                _logger->debug("Break worker due to stop signal");
+                run = false;
+                continue;
+            } else if (current_event.data.ptr == &_server_socket) {
+                OnNewConnection();
+                continue;
+            }
+
+            // Socket is ready, let its coroutine try once again. Each connection shows up once per batch, so
+            // even if coroutine finishes and frees connection, there are no more references to it below
+            Connection *pc = static_cast<Connection *>(current_event.data.ptr);
+            if (pc->waiting) {
+                _engine.unblock(pc->routine);
+                _engine.sched(pc->routine);
+            }
+        }
+
+        // Let coroutines woken up by anything other than socket events run as well
+        _engine.yield();
+    }
+
+    // Shutdown sockets so that every coroutine still alive gets EOF or error and completes
+    std::vector<Connection *> connections(_connections.begin(), _connections.end());
+    for (auto pc : connections) {
+        shutdown(pc->socket, SHUT_RDWR);
+        if (pc->waiting) {
+            _engine.unblock(pc->routine);
+            _engine.sched(pc->routine);
+        }
+    }
+}
+
+// See Worker.h
+void Worker::OnNewConnection() {
+    for (;;) {
+        struct sockaddr in_addr;
+        socklen_t in_len;
+
+        // No need to make these sockets non blocking since accept4() takes care of it.
+        in_len = sizeof in_addr;
+        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                _logger->error("Failed to accept socket");
+            }
+            break;
+        }
+
+        // Print host and service info.
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        int retval =
+            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+        if (retval == 0) {
+            _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        }
+
+        Connection *pc = new (std::nothrow) Connection;
+        if (pc == nullptr) {
+            throw std::runtime_error("Failed to allocate connection");
+        }
+        pc->socket = infd;
+        pc->routine = nullptr;
+        pc->waiting = false;
+        pc->read_bytes = 0;
+
+        // Edge triggered both ways: socket is registered once, coroutine retries its call after each edge
+        // and parks again on EAGAIN, so there is no need to rearm or modify anything
+        pc->event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        pc->event.data.ptr = pc;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, infd, &pc->event)) {
+            _logger->error("Failed to add connection to epoll");
+            close(infd);
+            delete pc;
+            continue;
+        }
+
+        // Start serving right away, socket might have data already. Control gets back here once coroutine
+        // has to wait or is done
+        _connections.insert(pc);
+        pc->routine = _engine.run(&Worker::Serve, this, *pc);
+        _engine.sched(pc->routine);
+    }
+}
+
+// See Worker.h
+void Worker::Serve(Worker *self, Connection &conn) { self->OnConnection(conn); }
+
+// See Worker.h
+void Worker::OnConnection(Connection &conn) {
+    _logger->debug("Start connection on descriptor {}", conn.socket);
+
+    // Here is connection state
+    // - parser: parse state of the stream
+    // - command_to_execute: last command parsed out of stream
+    // - arg_remains: how many bytes to read from stream to get command argument
+    // - argument_for_command: buffer stores argument
+    // - output: responses waiting to be sent
+    std::size_t arg_remains = 0;
+    Protocol::Parser parser;
+    std::string argument_for_command;
+    std::unique_ptr<Execute::Command> command_to_execute;
+    OutputQueue output;
+
+    // Process connection:
+    // - read commands until socket alive
+    // - execute each command
+    // - send response
+    // Any call that would block passes control to other coroutines instead
+    try {
+        ssize_t readed_bytes = -1;
+        char *client_buffer = conn.read_buffer;
+        while ((readed_bytes = Read(conn, client_buffer + conn.read_bytes,
+                                    sizeof(conn.read_buffer) - conn.read_bytes)) > 0) {
+            _logger->debug("Got {} bytes from socket", readed_bytes);
+            conn.read_bytes += readed_bytes;
+
+            // Single block of data readed from the socket could trigger inside actions a multiple times,
+            // for example:
+            // - read#0: [<command1 start>]
+            // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+            std::size_t offset = 0;
+            while (offset < conn.read_bytes) {
+                // There is no command yet
+                if (!command_to_execute) {
+                    std::size_t parsed = 0;
+                    if (parser.Parse(client_buffer + offset, conn.read_bytes - offset, parsed)) {
+                        // There is no command to be launched, continue to parse input stream
+                        // Here we are, current chunk finished some command, process it
+                        _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
+                        command_to_execute = parser.Build(arg_remains);
+                        if (arg_remains > 0) {
+                            arg_remains += 2;
+                        }
+                    }
+
+                    // Parsed might fails to consume any bytes from input stream. In real life that could happens,
+                    // for example, because we are working with UTF-16 chars and only 1 byte left in stream
+                    if (parsed == 0) {
+                        break;
+                    }
+                    offset += parsed;
+                }
+
+                // There is command, but we still wait for argument to arrive...
+                if (command_to_execute && arg_remains > 0) {
+                    _logger->debug("Fill argument: {} bytes of {}", conn.read_bytes - offset, arg_remains);
+                    std::size_t to_read = std::min(arg_remains, conn.read_bytes - offset);
+                    argument_for_command.append(client_buffer + offset, to_read);
+
+                    offset += to_read;
+                    arg_remains -= to_read;
+                }
+
+                // Thre is command & argument - RUN!
+                if (command_to_execute && arg_remains == 0) {
+                    _logger->debug("Start command execution");
+
+                    Execute::Response result;
+                    if (argument_for_command.size() >= 2) {
+                        argument_for_command.resize(argument_for_command.size() - 2);
+                    }
+                    command_to_execute->Execute(*_pStorage, argument_for_command, result);
+
+                    // Queue response, it will be sent along with the rest of responses for this read
+                    output.Push(std::move(result));
+
+                    // Prepare for the next command
+                    command_to_execute.reset();
+                    argument_for_command.resize(0);
+                    parser.Reset();
+                }
+            }
+
+            // Keep unparsed tail for the next read
+            if (offset > 0) {
+                std::memmove(client_buffer, client_buffer + offset, conn.read_bytes - offset);
+                conn.read_bytes -= offset;
+            }
+
+            // Send responses for all commands found in this block
+            if (!output.Empty()) {
+                _logger->debug("Send {} bytes of responses", output.Size());
+                Send(conn, output);
+            }
+        }
+
+        if (readed_bytes == 0) {
+            _logger->debug("Connection closed");
+        } else {
+            throw std::runtime_error(std::string(strerror(errno)));
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", conn.socket, ex.what());
+    }
+
+    // We are done with this connection, closed socket leaves epoll by itself
+    _connections.erase(&conn);
+    close(conn.socket);
+    delete &conn;
+}
+
+// See Worker.h
+ssize_t Worker::Read(Connection &conn, char *buffer, std::size_t size) {
+    for (;;) {
+        ssize_t result = read(conn.socket, buffer, size);
+        if (result >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return result;
+        }
+        if (errno != EINTR) {
+            Wait(conn);
+        }
+    }
+}
+
+// See Worker.h
+void Worker::Send(Connection &conn, OutputQueue &output) {
+    while (!output.Empty()) {
+        if (output.Write(conn.socket) < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                Wait(conn);
+            } else if (errno != EINTR) {
+                throw std::runtime_error("Failed to send response: " + std::string(strerror(errno)));
+            }
+        }
+    }
+}
+
+// See Worker.h
+void Worker::Wait(Connection &conn) {
+    // Coroutine isn't runnable until event loop sees socket is ready, so engine never resumes it in vain
+    conn.waiting = true;
+    _engine.block();
+    conn.waiting = false;
+}
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,135 @@
+#ifndef AFINA_NETWORK_ST_COROUTINE_WORKER_H
+#define AFINA_NETWORK_ST_COROUTINE_WORKER_H
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <sys/types.h>
+
+#include <afina/coroutine/Engine.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+
+// Forward declaration, see network/OutputQueue.h
+class OutputQueue;
+
+namespace STcoroutine {
+
+/**
+ * # Thread serving connections as coroutines
+ * Worker owns listening socket, epoll instance and coroutine engine. Each accepted connection gets its own
+ * coroutine running plain blocking style read-execute-write loop. Once socket would block, coroutine parks
+ * itself and passes control back to the event loop, which resumes it when epoll reports socket is ready
+ */
+class Worker {
+public:
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl);
+    ~Worker();
+
+    /**
+     * Opens listening socket on the given port and spawns background thread serving it. Throws
+     * std::runtime_error if socket couldn't be set up
+     *
+     * @param port to listen on, could be shared with other workers
+     */
+    void Start(uint16_t port);
+
+    /**
+     * Signal background thread to stop
+     */
+    void Stop();
+
+    /**
+     * Blocks calling thread until background one is stopped
+     */
+    void Join();
+
+protected:
+    // Per connection state shared between its coroutine and the event loop
+    struct Connection {
+        int socket;
+        struct epoll_event event;
+
+        // Coroutine serving the connection
+        void *routine;
+
+        // Coroutine is blocked until socket gets ready
+        bool waiting;
+
+        // Bytes read from the socket but not processed yet
+        char read_buffer[4096];
+        std::size_t read_bytes;
+    };
+
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+
+    /**
+     * Event loop, the main coroutine of the engine
+     */
+    static void Loop(Worker *self);
+    void OnLoop();
+    void OnNewConnection();
+
+    /**
+     * Body of connection coroutine, returns once connection is closed
+     */
+    static void Serve(Worker *self, Connection &conn);
+    void OnConnection(Connection &conn);
+
+    /**
+     * Blocking style IO: park current coroutine until socket is ready instead of blocking the thread
+     */
+    ssize_t Read(Connection &conn, char *buffer, std::size_t size);
+    void Send(Connection &conn, OutputQueue &output);
+    void Wait(Connection &conn);
+
+private:
+    Worker(const Worker &) = delete;
+    Worker &operator=(const Worker &) = delete;
+
+    // afina services
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Socket to accept new connection on, private for this worker
+    int _server_socket;
+
+    // EPOLL descriptor watching listener and all connections of this worker
+    int _epoll_fd;
+
+    // Curstom event "device" used to wakeup worker
+    int _event_fd;
+
+    // Engine running event loop and all connection coroutines, accessed by worker thread only. Every coroutine
+    // has own stack, so switch doesn't depend on how deep parser and storage calls are
+    Afina::Coroutine::Engine _engine;
+
+    // Connections served at the moment
+    std::set<Connection *> _connections;
+
+    // Thread serving requests in this worker
+    std::thread _thread;
+};
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_COROUTINE_WORKER_H
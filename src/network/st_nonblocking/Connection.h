@@ -1,36 +1,50 @@
 #ifndef AFINA_NETWORK_ST_NONBLOCKING_CONNECTION_H
 #define AFINA_NETWORK_ST_NONBLOCKING_CONNECTION_H
 
-#include <cstring>
+#include <memory>
 
-#include <sys/epoll.h>
+#include <afina/network/Server.h>
+
+#include "network/BufferPool.h"
+#include "network/EpollConnection.h"
+
+namespace spdlog {
+class logger;
+}
 
 namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
 namespace Network {
+namespace MTreuseport {
+class Worker;
+} // namespace MTreuseport
+
 namespace STnonblock {
 
-class Connection {
+class Connection : public EpollConnection {
 public:
-    Connection(int s) : _socket(s) {
-        std::memset(&_event, 0, sizeof(struct epoll_event));
+    /**
+     * Size of read buffers connections borrow
+     */
+    static constexpr std::size_t kReadBuffer = 4096;
+
+    /**
+     * @param buffers pool to borrow read buffer from, must outlive connection
+     */
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl,
+               const ConnectionLimits &limits, BufferPool &buffers)
+        : EpollConnection(s, ps, pl, limits, buffers, 0) {
         _event.data.ptr = this;
     }
 
-    inline bool isAlive() const { return true; }
-
-    void Start();
-
-protected:
-    void OnError();
-    void OnClose();
-    void DoRead();
-    void DoWrite();
-
 private:
     friend class ServerImpl;
 
-    int _socket;
-    struct epoll_event _event;
+    // Shared nothing workers serve each connection on a single thread as well
+    friend class MTreuseport::Worker;
 };
 
 } // namespace STnonblock
@@ -23,13 +23,15 @@
 
 #include "Connection.h"
 #include "Utils.h"
+#include "network/UnixSocket.h"
 
 namespace Afina {
 namespace Network {
 namespace STnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _unix_socket(-1), _buffers(Connection::kReadBuffer), _timers(std::chrono::milliseconds(100)) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -75,8 +77,20 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
 
+    if (!unix_socket.empty()) {
+        try {
+            _unix_socket = ListenUnixSocket(unix_socket, SOMAXCONN);
+        } catch (std::runtime_error &) {
+            close(_server_socket);
+            throw;
+        }
+    }
+
     _event_fd = eventfd(0, EFD_NONBLOCK);
     if (_event_fd == -1) {
+        close(_server_socket);
+        CloseUnixSocket(_unix_socket, unix_socket);
+        _unix_socket = -1;
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
@@ -97,6 +111,9 @@ void ServerImpl::Stop() {
 void ServerImpl::Join() {
     // Wait for work to be complete
     _work_thread.join();
+
+    CloseUnixSocket(_unix_socket, unix_socket);
+    _unix_socket = -1;
 }
 
 // See ServerImpl.h
@@ -121,10 +138,19 @@ void ServerImpl::OnRun() {
         throw std::runtime_error("Failed to add file descriptor to epoll");
     }
 
+    if (_unix_socket != -1) {
+        struct epoll_event event3;
+        event3.events = EPOLLIN;
+        event3.data.fd = _unix_socket;
+        if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, _unix_socket, &event3)) {
+            throw std::runtime_error("Failed to add file descriptor to epoll");
+        }
+    }
+
     bool run = true;
     std::array<struct epoll_event, 64> mod_list;
     while (run) {
-        int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), -1);
+        int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), _timers.Timeout());
         _logger->debug("Acceptor wokeup: {} events", nmod);
 
         for (int i = 0; i < nmod; i++) {
@@ -133,8 +159,8 @@ void ServerImpl::OnRun() {
                 _logger->debug("Break acceptor due to stop signal");
                 run = false;
                 continue;
-            } else if (current_event.data.fd == _server_socket) {
-                OnNewConnection(epoll_descr);
+            } else if (current_event.data.fd == _server_socket || current_event.data.fd == _unix_socket) {
+                OnNewConnection(epoll_descr, current_event.data.fd);
                 continue;
             }
 
@@ -142,16 +168,15 @@ void ServerImpl::OnRun() {
             Connection *pc = static_cast<Connection *>(current_event.data.ptr);
 
             auto old_mask = pc->_event.events;
-            if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
+            if (current_event.events & EPOLLERR) {
                 pc->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                pc->OnClose();
             } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
+                // Depends on what connection wants... Note that peer might close its side right after
+                // the last command, so commands must be read out even if EPOLLRDHUP is set
+                if (current_event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
                     pc->DoRead();
                 }
-                if (current_event.events & EPOLLOUT) {
+                if (pc->isAlive() && (current_event.events & EPOLLOUT)) {
                     pc->DoWrite();
                 }
             }
@@ -163,32 +188,36 @@ void ServerImpl::OnRun() {
                 }
 
                 close(pc->_socket);
-                pc->OnClose();
+                _slab.Destroy(pc);
+            } else if (pc->_event.events != old_mask &&
+                       epoll_ctl(epoll_descr, EPOLL_CTL_MOD, pc->_socket, &pc->_event)) {
+                _logger->error("Failed to change connection event mask");
 
-                delete pc;
-            } else if (pc->_event.events != old_mask) {
-                if (epoll_ctl(epoll_descr, EPOLL_CTL_MOD, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to change connection event mask");
-
-                    close(pc->_socket);
-                    pc->OnClose();
+                close(pc->_socket);
+                pc->OnClose();
 
-                    delete pc;
-                }
+                _slab.Destroy(pc);
+            } else {
+                pc->Watch(_timers, idle_timeout, read_timeout);
             }
         }
+
+        // Close connections which have timed out, only now when no event refers to them
+        _timers.Advance();
     }
+    _logger->info("Read buffers: {} in use, {} cached, {} bytes", _buffers.InUse(), _buffers.Cached(),
+                  _buffers.Memory());
     _logger->warn("Acceptor stopped");
 }
 
-void ServerImpl::OnNewConnection(int epoll_descr) {
+void ServerImpl::OnNewConnection(int epoll_descr, int listener) {
     for (;;) {
         struct sockaddr in_addr;
         socklen_t in_len;
 
         // No need to make these sockets non blocking since accept4() takes care of it.
         in_len = sizeof in_addr;
-        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        int infd = accept4(listener, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (infd == -1) {
             if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
                 break; // We have processed all incoming connections.
@@ -207,17 +236,25 @@ void ServerImpl::OnNewConnection(int epoll_descr) {
         }
 
         // Register the new FD to be monitored by epoll.
-        Connection *pc = new(std::nothrow) Connection(infd);
-        if (pc == nullptr) {
-            throw std::runtime_error("Failed to allocate connection");
-        }
+        Connection *pc = _slab.Create(infd, pStorage, _logger, limits, _buffers);
+        pc->_timer.callback = [this, epoll_descr, pc]() {
+            _logger->debug("Connection on descriptor {} timed out", pc->_socket);
+            if (epoll_ctl(epoll_descr, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
+                _logger->error("Failed to delete connection from epoll");
+            }
+            close(pc->_socket);
+            _slab.Destroy(pc);
+        };
 
         // Register connection in worker's epoll
         pc->Start();
         if (pc->isAlive()) {
             if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
                 pc->OnError();
-                delete pc;
+                close(pc->_socket);
+                _slab.Destroy(pc);
+            } else {
+                pc->Watch(_timers, idle_timeout, read_timeout);
             }
         }
     }
@@ -6,6 +6,10 @@
 
 #include <afina/network/Server.h>
 
+#include "network/BufferPool.h"
+#include "network/Slab.h"
+#include "network/TimerWheel.h"
+
 namespace spdlog {
 class logger;
 }
@@ -14,8 +18,8 @@ namespace Afina {
 namespace Network {
 namespace STnonblock {
 
-// Forward declaration, see Worker.h
-class Worker;
+// Forward declaration, see Connection.h
+class Connection;
 
 /**
  * # Network resource manager implementation
@@ -37,7 +41,7 @@ public:
 
 protected:
     void OnRun();
-    void OnNewConnection(int);
+    void OnNewConnection(int epoll_descr, int listener);
 
 private:
     // logger to use
@@ -51,11 +55,20 @@ private:
     // Socket to accept new connection on, shared between acceptors
     int _server_socket;
 
+    // Unix domain socket listener, -1 if there is none
+    int _unix_socket;
+
     // Curstom event "device" used to wakeup workers
     int _event_fd;
 
     // IO thread
     std::thread _work_thread;
+
+    // Connections, buffers they read into and their timers, accessed by IO thread only. Connections still
+    // open at shutdown stay in the slab, so the wheel must go first
+    Slab<Connection> _slab;
+    BufferPool _buffers;
+    TimerWheel _timers;
 };
 
 } // namespace STnonblock
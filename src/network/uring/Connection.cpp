@@ -0,0 +1,67 @@
+#include "Connection.h"
+
+#include <stdexcept>
+
+#include <spdlog/logger.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+constexpr std::size_t Connection::kMaxLinkedSends;
+constexpr std::size_t Connection::kMaxIovecs;
+
+// See Connection.h
+Connection::Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl,
+                       const ConnectionLimits &limits, std::size_t argument_reserve)
+    : _socket(s), _logger(pl), _eof(false), _closing(false), _recv_armed(false), _recv_cancelled(false),
+      _throttled(false), _sends_inflight(0), _sent(0), _send_failed(false),
+      _pipeline(ps, pl, limits, argument_reserve), _iov(kMaxLinkedSends * kMaxIovecs), _msgs(kMaxLinkedSends) {}
+
+// See Connection.h
+Connection::~Connection() {}
+
+// See Connection.h
+void Connection::OnData(const char *data, std::size_t size) {
+    if (_tail.empty()) {
+        std::size_t offset = Process(data, size);
+        _tail.assign(data + offset, size - offset);
+    } else {
+        _tail.append(data, size);
+        std::size_t offset = Process(_tail.data(), _tail.size());
+        _tail.erase(0, offset);
+    }
+}
+
+// See Connection.h
+void Connection::OnDrain() {
+    if (!_throttled || !_pipeline.Drained()) {
+        return;
+    }
+    _logger->debug("Output is down to {} bytes, resume reading", _pipeline.Output().Size());
+    _throttled = false;
+    std::size_t offset = Process(_tail.data(), _tail.size());
+    _tail.erase(0, offset);
+}
+
+// See Connection.h
+std::size_t Connection::Process(const char *data, std::size_t size) {
+    if (_throttled) {
+        return 0;
+    }
+
+    try {
+        std::size_t offset = _pipeline.Process(data, size);
+        _throttled = _pipeline.Full();
+        return offset;
+    } catch (std::runtime_error &ex) {
+        // Nothing after the refused command can be trusted, just send what is queued already and close
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+        _eof = true;
+        return size;
+    }
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
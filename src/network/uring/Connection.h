@@ -0,0 +1,112 @@
+#ifndef AFINA_NETWORK_URING_CONNECTION_H
+#define AFINA_NETWORK_URING_CONNECTION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <afina/network/Server.h>
+
+#include "network/Pipeline.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+namespace Uring {
+
+/**
+ * # Client connection served by io_uring worker
+ * Connection doesn't do any IO by itself: worker feeds it with data received into provided buffers and
+ * sends whatever is queued in the output. Connection object must outlive all requests submitted for it,
+ * so it keeps track of them.
+ *
+ * Once output hits the high mark connection is throttled: worker cancels recv, data received by then is kept
+ * unparsed, and recv is armed again once output drains to the low mark
+ */
+class Connection {
+public:
+    /**
+     * Maximum number of linked sendmsg requests submitted at once
+     */
+    static constexpr std::size_t kMaxLinkedSends = 4;
+
+    /**
+     * Linux IOV_MAX, kernel refuses longer vectors in a single sendmsg
+     */
+    static constexpr std::size_t kMaxIovecs = 1024;
+
+    /**
+     * @param argument_reserve argument buffer capacity kept between commands, bigger one is freed
+     */
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl,
+               const ConnectionLimits &limits, std::size_t argument_reserve);
+    ~Connection();
+
+    /**
+     * Parses commands out of the received data, executes them and queues responses into the output.
+     * Unparsed tail is kept till next call, so data buffer could be reused once method returns
+     */
+    void OnData(const char *data, std::size_t size);
+
+    /**
+     * Part of output has been sent, throttled connection goes on with the data kept once output is down to
+     * the low mark
+     */
+    void OnDrain();
+
+private:
+    friend class Worker;
+
+    // Runs commands found in the data unless throttled, returns number of bytes consumed
+    std::size_t Process(const char *data, std::size_t size);
+
+    int _socket;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Client has closed its side of the socket or sent garbage, no more commands will be read
+    bool _eof;
+
+    // Connection is being closed, wait for all requests to complete
+    bool _closing;
+
+    // Multishot recv is in flight, and it is being cancelled
+    bool _recv_armed;
+    bool _recv_cancelled;
+
+    // Output has hit the high mark and hasn't drained to the low one yet
+    bool _throttled;
+
+    // Number of sendmsg requests in flight, bytes they have sent so far and whether any failed
+    std::size_t _sends_inflight;
+    std::size_t _sent;
+    bool _send_failed;
+
+    // Bytes received but not parsed yet
+    std::string _tail;
+
+    // Commands read so far and responses for them. Responses in flight stay in the head of output queue until
+    // completion
+    Pipeline _pipeline;
+
+    // Descriptors of in flight sends, kernel reads them asynchronously
+    std::vector<struct iovec> _iov;
+    std::vector<struct msghdr> _msgs;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_CONNECTION_H
@@ -0,0 +1,206 @@
+#include "Ring.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+static int io_uring_setup(unsigned entries, struct io_uring_params *p) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static int io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+// See Ring.h
+Ring::Ring(unsigned entries) : _sqes(nullptr), _sqe_tail(0) {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    _fd = io_uring_setup(entries, &params);
+    if (_fd < 0) {
+        throw std::runtime_error("Failed to setup io_uring: " + std::string(strerror(errno)));
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        close(_fd);
+        throw std::runtime_error("Kernel io_uring is too old");
+    }
+
+    // Both queues live in the single mapping
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    std::size_t cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (cq_ring_size > _sq_ring_size) {
+        _sq_ring_size = cq_ring_size;
+    }
+
+    _sq_ring = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_sq_ring == MAP_FAILED) {
+        close(_fd);
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+
+    _sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        munmap(_sq_ring, _sq_ring_size);
+        close(_fd);
+        throw std::runtime_error("Failed to map io_uring entries: " + std::string(strerror(errno)));
+    }
+    _sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(_sq_ring);
+    _sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    _sq_entries = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_entries);
+    _sqe_tail = *_sq_tail;
+
+    // Entries are always submitted in order, so index array is identity
+    unsigned *array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    for (unsigned i = 0; i < _sq_entries; i++) {
+        array[i] = i;
+    }
+
+    char *cq = static_cast<char *>(_sq_ring);
+    _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+// See Ring.h
+Ring::~Ring() {
+    munmap(_sqes, _sqes_size);
+    munmap(_sq_ring, _sq_ring_size);
+    close(_fd);
+}
+
+// See Ring.h
+struct io_uring_sqe *Ring::GetSqe() {
+    unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+    if (_sqe_tail - head >= _sq_entries) {
+        return nullptr;
+    }
+
+    struct io_uring_sqe *sqe = &_sqes[_sqe_tail & _sq_mask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    _sqe_tail++;
+    return sqe;
+}
+
+// See Ring.h
+unsigned Ring::SpaceLeft() const { return _sq_entries - (_sqe_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE)); }
+
+// See Ring.h
+unsigned Ring::Submit(unsigned wait_nr) {
+    // Entries must be written before kernel sees new tail
+    __atomic_store_n(_sq_tail, _sqe_tail, __ATOMIC_RELEASE);
+
+    // Count everything kernel hasn't consumed yet, including leftovers of interrupted call
+    unsigned to_submit = _sqe_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+
+    if (to_submit == 0 && wait_nr == 0) {
+        return 0;
+    }
+
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int ret = io_uring_enter(_fd, to_submit, wait_nr, flags);
+    if (ret >= 0) {
+        return ret;
+    }
+
+    // Completion queue is full (EBUSY) or kernel is short of memory (EAGAIN): retrying right away makes no
+    // progress, caller must reap completions first. Interrupted call might have consumed some entries, the rest
+    // goes with the next call
+    if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        throw std::runtime_error("Failed to submit io_uring entries: " + std::string(strerror(errno)));
+    }
+    return to_submit - (_sqe_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE));
+}
+
+// See Ring.h
+struct io_uring_cqe *Ring::PeekCqe() {
+    unsigned head = *_cq_head;
+    if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+    }
+    return &_cqes[head & _cq_mask];
+}
+
+// See Ring.h
+void Ring::SeenCqe() { __atomic_store_n(_cq_head, *_cq_head + 1, __ATOMIC_RELEASE); }
+
+// See Ring.h
+void Ring::RegisterBufferRing(void *ring, unsigned entries, uint16_t group) {
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = entries;
+    reg.bgid = group;
+    if (io_uring_register(_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        throw std::runtime_error("Failed to register provided buffers: " + std::string(strerror(errno)));
+    }
+}
+
+// See Ring.h
+BufferRing::BufferRing(Ring &ring, uint16_t group, unsigned entries, std::size_t size)
+    : _group(group), _entries(entries), _size(size) {
+    // Kernel requires ring to be page aligned
+    _ring_size = entries * sizeof(struct io_uring_buf);
+    void *mem = mmap(nullptr, _ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        throw std::runtime_error("Failed to allocate buffers ring: " + std::string(strerror(errno)));
+    }
+    _ring = static_cast<struct io_uring_buf_ring *>(mem);
+    _buffers = new char[entries * size];
+
+    try {
+        ring.RegisterBufferRing(_ring, entries, group);
+    } catch (...) {
+        delete[] _buffers;
+        munmap(_ring, _ring_size);
+        throw;
+    }
+
+    for (unsigned bid = 0; bid < entries; bid++) {
+        Recycle(bid);
+    }
+}
+
+// See Ring.h
+BufferRing::~BufferRing() {
+    // Ring is unregistered along with io_uring instance
+    delete[] _buffers;
+    munmap(_ring, _ring_size);
+}
+
+// See Ring.h
+void BufferRing::Recycle(uint16_t bid) {
+    // Ring is an array of descriptors with tail overlaid on the first one, bufs member is not used as
+    // C++ puts it at non-zero offset
+    unsigned short tail = _ring->tail;
+    struct io_uring_buf *buf = reinterpret_cast<struct io_uring_buf *>(_ring) + (tail & (_entries - 1));
+    buf->addr = reinterpret_cast<uint64_t>(Buffer(bid));
+    buf->len = _size;
+    buf->bid = bid;
+
+    // Descriptor must be written before kernel sees new tail
+    __atomic_store_n(&_ring->tail, static_cast<unsigned short>(tail + 1), __ATOMIC_RELEASE);
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,138 @@
+#ifndef AFINA_NETWORK_URING_RING_H
+#define AFINA_NETWORK_URING_RING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * # io_uring instance
+ * Minimal wrapper over raw io_uring syscalls: maps submission and completion queues and gives access
+ * to them. Not threadsafe, ring is owned by a single thread
+ */
+class Ring {
+public:
+    /**
+     * Creates ring, throws std::runtime_error if kernel doesn't support io_uring
+     *
+     * @param entries submission queue size, power of two
+     */
+    explicit Ring(unsigned entries);
+    ~Ring();
+
+    inline int fd() const { return _fd; }
+
+    /**
+     * Returns next free submission entry zeroed out, nullptr if queue is full and must be submitted first
+     */
+    struct io_uring_sqe *GetSqe();
+
+    /**
+     * Number of submission entries could be taken by GetSqe without submitting
+     */
+    unsigned SpaceLeft() const;
+
+    /**
+     * Submits all entries prepared since the last call and waits until at least wait_nr completions are
+     * available. Returns number of entries submitted, throws std::runtime_error in case of error.
+     *
+     * Returns early, without waiting and possibly without submitting everything, if the call is interrupted or
+     * the completion queue is full: caller is expected to reap completions and call again
+     */
+    unsigned Submit(unsigned wait_nr = 0);
+
+    /**
+     * Returns oldest completion not seen yet, nullptr if there is no one
+     */
+    struct io_uring_cqe *PeekCqe();
+
+    /**
+     * Marks completion returned by PeekCqe as processed, so kernel could reuse the slot
+     */
+    void SeenCqe();
+
+    /**
+     * Registers memory of provided buffers ring under the given group id, see BufferRing
+     */
+    void RegisterBufferRing(void *ring, unsigned entries, uint16_t group);
+
+private:
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    int _fd;
+
+    // Mapped rings, both queues share single mapping
+    void *_sq_ring;
+    std::size_t _sq_ring_size;
+    struct io_uring_sqe *_sqes;
+    std::size_t _sqes_size;
+
+    // Submission queue shared with kernel
+    unsigned *_sq_head;
+    unsigned *_sq_tail;
+    unsigned _sq_mask;
+    unsigned _sq_entries;
+
+    // Entries handed out by GetSqe but not submitted yet
+    unsigned _sqe_tail;
+
+    // Completion queue shared with kernel
+    unsigned *_cq_head;
+    unsigned *_cq_tail;
+    unsigned _cq_mask;
+    struct io_uring_cqe *_cqes;
+};
+
+/**
+ * # Provided buffers ring
+ * Set of equally sized buffers kernel picks from on its own when data arrives for recv requested with
+ * IOSQE_BUFFER_SELECT. Buffer id is reported in completion flags, buffer must be given back with
+ * Recycle once data is consumed
+ */
+class BufferRing {
+public:
+    /**
+     * @param ring to register buffers in
+     * @param group buffer group id to refer buffers by
+     * @param entries number of buffers, power of two
+     * @param size of each buffer
+     */
+    BufferRing(Ring &ring, uint16_t group, unsigned entries, std::size_t size);
+    ~BufferRing();
+
+    inline uint16_t group() const { return _group; }
+
+    inline char *Buffer(uint16_t bid) { return _buffers + bid * _size; }
+
+    /**
+     * Give buffer back to the kernel
+     */
+    void Recycle(uint16_t bid);
+
+private:
+    BufferRing(const BufferRing &) = delete;
+    BufferRing &operator=(const BufferRing &) = delete;
+
+    uint16_t _group;
+    unsigned _entries;
+    std::size_t _size;
+
+    // Ring of buffer descriptors shared with kernel
+    struct io_uring_buf_ring *_ring;
+    std::size_t _ring_size;
+
+    // Memory all buffers live in
+    char *_buffers;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_RING_H
@@ -0,0 +1,364 @@
+#include "Worker.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+
+#include "Connection.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+constexpr unsigned Worker::kRingEntries;
+constexpr unsigned Worker::kBuffers;
+constexpr std::size_t Worker::kBufferSize;
+
+// Request kind is kept in the lower bits of user_data, the rest is connection pointer
+enum Op : uint64_t { kAccept = 0, kStop = 1, kRecv = 2, kSend = 3, kCancel = 4 };
+static constexpr uint64_t kOpMask = 7;
+
+// Provided buffers group used for recv
+static constexpr uint16_t kBufferGroup = 0;
+
+static inline uint64_t Tag(Connection *pc, Op op) { return reinterpret_cast<uint64_t>(pc) | op; }
+
+// See Worker.h
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl, const ConnectionLimits &limits)
+    : _pStorage(ps), _logger(pl), _limits(limits), _server_socket(-1), _event_fd(-1), _event_value(0),
+      _stopping(false) {}
+
+// See Worker.h
+Worker::~Worker() {
+    if (_thread.joinable()) {
+        Stop();
+        Join();
+    }
+}
+
+// See Worker.h
+void Worker::Start(uint16_t port) {
+    _ring.reset(new Ring(kRingEntries));
+    _buffers.reset(new BufferRing(*_ring, kBufferGroup, kBuffers, kBufferSize));
+
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    // Every worker binds the same port, kernel spreads incoming connections between them
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_KEEPALIVE, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_CLOEXEC);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+    }
+
+    ArmAccept();
+    ArmStop();
+    _thread = std::thread(&Worker::OnRun, this);
+}
+
+// See Worker.h
+void Worker::Stop() {
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
+
+// See Worker.h
+void Worker::Join() {
+    _thread.join();
+
+    // Closing ring cancels all requests in flight, so nobody refers connections and buffers anymore
+    _ring.reset();
+    _buffers.reset();
+
+    for (auto pc : _connections) {
+        close(pc->_socket);
+        delete pc;
+    }
+    _connections.clear();
+
+    close(_server_socket);
+    close(_event_fd);
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    _logger->info("Start uring worker");
+
+    bool run = true;
+    while (run) {
+        // Submit everything prepared on the previous iteration and wait for something to happen. If completion
+        // queue is full it returns right away, reaping below makes room for the next try
+        _ring->Submit(1);
+
+        struct io_uring_cqe *cqe;
+        while ((cqe = _ring->PeekCqe()) != nullptr) {
+            uint64_t user_data = cqe->user_data;
+            int res = cqe->res;
+            unsigned flags = cqe->flags;
+            _ring->SeenCqe();
+
+            Connection *pc = reinterpret_cast<Connection *>(user_data & ~kOpMask);
+            switch (user_data & kOpMask) {
+            case kStop:
+                _logger->debug("Break worker due to stop signal");
+                _stopping = true;
+                run = false;
+                break;
+            case kAccept:
+                OnAccept(res, flags);
+                break;
+            case kRecv:
+                OnRecv(pc, res, flags);
+                break;
+            case kSend:
+                OnSend(pc, res);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    _logger->warn("Worker stopped");
+}
+
+// See Worker.h
+struct io_uring_sqe *Worker::Sqe() {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    if (sqe == nullptr) {
+        _ring->Submit();
+        sqe = _ring->GetSqe();
+    }
+    if (sqe == nullptr) {
+        throw std::runtime_error("io_uring submission queue overflow");
+    }
+    return sqe;
+}
+
+// See Worker.h
+void Worker::ArmAccept() {
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = _server_socket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = Tag(nullptr, kAccept);
+}
+
+// See Worker.h
+void Worker::ArmStop() {
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = _event_fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&_event_value);
+    sqe->len = sizeof(_event_value);
+    sqe->user_data = Tag(nullptr, kStop);
+}
+
+// See Worker.h
+void Worker::ArmRecv(Connection *pc) {
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = pc->_socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = _buffers->group();
+    sqe->user_data = Tag(pc, kRecv);
+    pc->_recv_armed = true;
+    pc->_recv_cancelled = false;
+}
+
+// See Worker.h
+void Worker::CancelRecv(Connection *pc) {
+    if (!pc->_recv_armed || pc->_recv_cancelled) {
+        return;
+    }
+
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = Tag(pc, kRecv);
+    sqe->user_data = Tag(pc, kCancel);
+    pc->_recv_cancelled = true;
+}
+
+// See Worker.h
+void Worker::SubmitSend(Connection *pc) {
+    if (pc->_sends_inflight > 0 || pc->_pipeline.Output().Empty() || pc->_closing) {
+        return;
+    }
+
+    std::size_t iovcnt = pc->_pipeline.Output().Fill(pc->_iov.data(), pc->_iov.size());
+    std::size_t nsends = (iovcnt + Connection::kMaxIovecs - 1) / Connection::kMaxIovecs;
+
+    // Chain must be submitted at once, otherwise kernel breaks the link
+    if (_ring->SpaceLeft() < nsends) {
+        _ring->Submit();
+    }
+
+    for (std::size_t i = 0; i < nsends; i++) {
+        struct msghdr &msg = pc->_msgs[i];
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &pc->_iov[i * Connection::kMaxIovecs];
+        msg.msg_iovlen = std::min(Connection::kMaxIovecs, iovcnt - i * Connection::kMaxIovecs);
+
+        // Linked sends are started strictly one after another, so responses keep their order
+        struct io_uring_sqe *sqe = Sqe();
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = pc->_socket;
+        sqe->addr = reinterpret_cast<uint64_t>(&msg);
+        sqe->len = 1;
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        sqe->flags = (i + 1 < nsends) ? IOSQE_IO_LINK : 0;
+        sqe->user_data = Tag(pc, kSend);
+    }
+
+    pc->_sends_inflight = nsends;
+    pc->_sent = 0;
+    pc->_send_failed = false;
+}
+
+// See Worker.h
+void Worker::OnAccept(int res, unsigned flags) {
+    if (!(flags & IORING_CQE_F_MORE) && !_stopping) {
+        ArmAccept();
+    }
+
+    if (res < 0) {
+        _logger->error("Failed to accept socket: {}", strerror(-res));
+        return;
+    }
+
+    _logger->debug("Accepted connection on descriptor {}", res);
+    Connection *pc = new (std::nothrow) Connection(res, _pStorage, _logger, _limits, kBufferSize);
+    if (pc == nullptr) {
+        throw std::runtime_error("Failed to allocate connection");
+    }
+
+    _connections.insert(pc);
+    ArmRecv(pc);
+}
+
+// See Worker.h
+void Worker::OnRecv(Connection *pc, int res, unsigned flags) {
+    if (!(flags & IORING_CQE_F_MORE)) {
+        pc->_recv_armed = false;
+    }
+
+    if (res > 0) {
+        uint16_t bid = flags >> IORING_CQE_BUFFER_SHIFT;
+        if (!pc->_eof) {
+            pc->OnData(_buffers->Buffer(bid), res);
+        }
+        _buffers->Recycle(bid);
+    } else if (res == 0) {
+        _logger->debug("Connection closed by peer");
+        pc->_eof = true;
+    } else if (res != -ENOBUFS && res != -ECANCELED) {
+        // ENOBUFS means all provided buffers are busy, just try again once recv is rearmed
+        _logger->error("Failed to receive from descriptor {}: {}", pc->_socket, strerror(-res));
+        pc->_eof = true;
+    }
+
+    // Client is that far behind, whatever arrives till recv is cancelled waits along with the rest
+    if (pc->_throttled) {
+        _logger->debug("Output is over {} bytes, stop reading", _limits.output_high);
+        CancelRecv(pc);
+    } else if (!pc->_recv_armed && !pc->_eof && !pc->_closing) {
+        ArmRecv(pc);
+    }
+
+    SubmitSend(pc);
+    Finish(pc);
+}
+
+// See Worker.h
+void Worker::OnSend(Connection *pc, int res) {
+    pc->_sends_inflight--;
+    if (res > 0) {
+        pc->_sent += res;
+    } else if (res < 0 && res != -ECANCELED) {
+        _logger->error("Failed to send response on descriptor {}: {}", pc->_socket, strerror(-res));
+        pc->_send_failed = true;
+    }
+
+    if (pc->_sends_inflight > 0) {
+        return;
+    }
+
+    // Short send cancels the rest of the chain, unsent data simply stays in the queue
+    pc->_pipeline.Output().Consume(pc->_sent);
+    if (pc->_send_failed) {
+        Close(pc);
+    } else {
+        // Client has caught up, recv cancelled on throttling is armed again unless its final completion is
+        // still to come
+        pc->OnDrain();
+        if (!pc->_throttled && !pc->_recv_armed && !pc->_eof && !pc->_closing) {
+            ArmRecv(pc);
+        }
+        SubmitSend(pc);
+    }
+    Finish(pc);
+}
+
+// See Worker.h
+void Worker::Finish(Connection *pc) {
+    if (pc->_eof && pc->_pipeline.Output().Empty() && pc->_sends_inflight == 0) {
+        Close(pc);
+    }
+
+    if (pc->_closing && !pc->_recv_armed && pc->_sends_inflight == 0) {
+        _logger->debug("Close connection on descriptor {}", pc->_socket);
+        _connections.erase(pc);
+        close(pc->_socket);
+        delete pc;
+    }
+}
+
+// See Worker.h
+void Worker::Close(Connection *pc) {
+    if (pc->_closing) {
+        return;
+    }
+    pc->_closing = true;
+    CancelRecv(pc);
+    shutdown(pc->_socket, SHUT_RDWR);
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,132 @@
+#ifndef AFINA_NETWORK_URING_WORKER_H
+#define AFINA_NETWORK_URING_WORKER_H
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+
+#include <afina/network/Server.h>
+
+#include "Ring.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+namespace Uring {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+/**
+ * # Thread driving its own io_uring
+ * Worker owns listening socket bound with SO_REUSEPORT, io_uring instance and provided buffers ring.
+ * Connections are accepted by a single multishot accept, data arrives through multishot recv into
+ * provided buffers and responses go out as a chain of linked sendmsg requests, so steady state costs
+ * single io_uring_enter per loop iteration for all connections of the worker
+ */
+class Worker {
+public:
+    /**
+     * Number of submission queue entries
+     */
+    static constexpr unsigned kRingEntries = 256;
+
+    /**
+     * Number and size of provided buffers for recv
+     */
+    static constexpr unsigned kBuffers = 256;
+    static constexpr std::size_t kBufferSize = 4096;
+
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl, const ConnectionLimits &limits);
+    ~Worker();
+
+    /**
+     * Opens listening socket on the given port, sets up io_uring and spawns background thread serving it.
+     * Throws std::runtime_error if either couldn't be set up
+     */
+    void Start(uint16_t port);
+
+    /**
+     * Signal background thread to stop
+     */
+    void Stop();
+
+    /**
+     * Blocks calling thread until background one is stopped, then releases all resources
+     */
+    void Join();
+
+protected:
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+
+private:
+    Worker(const Worker &) = delete;
+    Worker &operator=(const Worker &) = delete;
+
+    // Returns free submission entry, submits queued ones if ring is full
+    struct io_uring_sqe *Sqe();
+
+    void ArmAccept();
+    void ArmStop();
+    void ArmRecv(Connection *pc);
+
+    // Terminates multishot recv, its final completion comes without IORING_CQE_F_MORE
+    void CancelRecv(Connection *pc);
+
+    // Submits linked sends for all queued responses unless sends are in flight already
+    void SubmitSend(Connection *pc);
+
+    void OnAccept(int res, unsigned flags);
+    void OnRecv(Connection *pc, int res, unsigned flags);
+    void OnSend(Connection *pc, int res);
+
+    // Closes connection if it has nothing more to do and deletes it once no requests refer it
+    void Finish(Connection *pc);
+    void Close(Connection *pc);
+
+    // afina services
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Buffering limits of connections
+    const ConnectionLimits _limits;
+
+    // Socket to accept new connection on, private for this worker
+    int _server_socket;
+
+    // Event "device" used to wakeup worker and value read from it
+    int _event_fd;
+    uint64_t _event_value;
+
+    // Ring must be destroyed before buffers kernel might still write to
+    std::unique_ptr<Ring> _ring;
+    std::unique_ptr<BufferRing> _buffers;
+
+    // Worker is going to stop, don't rearm accept
+    bool _stopping;
+
+    // Connections owned by the worker, accessed by its thread only
+    std::set<Connection *> _connections;
+
+    // Thread serving requests in this worker
+    std::thread _thread;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_WORKER_H
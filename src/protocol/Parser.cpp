@@ -8,13 +8,44 @@
 #include <afina/execute/Append.h>
 #include <afina/execute/Command.h>
 #include <afina/execute/Delete.h>
+#include <afina/execute/Gat.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/MetaDelete.h>
+#include <afina/execute/MetaGet.h>
+#include <afina/execute/MetaNoop.h>
+#include <afina/execute/MetaSet.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
 
 namespace Afina {
 namespace Protocol {
 
+// Parses decimal number out of the command argument, throws std::runtime_error if token isn't a number
+// or doesn't fit into [min, max]
+static int64_t ParseNumber(const std::string &token, int64_t min, int64_t max) {
+    bool negative = !token.empty() && token[0] == '-';
+    if (token.size() == size_t(negative) || token.size() > 19) {
+        throw std::runtime_error("Invalid number: " + token);
+    }
+
+    int64_t result = 0;
+    for (size_t i = negative; i < token.size(); i++) {
+        if (token[i] < '0' || token[i] > '9') {
+            throw std::runtime_error("Invalid number: " + token);
+        }
+        result = result * 10 + (token[i] - '0');
+    }
+    if (negative) {
+        result = -result;
+    }
+
+    if (result < min || result > max) {
+        throw std::runtime_error("Number out of range: " + token);
+    }
+    return result;
+}
+
 // See Parse.h
 bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
     size_t pos;
@@ -35,6 +66,14 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 } else if (name == "stats") {
                     state = State::sLF;
                     continue;
+                } else if (name == "mg" || name == "ms" || name == "md" || name == "touch" || name == "gat" ||
+                           name == "gats") {
+                    if (c == '\r') {
+                        throw std::runtime_error("Client provides no key for " + name);
+                    }
+                    state = State::sArgs;
+                } else if (name == "mn") {
+                    state = (c == '\r') ? State::sLF : State::sArgs;
                 } else {
                     throw std::runtime_error("Unknown command name: " + name);
                 }
@@ -77,6 +116,22 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
             break;
         }
 
+        case State::sArgs: {
+            if (c == '\r' || c == ' ') {
+                // Tokens might be separated by several spaces
+                if (!curKey.empty()) {
+                    keys.push_back(curKey);
+                    curKey.clear();
+                }
+                if (c == '\r') {
+                    state = State::sLF;
+                }
+            } else {
+                curKey.push_back(c);
+            }
+            break;
+        }
+
         case State::spFlags: {
             if (c == ' ') {
                 negative = false;
@@ -109,19 +164,11 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 state = State::spBytes;
                 // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
-                int32_t et = exprtime;
-                if (negative) {
-                    et -= (c - '0');
-                    if (et > exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
-                } else {
-                    et += (c - '0');
-                    if (et < exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
+                int64_t et = int64_t(exprtime) * 10 + (negative ? -(c - '0') : (c - '0'));
+                if (et > INT32_MAX || et < INT32_MIN) {
+                    throw std::runtime_error("Expire time field overflow");
                 }
-                exprtime = et;
+                exprtime = int32_t(et);
             }
             break;
         }
@@ -178,6 +225,42 @@ std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
         return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
     } else if (name == "stats") {
         return std::unique_ptr<Execute::Command>(new Execute::Stats());
+    } else if (name == "mn") {
+        return std::unique_ptr<Execute::Command>(new Execute::MetaNoop());
+    } else if (name == "touch") {
+        if (keys.size() != 2) {
+            throw std::runtime_error("touch requires key and exptime");
+        }
+        int32_t exptime = ParseNumber(keys[1], INT32_MIN, INT32_MAX);
+        return std::unique_ptr<Execute::Command>(new Execute::Touch(keys[0], exptime));
+    } else if (name == "gat" || name == "gats") {
+        if (keys.size() < 2) {
+            throw std::runtime_error("Client provides no key to retrive");
+        }
+        int32_t exptime = ParseNumber(keys[0], INT32_MIN, INT32_MAX);
+        std::vector<std::string> gat_keys(keys.begin() + 1, keys.end());
+        return std::unique_ptr<Execute::Command>(new Execute::Gat(exptime, gat_keys));
+    }
+
+    // Meta commands: key followed by flags, ms has data length in between
+    if (keys.empty()) {
+        throw std::runtime_error("Client provides no key for " + name);
+    }
+    std::vector<std::string> meta_flags(keys.begin() + 1, keys.end());
+    if (name == "mg") {
+        return std::unique_ptr<Execute::Command>(new Execute::MetaGet(keys[0], meta_flags));
+    } else if (name == "md") {
+        return std::unique_ptr<Execute::Command>(new Execute::MetaDelete(keys[0], meta_flags));
+    } else if (name == "ms") {
+        if (meta_flags.empty()) {
+            throw std::runtime_error("Client provides no data length for ms");
+        }
+
+        size_t datalen = ParseNumber(meta_flags[0], 0, UINT32_MAX);
+        meta_flags.erase(meta_flags.begin());
+        std::unique_ptr<Execute::Command> result(new Execute::MetaSet(keys[0], meta_flags));
+        body_size = datalen;
+        return result;
     } else {
         throw std::runtime_error("Unsupported command");
     }
@@ -53,6 +53,11 @@ public:
      */
     void Reset();
 
+    /**
+     * Some part of the command has been parsed already
+     */
+    inline bool Started() const { return state != State::sName || !name.empty(); }
+
     inline const std::string &Name() const { return name; }
 
 private:
@@ -61,8 +66,9 @@ private:
      * - s: state for PUT and GET commands
      * - sp: for PUT commands only
      * - sg: for GET commands only
+     * - sArgs: for meta, touch and gat commands, collects arguments as space separated tokens
      */
-    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey };
+    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey, sArgs };
 
     // Current parser state
     State state;
@@ -8,21 +8,28 @@ namespace Backend {
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Put(const std::string &key, const std::string &value)
 {
-    if (key.size() + value.size() > _max_size)
+    return SimpleLRU::Put(key, value, 0, 0);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Put(const std::string &key, const std::string &value, uint32_t flags, time_t expire)
+{
+    const StoredValue item = Render(key, value, flags, expire);
+    if (ItemSize(key, item) > _max_size)
     {
         return false;
     }
     else
     {
-        const lru_map::iterator iter = _lru_index.find(key);
+        const lru_map::iterator iter = Lookup(key);
 
         if (iter != _lru_index.end())//found in index
         {
-            Update(iter,value);
+            Update(iter,item);
         }
         else//not found in index
         {
-            Insert(key,value);
+            Insert(key,item);
         }
         return true;
     }
@@ -31,9 +38,21 @@ bool SimpleLRU::Put(const std::string &key, const std::string &value)
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value)
 {
-    if ((key.size() + value.size() <= _max_size) && (_lru_index.find(key) == _lru_index.end()))
+    return SimpleLRU::PutIfAbsent(key, value, 0, 0);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, time_t expire)
+{
+    if (Lookup(key) != _lru_index.end())
     {
-        Insert(key,value);
+        return false;
+    }
+
+    const StoredValue item = Render(key, value, flags, expire);
+    if (ItemSize(key, item) <= _max_size)
+    {
+        Insert(key,item);
         return true;
     }
     else
@@ -45,10 +64,22 @@ bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value)
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Set(const std::string &key, const std::string &value)
 {
-    const lru_map::iterator iter = _lru_index.find(key);
-    if ((iter != _lru_index.end()) && (key.size() + value.size() <= _max_size))
+    return SimpleLRU::Set(key, value, 0, 0);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Set(const std::string &key, const std::string &value, uint32_t flags, time_t expire)
+{
+    const lru_map::iterator iter = Lookup(key);
+    if (iter == _lru_index.end())
     {
-        Update(iter,value);
+        return false;
+    }
+
+    const StoredValue item = Render(key, value, flags, expire);
+    if (ItemSize(key, item) <= _max_size)
+    {
+        Update(iter,item);
         return true;
     }
     else
@@ -60,7 +91,7 @@ bool SimpleLRU::Set(const std::string &key, const std::string &value)
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Delete(const std::string &key)
 {
-    const lru_map::iterator iter = _lru_index.find(key);
+    const lru_map::iterator iter = Lookup(key);
     if (iter != _lru_index.end())
     {
         Remove(iter);
@@ -75,11 +106,53 @@ bool SimpleLRU::Delete(const std::string &key)
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Get(const std::string &key, std::string &value)
 {
-    const lru_map::iterator iter = _lru_index.find(key);
+    const lru_map::iterator iter = Lookup(key);
+    if (iter != _lru_index.end())
+    {
+        const StoredValue& item = iter->second.get().value;
+        value.assign(item.data(), item.size);
+        Rebase(iter);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Get(const std::string &key, StoredValue &value)
+{
+    const lru_map::iterator iter = Lookup(key);
     if (iter != _lru_index.end())
     {
         value = iter->second.get().value;
-        Rebase(iter,value);
+        Rebase(iter);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Touch(const std::string &key, time_t expire)
+{
+    StoredValue value;
+    return SimpleLRU::GetAndTouch(key, expire, value);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::GetAndTouch(const std::string &key, time_t expire, StoredValue &value)
+{
+    const lru_map::iterator iter = Lookup(key);
+    if (iter != _lru_index.end())
+    {
+        //expiration time is metadata only, buffer stays shared with readers
+        iter->second.get().value.expire = expire;
+        value = iter->second.get().value;
+        Rebase(iter);
         return true;
     }
     else
@@ -92,16 +165,64 @@ bool SimpleLRU::Get(const std::string &key, std::string &value)
 //=========================================================================================================================\\
 
 
-void SimpleLRU::Insert(const std::string& key, const std::string& value)
+SimpleLRU::lru_map::iterator SimpleLRU::Lookup(const std::string& key)
+{
+    lru_map::iterator iter = _lru_index.find(key);
+    if (iter != _lru_index.end())
+    {
+        const time_t expire = iter->second.get().value.expire;
+        if (expire != 0 && expire <= time(nullptr))
+        {
+            Remove(iter);
+            return _lru_index.end();
+        }
+    }
+    return iter;
+}
+
+StoredValue SimpleLRU::Render(const std::string& key, const std::string& value, uint32_t flags, time_t expire) const
+{
+    StoredValue result;
+    result.size = value.size();
+    result.flags = flags;
+    result.expire = expire;
+    result.rendered = _render_headers;
+    if (!_render_headers)
+    {
+        result.buffer = std::make_shared<const std::string>(value);
+        return result;
+    }
+
+    const std::string flags_str = std::to_string(flags);
+    const std::string bytes_str = std::to_string(value.size());
+
+    std::string buffer;
+    buffer.reserve(6 + key.size() + 1 + flags_str.size() + 1 + bytes_str.size() + 2 + value.size() + 2);
+    buffer.append("VALUE ", 6);
+    buffer.append(key);
+    buffer.push_back(' ');
+    buffer.append(flags_str);
+    buffer.push_back(' ');
+    buffer.append(bytes_str);
+    buffer.append("\r\n", 2);
+    result.offset = buffer.size();
+    buffer.append(value);
+    buffer.append("\r\n", 2);
+
+    result.buffer = std::make_shared<const std::string>(std::move(buffer));
+    return result;
+}
+
+void SimpleLRU::Insert(const std::string& key, const StoredValue& value)
 {
 
-    while(_cur_size + value.size() + key.size()  > _max_size)
+    while(_cur_size + ItemSize(key, value) > _max_size)
     {
         const lru_map::iterator rem_index_iter = _lru_index.find(_lru_head.get()->key);
         Remove(rem_index_iter);
     }
 
-    _cur_size += key.size() + value.size();
+    _cur_size += ItemSize(key, value);
     lru_node* _lru_new_node = new lru_node(key,value);
 
     //rebasing
@@ -123,9 +244,10 @@ void SimpleLRU::Insert(const std::string& key, const std::string& value)
     _lru_index.insert(std::make_pair(std::reference_wrapper<const std::string>(_lru_tail->key),std::reference_wrapper<lru_node>(*_lru_tail)));
 }
 
-void SimpleLRU::Update(const lru_map::iterator& upd_elem_iter, const std::string& new_value)
+void SimpleLRU::Update(const lru_map::iterator& upd_elem_iter, const StoredValue& new_value)
 {
-    while(_cur_size + (new_value.size() - upd_elem_iter->second.get().value.size())  > _max_size)
+    const std::string& key = upd_elem_iter->second.get().key;
+    while(_cur_size + ItemSize(key, new_value) - ItemSize(key, upd_elem_iter->second.get().value) > _max_size)
     {
         lru_map::iterator rem_index_iter = _lru_index.find(_lru_head.get()->key);
         if (upd_elem_iter != rem_index_iter)//skipping element which we want to update
@@ -139,19 +261,19 @@ void SimpleLRU::Update(const lru_map::iterator& upd_elem_iter, const std::string
     }
 
     //because of size_t
-    _cur_size += new_value.size();
-    _cur_size -= upd_elem_iter->second.get().value.size();
+    _cur_size += ItemSize(key, new_value);
+    _cur_size -= ItemSize(key, upd_elem_iter->second.get().value);
 
     //update tree node value, rebase node to tail
-    Rebase(upd_elem_iter,new_value);
+    upd_elem_iter->second.get().value = new_value;
+    Rebase(upd_elem_iter);
 
     //if tail, do nothing (also handles when _lru_tail == _lru_head)
 }
 
-void SimpleLRU::Rebase(const lru_map::iterator& push_map_iter,const std::string& new_value)
+void SimpleLRU::Rebase(const lru_map::iterator& push_map_iter)
 {
     lru_node& upd_node = push_map_iter->second.get();
-    upd_node.value = new_value;
 
     if (&upd_node != _lru_tail)
     {
@@ -175,7 +297,7 @@ void SimpleLRU::Rebase(const lru_map::iterator& push_map_iter,const std::string&
 void SimpleLRU::Remove(const lru_map::iterator& rem_map_iter)
 {
     lru_node& rem_node = rem_map_iter->second.get();//removing node reference
-    _cur_size -= rem_node.key.size() + rem_node.value.size();
+    _cur_size -= ItemSize(rem_node.key, rem_node.value);
     const std::string& rem_key = rem_node.key;
 
     _lru_index.erase(rem_key);
@@ -20,7 +20,13 @@ namespace Backend {
 class SimpleLRU : public Afina::Storage
 {
 public:
-    SimpleLRU(size_t max_size = 1024) : _max_size(max_size), _cur_size(0), _lru_head(nullptr), _lru_tail(nullptr){}
+    /**
+     * @param max_size maximum number of bytes could be stored in the cache
+     * @param render_headers keep memcached "VALUE <key> <flags> <bytes>\r\n" header and trailing "\r\n"
+     * rendered next to each value, so get reply could be sent without formatting anything
+     */
+    SimpleLRU(size_t max_size = 1024, bool render_headers = false)
+        : _max_size(max_size), _render_headers(render_headers), _cur_size(0), _lru_head(nullptr), _lru_tail(nullptr){}
 
     ~SimpleLRU()
     {
@@ -41,26 +47,46 @@ public:
     // Implements Afina::Storage interface
     bool Put(const std::string &key, const std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, time_t expire) override;
+
     // Implements Afina::Storage interface
     bool PutIfAbsent(const std::string &key, const std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, time_t expire) override;
+
     // Implements Afina::Storage interface
     bool Set(const std::string &key, const std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, time_t expire) override;
+
     // Implements Afina::Storage interface
     bool Delete(const std::string &key) override;
 
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, StoredValue &value) override;
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, time_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool GetAndTouch(const std::string &key, time_t expire, StoredValue &value) override;
+
 private:
     // LRU cache nodes
     using lru_node = struct lru_node
     {
-        lru_node(const std::string& key,const std::string& value) : key(key), value(value), prev(nullptr), next(nullptr){}
+        lru_node(const std::string& key,const StoredValue& value) : key(key), value(value), prev(nullptr), next(nullptr){}
 
         const std::string key;
-        std::string value;
+        // Value is immutable once stored, update replaces whole buffer so that readers
+        // still holding old one are not affected
+        StoredValue value;
         lru_node* prev;
         std::unique_ptr<lru_node> next;
     };
@@ -72,6 +98,9 @@ private:
     // i.e all (keys+values) must be less the _max_size
     std::size_t _max_size;
 
+    // Keep get reply header rendered next to each value
+    bool _render_headers;
+
     //Current container size
     std::size_t _cur_size;
 
@@ -87,14 +116,23 @@ private:
     // Index of nodes from list above, allows fast random access to elements by lru_node#key
     lru_map _lru_index;
 
+    //Builds immutable buffer for the value, with get reply header if required
+    StoredValue Render(const std::string& key, const std::string& value, uint32_t flags, time_t expire) const;
+
+    //Finds node for the key, expired node is removed and considered as absent
+    lru_map::iterator Lookup(const std::string& key);
+
+    //Number of bytes item takes from the cache
+    static std::size_t ItemSize(const std::string& key, const StoredValue& value) { return key.size() + value.buffer->size(); }
+
     //Creates and inserts new node in list and adds reference_wrapper to map
-    void Insert(const std::string& key,const std::string& value);
+    void Insert(const std::string& key,const StoredValue& value);
 
     //Updates node in index
-    void Update(const lru_map::iterator& iter, const std::string& value);
+    void Update(const lru_map::iterator& iter, const StoredValue& value);
 
-    //Updates node value and pushes to tail(RLU)
-    void Rebase(const lru_map::iterator& push_map_iter,const std::string& new_value);
+    //Pushes node to tail(RLU)
+    void Rebase(const lru_map::iterator& push_map_iter);
 
     //Removes node associated with map iterator
     void Remove(const lru_map::iterator& rem_map_iter);
@@ -17,41 +17,78 @@ namespace Backend {
  */
 class ThreadSafeSimplLRU : public SimpleLRU {
 public:
-    ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
+    ThreadSafeSimplLRU(size_t max_size = 1024, bool render_headers = false) : SimpleLRU(max_size, render_headers) {}
     ~ThreadSafeSimplLRU() {}
 
     // see SimpleLRU.h
     bool Put(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
+        std::unique_lock<std::mutex> lock(_mutex);
         return SimpleLRU::Put(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, time_t expire) override {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return SimpleLRU::Put(key, value, flags, expire);
+    }
+
     // see SimpleLRU.h
     bool PutIfAbsent(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
+        std::unique_lock<std::mutex> lock(_mutex);
         return SimpleLRU::PutIfAbsent(key, value);
     }
 
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, time_t expire) override {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return SimpleLRU::PutIfAbsent(key, value, flags, expire);
+    }
+
     // see SimpleLRU.h
     bool Set(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
+        std::unique_lock<std::mutex> lock(_mutex);
         return SimpleLRU::Set(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, time_t expire) override {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return SimpleLRU::Set(key, value, flags, expire);
+    }
+
     // see SimpleLRU.h
     bool Delete(const std::string &key) override {
-        // TODO: sinchronization
+        std::unique_lock<std::mutex> lock(_mutex);
         return SimpleLRU::Delete(key);
     }
 
     // see SimpleLRU.h
     bool Get(const std::string &key, std::string &value) override {
-        // TODO: sinchronization
+        std::unique_lock<std::mutex> lock(_mutex);
         return SimpleLRU::Get(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Get(const std::string &key, StoredValue &value) override {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return SimpleLRU::Get(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool Touch(const std::string &key, time_t expire) override {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return SimpleLRU::Touch(key, expire);
+    }
+
+    // see SimpleLRU.h
+    bool GetAndTouch(const std::string &key, time_t expire, StoredValue &value) override {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return SimpleLRU::GetAndTouch(key, expire, value);
+    }
+
 private:
-    // TODO: sinchronization primitives
+    // Global lock protecting whole cache, note that even Get modifies LRU order
+    std::mutex _mutex;
 };
 
 } // namespace Backend
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+
+// Tasks block until released, so that test controls how many of them are running
+struct Gate {
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered++;
+        cv.notify_all();
+        cv.wait(lock, [this]() { return open; });
+    }
+
+    void AwaitEntered(int n) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this, n]() { return entered >= n; });
+    }
+
+    void Open() {
+        std::unique_lock<std::mutex> lock(mutex);
+        open = true;
+        cv.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int entered = 0;
+    bool open = false;
+};
+
+TEST(ExecutorTest, RunAll) {
+    std::atomic<int> counter(0);
+    {
+        Executor executor("test", 2, 4, 1000, std::chrono::milliseconds(100));
+        for (int i = 0; i < 1000; i++) {
+            ASSERT_TRUE(executor.Execute([&counter]() { counter++; }));
+        }
+        executor.Stop(true);
+    }
+    EXPECT_EQ(1000, counter.load());
+}
+
+TEST(ExecutorTest, Watermarks) {
+    Executor executor("test", 1, 3, 2, std::chrono::milliseconds(1000));
+    EXPECT_EQ(1, executor.Threads());
+
+    // Pool grows while there is nobody free to take the task
+    Gate gate;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(executor.Execute([&gate]() { gate.Wait(); }));
+    }
+    gate.AwaitEntered(3);
+    EXPECT_EQ(3, executor.Threads());
+    EXPECT_EQ(3, executor.BusyThreads());
+
+    // Beyond high watermark tasks wait in the queue, and once it is full they get rejected
+    EXPECT_TRUE(executor.Execute([&gate]() { gate.Wait(); }));
+    EXPECT_TRUE(executor.Execute([&gate]() { gate.Wait(); }));
+    EXPECT_FALSE(executor.Execute([&gate]() { gate.Wait(); }));
+    EXPECT_EQ(3, executor.Threads());
+    EXPECT_EQ(2, executor.QueueSize());
+
+    gate.Open();
+    executor.Stop(true);
+    EXPECT_EQ(0, executor.Threads());
+    EXPECT_EQ(5, gate.entered);
+}
+
+TEST(ExecutorTest, Stop) {
+    Executor executor("test", 1, 1, 10, std::chrono::milliseconds(100));
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 5; i++) {
+        executor.Execute([&counter]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            counter++;
+        });
+    }
+
+    // Queued tasks complete, new ones are rejected
+    executor.Stop();
+    EXPECT_FALSE(executor.Execute([&counter]() { counter++; }));
+    executor.Stop(true);
+    EXPECT_EQ(5, counter.load());
+}
+
+TEST(ExecutorTest, IdleTimeout) {
+    Executor executor("test", 1, 4, 0, std::chrono::milliseconds(20));
+    Gate gate;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(executor.Execute([&gate]() { gate.Wait(); }));
+    }
+    gate.AwaitEntered(4);
+    EXPECT_EQ(4, executor.Threads());
+    gate.Open();
+
+    // Spare threads go away, low watermark stays
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (executor.Threads() > 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(1, executor.Threads());
+
+    // And come back once needed
+    std::atomic<int> counter(0);
+    EXPECT_TRUE(executor.Execute([&counter]() { counter++; }));
+    executor.Stop(true);
+    EXPECT_EQ(1, counter.load());
+}
+
+TEST(ExecutorTest, QueueLatency) {
+    Executor executor("test", 1, 1, 10, std::chrono::milliseconds(100));
+    Gate gate;
+    ASSERT_TRUE(executor.Execute([&gate]() { gate.Wait(); }));
+    gate.AwaitEntered(1);
+
+    // Second task waits for the first one to complete
+    ASSERT_TRUE(executor.Execute([]() {}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    gate.Open();
+    executor.Stop(true);
+
+    auto &latency = executor.QueueLatency();
+    EXPECT_EQ(2, latency.Count());
+    EXPECT_GE(latency.Max(), std::chrono::milliseconds(20));
+    EXPECT_GE(latency.Percentile(1.0), std::chrono::milliseconds(15));
+}
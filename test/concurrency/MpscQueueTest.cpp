@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/MpscQueue.h>
+
+using namespace Afina::Concurrency;
+
+TEST(MpscQueueTest, Order) {
+    MpscQueue<int> queue(3);
+    EXPECT_EQ(4, queue.Capacity());
+
+    // Only the first push finds queue empty
+    bool was_empty = false;
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_TRUE(queue.Push(1, was_empty));
+    EXPECT_TRUE(was_empty);
+    EXPECT_TRUE(queue.Push(2, was_empty));
+    EXPECT_FALSE(was_empty);
+    EXPECT_TRUE(queue.Push(3, was_empty));
+    EXPECT_FALSE(was_empty);
+    EXPECT_FALSE(queue.Empty());
+
+    std::vector<int> taken;
+    EXPECT_EQ(3, queue.Consume([&taken](int item) { taken.push_back(item); }));
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), taken);
+
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_EQ(0, queue.Consume([](int) { FAIL(); }));
+    EXPECT_TRUE(queue.Push(4, was_empty));
+    EXPECT_TRUE(was_empty);
+}
+
+TEST(MpscQueueTest, Full) {
+    MpscQueue<int> queue(4);
+    bool was_empty;
+
+    // Cells are reused round after round, full queue refuses items till consumer takes them
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 4; i++) {
+            EXPECT_TRUE(queue.Push(round * 4 + i, was_empty));
+        }
+        EXPECT_FALSE(queue.Push(-1, was_empty));
+
+        std::vector<int> taken;
+        EXPECT_EQ(4, queue.Consume([&taken](int item) { taken.push_back(item); }));
+        EXPECT_EQ(std::vector<int>({round * 4, round * 4 + 1, round * 4 + 2, round * 4 + 3}), taken);
+    }
+}
+
+TEST(MpscQueueTest, Producers) {
+    const int kProducers = 4;
+    const int kItems = 10000;
+
+    // Queue is much smaller than the number of items, so producers keep running into the full one
+    MpscQueue<int> queue(64);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+        producers.emplace_back([&queue, p]() {
+            bool was_empty;
+            for (int i = 0; i < kItems; i++) {
+                while (!queue.Push(p * kItems + i, was_empty)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Items of each producer come out in the order they have been pushed
+    std::vector<int> last(kProducers, -1);
+    int taken = 0;
+    while (taken < kProducers * kItems) {
+        taken += queue.Consume([&last](int item) {
+            int p = item / kItems;
+            EXPECT_LT(last[p], item % kItems);
+            last[p] = item % kItems;
+        });
+    }
+
+    for (auto &t : producers) {
+        t.join();
+    }
+    EXPECT_TRUE(queue.Empty());
+}
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+#include <afina/concurrency/StealingExecutor.h>
+
+using namespace Afina::Concurrency;
+
+// Tasks block until released, so that test controls how many of them are running
+struct Latch {
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        entered++;
+        cv.notify_all();
+        cv.wait(lock, [this]() { return open; });
+    }
+
+    void AwaitEntered(int n) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this, n]() { return entered >= n; });
+    }
+
+    void Open() {
+        std::unique_lock<std::mutex> lock(mutex);
+        open = true;
+        cv.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int entered = 0;
+    bool open = false;
+};
+
+TEST(StealingExecutorTest, RunAll) {
+    std::atomic<int> counter(0);
+    {
+        StealingExecutor executor("test", 4, 1000);
+        EXPECT_EQ(4, executor.Threads());
+        for (int i = 0; i < 1000; i++) {
+            ASSERT_TRUE(executor.Execute([&counter]() { counter++; }));
+        }
+        executor.Stop(true);
+    }
+    EXPECT_EQ(1000, counter.load());
+}
+
+TEST(StealingExecutorTest, Steal) {
+    StealingExecutor executor("test", 2, 1000);
+
+    // Children go to the deque of the parent thread, which is busy waiting for them, so the other one must steal
+    std::atomic<int> counter(0);
+    ASSERT_TRUE(executor.Execute([&executor, &counter]() {
+        for (int i = 0; i < 100; i++) {
+            executor.Execute([&counter]() { counter++; });
+        }
+        while (counter.load() < 100) {
+            std::this_thread::yield();
+        }
+    }));
+
+    // Stopping pool rejects new tasks, posted from the pool threads too
+    while (counter.load() < 100) {
+        std::this_thread::yield();
+    }
+    executor.Stop(true);
+    EXPECT_EQ(100, counter.load());
+    EXPECT_GE(executor.Steals(), 100);
+    EXPECT_EQ(101, executor.QueueLatency().Count());
+}
+
+TEST(StealingExecutorTest, QueueLimit) {
+    StealingExecutor executor("test", 1, 2);
+
+    Latch latch;
+    ASSERT_TRUE(executor.Execute([&latch]() { latch.Wait(); }));
+    latch.AwaitEntered(1);
+
+    // The only thread is busy, tasks wait until the queue is full
+    EXPECT_TRUE(executor.Execute([]() {}));
+    EXPECT_TRUE(executor.Execute([]() {}));
+    EXPECT_FALSE(executor.Execute([]() {}));
+    EXPECT_EQ(2, executor.QueueSize());
+
+    latch.Open();
+    executor.Stop(true);
+    EXPECT_EQ(0, executor.QueueSize());
+}
+
+TEST(StealingExecutorTest, Stop) {
+    std::atomic<int> counter(0);
+    StealingExecutor executor("test", 2, 100);
+
+    Latch latch;
+    ASSERT_TRUE(executor.Execute([&latch]() { latch.Wait(); }));
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(executor.Execute([&counter]() { counter++; }));
+    }
+
+    // Tasks queued before stop are done, new ones are rejected
+    executor.Stop();
+    EXPECT_FALSE(executor.Execute([&counter]() { counter++; }));
+    latch.Open();
+    executor.Stop(true);
+    EXPECT_EQ(10, counter.load());
+}
+
+TEST(StealingExecutorTest, Interface) {
+    for (int stealing = 0; stealing < 2; stealing++) {
+        std::unique_ptr<TaskExecutor> executor;
+        if (stealing) {
+            executor.reset(new StealingExecutor("test", 2, 100));
+        } else {
+            executor.reset(new Executor("test", 2, 2, 100, std::chrono::milliseconds(100)));
+        }
+
+        std::atomic<int> counter(0);
+        for (int i = 0; i < 100; i++) {
+            ASSERT_TRUE(executor->Execute([&counter](int n) { counter += n; }, 2));
+        }
+        executor->Stop(true);
+        EXPECT_EQ(200, counter.load());
+        EXPECT_EQ(100, executor->QueueLatency().Count());
+    }
+}
@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <afina/concurrency/Histogram.h>
+#include <afina/concurrency/Task.h>
+
+using namespace Afina::Concurrency;
+
+static void _append(std::string &out, int value) { out += std::to_string(value); }
+
+TEST(TaskTest, InlineBind) {
+    // Typical task: function with a couple of arguments bound
+    std::string out;
+    Task task(std::bind(&_append, std::ref(out), 42));
+    EXPECT_TRUE(task.Inline());
+
+    Task moved(std::move(task));
+    EXPECT_FALSE(bool(task));
+    moved();
+    EXPECT_EQ("42", out);
+}
+
+TEST(TaskTest, HeapFallback) {
+    std::array<char, 2 * Task::kInlineSize> big;
+    big.fill('x');
+    std::string out;
+    Task task([big, &out]() { out.assign(big.begin(), big.end()); });
+    EXPECT_FALSE(task.Inline());
+
+    Task moved;
+    moved = std::move(task);
+    moved();
+    EXPECT_EQ(big.size(), out.size());
+}
+
+TEST(TaskTest, Destroy) {
+    // Captured state is released exactly once, wherever task ends up
+    auto state = std::make_shared<int>(0);
+    {
+        Task task([state]() { (*state)++; });
+        Task other(std::move(task));
+        other();
+        EXPECT_EQ(2, state.use_count());
+    }
+    EXPECT_EQ(1, state.use_count());
+    EXPECT_EQ(1, *state);
+}
+
+TEST(HistogramTest, Buckets) {
+    // Bucket bounds are continuous and never 25% above the value
+    for (uint64_t v : {0ull, 3ull, 4ull, 7ull, 8ull, 1000ull, 123456789ull, ~0ull}) {
+        std::size_t bucket = Histogram::Bucket(v);
+        EXPECT_GE(Histogram::UpperBound(bucket), v);
+        EXPECT_LE(Histogram::UpperBound(bucket) - v, v / 4);
+        if (bucket > 0) {
+            EXPECT_LT(Histogram::UpperBound(bucket - 1), v);
+        }
+    }
+    EXPECT_EQ(Histogram::kBuckets - 1, Histogram::Bucket(~0ull));
+}
+
+TEST(HistogramTest, Percentile) {
+    Histogram histogram;
+    EXPECT_EQ(0, histogram.Percentile(0.5).count());
+
+    for (int i = 1; i <= 1000; i++) {
+        histogram.Record(std::chrono::microseconds(i));
+    }
+    EXPECT_EQ(1000, histogram.Count());
+    EXPECT_EQ(std::chrono::microseconds(1000), histogram.Max());
+
+    auto p50 = histogram.Percentile(0.5);
+    EXPECT_GE(p50, std::chrono::microseconds(500));
+    EXPECT_LE(p50, std::chrono::microseconds(625));
+    EXPECT_EQ(histogram.Max(), histogram.Percentile(1.0));
+
+    histogram.Reset();
+    EXPECT_EQ(0, histogram.Count());
+}
@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <afina/concurrency/Topology.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+// Fake sysfs tree in a temporary directory
+class Sysfs {
+public:
+    Sysfs() {
+        char path[] = "/tmp/afina-topology-XXXXXX";
+        if (mkdtemp(path) == nullptr) {
+            throw std::runtime_error("Failed to create temporary directory");
+        }
+        root = path;
+    }
+
+    ~Sysfs() {
+        std::string command = "rm -rf " + root;
+        std::system(command.c_str());
+    }
+
+    void Online(const std::string &list) { Write(root + "/online", list); }
+
+    void Cpu(int id, int core, int package, int node) {
+        std::string dir = root + "/cpu" + std::to_string(id);
+        mkdir(dir.c_str(), 0755);
+        mkdir((dir + "/topology").c_str(), 0755);
+        mkdir((dir + "/node" + std::to_string(node)).c_str(), 0755);
+        Write(dir + "/topology/core_id", std::to_string(core));
+        Write(dir + "/topology/physical_package_id", std::to_string(package));
+    }
+
+    std::string root;
+
+private:
+    void Write(const std::string &path, const std::string &value) {
+        std::ofstream out(path);
+        out << value << "\n";
+    }
+};
+
+// Two sockets, each one is a NUMA node of two cores with two hyperthreads, numbered the way x86 kernel does
+void TwoSockets(Sysfs &sysfs) {
+    sysfs.Online("0-7");
+    for (int id = 0; id < 8; id++) {
+        int package = (id / 2) % 2;
+        sysfs.Cpu(id, id % 2, package, package);
+    }
+}
+
+} // namespace
+
+TEST(TopologyTest, Read) {
+    Sysfs sysfs;
+    TwoSockets(sysfs);
+
+    Topology topology = Topology::Read(sysfs.root);
+    ASSERT_EQ(8, topology.Cpus().size());
+    EXPECT_EQ(4, topology.Cores());
+    EXPECT_EQ(2, topology.Nodes());
+
+    const Topology::Cpu &cpu = topology.Cpus()[6];
+    EXPECT_EQ(6, cpu.id);
+    EXPECT_EQ(0, cpu.core);
+    EXPECT_EQ(1, cpu.package);
+    EXPECT_EQ(1, cpu.node);
+}
+
+TEST(TopologyTest, Offline) {
+    Sysfs sysfs;
+    TwoSockets(sysfs);
+    sysfs.Online("0-2,4-5,7");
+
+    Topology topology = Topology::Read(sysfs.root);
+    std::vector<int> ids;
+    for (auto &cpu : topology.Cpus()) {
+        ids.push_back(cpu.id);
+    }
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 4, 5, 7}), ids);
+
+    Sysfs empty;
+    EXPECT_THROW(Topology::Read(empty.root), std::runtime_error);
+}
+
+TEST(TopologyTest, Order) {
+    Sysfs sysfs;
+    TwoSockets(sysfs);
+    Topology topology = Topology::Read(sysfs.root);
+
+    EXPECT_TRUE(topology.Order(Topology::Placement::None).empty());
+
+    // Both hyperthreads of a core, then the other core, then the other socket
+    EXPECT_EQ(std::vector<int>({0, 4, 1, 5, 2, 6, 3, 7}), topology.Order(Topology::Placement::Compact));
+
+    // Sockets take turns, siblings go last
+    EXPECT_EQ(std::vector<int>({0, 2, 1, 3, 4, 6, 5, 7}), topology.Order(Topology::Placement::Scatter));
+}
+
+TEST(TopologyTest, Leaders) {
+    Sysfs sysfs;
+    TwoSockets(sysfs);
+    EXPECT_EQ(std::vector<int>({0, 2}), Topology::Read(sysfs.root).Leaders());
+
+    // The first CPU of the second socket is offline, its sibling takes over
+    sysfs.Online("0-1,3-7");
+    EXPECT_EQ(std::vector<int>({0, 3}), Topology::Read(sysfs.root).Leaders());
+}
+
+TEST(TopologyTest, Detect) {
+    Topology topology = Topology::Detect();
+    ASSERT_FALSE(topology.Cpus().empty());
+    EXPECT_GE(topology.Cpus().size(), topology.Cores());
+
+    // Calling thread may run on any of the CPUs detected
+    std::vector<int> order = topology.Order(Topology::Placement::Scatter);
+    EXPECT_EQ(topology.Cpus().size(), order.size());
+
+    // Thread is held till pinned, one which has already exited can't be pinned
+    std::mutex mutex;
+    std::condition_variable released;
+    bool release = false;
+    std::thread thread([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [&release]() { return release; });
+    });
+    EXPECT_EQ(0, Topology::Pin(thread, order.front()));
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        release = true;
+    }
+    released.notify_one();
+    thread.join();
+
+    EXPECT_EQ(Topology::Placement::Compact, Topology::ParsePlacement("compact"));
+    EXPECT_THROW(Topology::ParsePlacement("dense"), std::runtime_error);
+}
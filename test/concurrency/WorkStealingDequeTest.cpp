@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/WorkStealingDeque.h>
+
+using namespace Afina::Concurrency;
+
+TEST(WorkStealingDequeTest, OwnerLifoThiefFifo) {
+    std::vector<int> items = {0, 1, 2, 3};
+    WorkStealingDeque<int> deque(2);
+    for (int &i : items) {
+        deque.Push(&i);
+    }
+    EXPECT_EQ(4, deque.Size());
+
+    EXPECT_EQ(&items[3], deque.Pop());
+    EXPECT_EQ(&items[0], deque.Steal());
+    EXPECT_EQ(&items[2], deque.Pop());
+    EXPECT_EQ(&items[1], deque.Steal());
+    EXPECT_EQ(nullptr, deque.Pop());
+    EXPECT_EQ(nullptr, deque.Steal());
+    EXPECT_TRUE(deque.Empty());
+}
+
+TEST(WorkStealingDequeTest, Grow) {
+    std::vector<int> items(1000);
+    WorkStealingDeque<int> deque(4);
+
+    // Wrap around the ring a few times before it has to grow
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 3; i++) {
+            deque.Push(&items[i]);
+        }
+        for (int i = 0; i < 3; i++) {
+            EXPECT_EQ(&items[i], deque.Steal());
+        }
+    }
+
+    for (auto &i : items) {
+        deque.Push(&i);
+    }
+    for (auto &i : items) {
+        EXPECT_EQ(&i, deque.Steal());
+    }
+}
+
+TEST(WorkStealingDequeTest, ConcurrentSteal) {
+    const int count = 100000;
+    std::vector<int> items(count);
+    std::vector<std::atomic<int>> taken(count);
+    for (auto &t : taken) {
+        t.store(0);
+    }
+
+    WorkStealingDeque<int> deque(16);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; t++) {
+        thieves.emplace_back([&]() {
+            while (!done.load() || !deque.Empty()) {
+                int *item = deque.Steal();
+                if (item != nullptr) {
+                    taken[item - &items[0]]++;
+                }
+            }
+        });
+    }
+
+    // Owner pushes in batches and takes part of them back, racing thieves for the last items
+    for (int i = 0; i < count;) {
+        for (int j = 0; j < 7 && i < count; j++, i++) {
+            deque.Push(&items[i]);
+        }
+        for (int j = 0; j < 3; j++) {
+            int *item = deque.Pop();
+            if (item != nullptr) {
+                taken[item - &items[0]]++;
+            }
+        }
+    }
+    done.store(true);
+    for (auto &t : thieves) {
+        t.join();
+    }
+
+    // Nothing lost, nothing taken twice
+    for (int i = 0; i < count; i++) {
+        ASSERT_EQ(1, taken[i].load()) << "item " << i;
+    }
+}
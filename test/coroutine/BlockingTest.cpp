@@ -0,0 +1,219 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/coroutine/Channel.h>
+#include <afina/coroutine/ConditionVariable.h>
+#include <afina/coroutine/Engine.h>
+#include <afina/coroutine/Mutex.h>
+
+using namespace Afina::Coroutine;
+
+static void _count(int &counter) { counter++; }
+
+static void _blocker(Engine &pe, std::vector<int> &trace) {
+    int counter = 0;
+    void *routine = pe.run(_count, counter);
+    pe.block(routine);
+
+    // Blocked routine never gets control
+    for (int i = 0; i < 3; i++) {
+        pe.yield();
+        pe.sched(routine);
+    }
+    trace.push_back(counter);
+
+    pe.unblock(routine);
+    pe.sched(routine);
+    trace.push_back(counter);
+}
+
+TEST(BlockingTest, BlockUnblock) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    std::vector<int> trace;
+    engine.start(_blocker, engine, trace);
+    EXPECT_EQ(std::vector<int>({0, 1}), trace);
+}
+
+static void _forever(Engine &pe) { pe.block(); }
+
+static void _abandon(Engine &pe) {
+    pe.run(_forever, pe);
+    pe.run(_forever, pe);
+}
+
+TEST(BlockingTest, BlockedForever) {
+    // Engine returns once nobody could run anymore
+    Engine engine(Engine::Mode::SeparateStacks);
+    engine.start(_abandon, engine);
+    EXPECT_EQ(0, engine.stacks().InUse());
+}
+
+static void _sleeper(Engine &pe, std::vector<int> &trace, int ms) {
+    pe.sleep(std::chrono::milliseconds(ms));
+    trace.push_back(ms);
+}
+
+static void _sleepers(Engine &pe, std::vector<int> &trace) {
+    pe.run(_sleeper, pe, trace, 30);
+    pe.run(_sleeper, pe, trace, 10);
+    pe.run(_sleeper, pe, trace, 20);
+}
+
+TEST(BlockingTest, Sleep) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    std::vector<int> trace;
+    auto start = std::chrono::steady_clock::now();
+    engine.start(_sleepers, engine, trace);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Sleepers wake up in order of deadlines, and engine doesn't wait for them one after another
+    EXPECT_EQ(std::vector<int>({10, 20, 30}), trace);
+    EXPECT_GE(elapsed, std::chrono::milliseconds(30));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(60));
+}
+
+// CopyStack routines can't share stack variables, so state lives here
+static std::vector<int> copy_trace;
+
+static void _copy_sleeper(Engine &pe, int ms) {
+    pe.sleep(std::chrono::milliseconds(ms));
+    copy_trace.push_back(ms);
+}
+
+static void _copy_sleepers(Engine &pe) {
+    pe.run(_copy_sleeper, pe, 20);
+    pe.run(_copy_sleeper, pe, 10);
+}
+
+TEST(BlockingTest, SleepCopyStack) {
+    Engine engine;
+    engine.start(_copy_sleepers, engine);
+    EXPECT_EQ(std::vector<int>({10, 20}), copy_trace);
+}
+
+static void _critical(Engine &pe, Mutex &mutex, std::vector<int> &trace, int id) {
+    for (int i = 0; i < 3; i++) {
+        std::lock_guard<Mutex> lock(mutex);
+        trace.push_back(id);
+        pe.yield();
+        trace.push_back(id);
+    }
+}
+
+static void _contenders(Engine &pe, std::vector<int> &trace) {
+    Mutex mutex(pe);
+    void *a = pe.run(_critical, pe, mutex, trace, 1);
+    void *b = pe.run(_critical, pe, mutex, trace, 2);
+    pe.sched(a);
+    pe.sched(b);
+
+    // Wait for both to complete, mutex lives on this stack
+    while (trace.size() < 12) {
+        pe.yield();
+    }
+}
+
+TEST(BlockingTest, Mutex) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    std::vector<int> trace;
+    engine.start(_contenders, engine, trace);
+
+    // Nobody gets into critical section while it is taken, and mutex is handed over in turns
+    EXPECT_EQ(std::vector<int>({1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2}), trace);
+}
+
+struct Queue {
+    explicit Queue(Engine &pe) : mutex(pe), cv(pe), done(false) {}
+
+    Mutex mutex;
+    ConditionVariable cv;
+    std::vector<int> items;
+    bool done;
+};
+
+static void _consumer(Queue &q, int &sum) {
+    std::unique_lock<Mutex> lock(q.mutex);
+    for (;;) {
+        q.cv.wait(q.mutex, [&q]() { return !q.items.empty() || q.done; });
+        if (q.items.empty()) {
+            return;
+        }
+        sum += q.items.back();
+        q.items.pop_back();
+    }
+}
+
+static void _producer(Engine &pe, int &sum) {
+    Queue q(pe);
+    void *consumer = pe.run(_consumer, q, sum);
+    pe.sched(consumer);
+
+    for (int i = 1; i <= 100; i++) {
+        std::lock_guard<Mutex> lock(q.mutex);
+        q.items.push_back(i);
+        q.cv.notify_one();
+    }
+
+    {
+        std::lock_guard<Mutex> lock(q.mutex);
+        q.done = true;
+        q.cv.notify_all();
+    }
+
+    // Let consumer drain the queue, it lives on this stack
+    while (q.done && (!q.items.empty() || sum < 5050)) {
+        pe.yield();
+    }
+}
+
+TEST(BlockingTest, ConditionVariable) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    int sum = 0;
+    engine.start(_producer, engine, sum);
+    EXPECT_EQ(5050, sum);
+}
+
+static void _receiver(Channel<int> &channel, int &sum, int &received) {
+    int value;
+    while (channel.receive(value)) {
+        sum += value;
+        received++;
+    }
+}
+
+static void _sender(Engine &pe, int &sum, int &received, std::size_t &max_size) {
+    Channel<int> channel(pe, 4);
+    pe.run(_receiver, channel, sum, received);
+    pe.run(_receiver, channel, sum, received);
+
+    for (int i = 1; i <= 1000; i++) {
+        EXPECT_TRUE(channel.send(i));
+        max_size = std::max(max_size, channel.size());
+    }
+    channel.close();
+    EXPECT_FALSE(channel.send(0));
+
+    // Receivers finish once channel is drained
+    while (received < 1000) {
+        pe.yield();
+    }
+}
+
+TEST(BlockingTest, Channel) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    int sum = 0, received = 0;
+    std::size_t max_size = 0;
+    engine.start(_sender, engine, sum, received, max_size);
+    EXPECT_EQ(1000, received);
+    EXPECT_EQ(500500, sum);
+    EXPECT_LE(max_size, 4);
+}
@@ -62,3 +62,38 @@ TEST(CoroutineTest, Printer) {
     engine.start(_printer, engine, result);
     ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
 }
+
+void _worker(Afina::Coroutine::Engine &pe, std::stringstream &out, int id) {
+    out << "W" << id << "1 ";
+    pe.sched(nullptr);
+
+    out << "W" << id << "2 ";
+}
+
+std::stringstream trace;
+void _dispatcher(Afina::Coroutine::Engine &pe, std::string &result) {
+    void *w1 = pe.run(_worker, pe, trace, 1);
+    void *w2 = pe.run(_worker, pe, trace, 2);
+
+    // Each worker gives control back to the dispatcher, not to each other
+    pe.sched(w1);
+    trace << "D ";
+    pe.sched(w2);
+    trace << "D ";
+
+    // Finished worker returns control to the one which has resumed it as well
+    pe.sched(w2);
+    trace << "D ";
+    pe.sched(w1);
+    trace << "END";
+
+    result = trace.str();
+}
+
+TEST(CoroutineTest, SchedToCaller) {
+    Afina::Coroutine::Engine engine;
+
+    std::string result;
+    engine.start(_dispatcher, engine, result);
+    ASSERT_STREQ("W11 D W21 D W22 D W12 END", result.c_str());
+}
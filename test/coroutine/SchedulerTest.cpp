@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <afina/coroutine/Scheduler.h>
+
+using namespace Afina::Coroutine;
+
+static void _yielder(Scheduler &s, std::atomic<int> &counter) {
+    for (int i = 0; i < 10; i++) {
+        s.yield();
+    }
+    counter++;
+}
+
+TEST(SchedulerTest, RunAll) {
+    Scheduler scheduler(4);
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 1000; i++) {
+        scheduler.run(_yielder, scheduler, counter);
+    }
+
+    scheduler.start();
+    scheduler.stop();
+    scheduler.join();
+
+    EXPECT_EQ(1000, counter.load());
+    EXPECT_EQ(0, scheduler.alive());
+}
+
+struct Spread {
+    std::mutex lock;
+    std::set<std::thread::id> threads;
+    std::atomic<int> done{0};
+};
+
+static void _busy(Scheduler &s, Spread &spread) {
+    for (int i = 0; i < 5; i++) {
+        // Keep the processor busy long enough for others to come and steal
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(200);
+        while (std::chrono::steady_clock::now() < until) {
+        }
+
+        std::lock_guard<std::mutex> lock(spread.lock);
+        spread.threads.insert(std::this_thread::get_id());
+    }
+    spread.done++;
+}
+
+static void _spawner(Scheduler &s, Spread &spread) {
+    // All routines land in deque of the processor running this one
+    for (int i = 0; i < 64; i++) {
+        s.run(_busy, s, spread);
+    }
+}
+
+TEST(SchedulerTest, Steal) {
+    Scheduler scheduler(4);
+    Spread spread;
+    scheduler.run(_spawner, scheduler, spread);
+
+    scheduler.start();
+    scheduler.stop();
+    scheduler.join();
+
+    EXPECT_EQ(64, spread.done.load());
+    EXPECT_GT(scheduler.steals(), 0);
+    EXPECT_GT(spread.threads.size(), 1);
+}
+
+static void _reader(Scheduler &s, int fd, std::string &result) {
+    char buffer[16];
+    for (;;) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            result.append(buffer, n);
+        } else if (n == 0) {
+            return;
+        } else {
+            uint32_t events = s.wait(fd, EPOLLIN);
+            EXPECT_TRUE(events & (EPOLLIN | EPOLLHUP));
+        }
+    }
+}
+
+static void _writer(Scheduler &s, int fd) {
+    const char *parts[] = {"hello", " ", "world"};
+    for (auto part : parts) {
+        // Let reader get to wait in between
+        for (int i = 0; i < 3; i++) {
+            s.yield();
+        }
+        ASSERT_EQ(strlen(part), write(fd, part, strlen(part)));
+    }
+    close(fd);
+}
+
+TEST(SchedulerTest, Wait) {
+    int fds[2];
+    ASSERT_EQ(0, pipe2(fds, O_NONBLOCK));
+
+    Scheduler scheduler(2);
+    std::string result;
+    scheduler.run(_reader, scheduler, int(fds[0]), result);
+    scheduler.run(_writer, scheduler, int(fds[1]));
+
+    scheduler.start();
+    scheduler.stop();
+    scheduler.join();
+    close(fds[0]);
+
+    EXPECT_EQ("hello world", result);
+}
+
+TEST(SchedulerTest, WaitOutside) {
+    Scheduler scheduler(1);
+    EXPECT_THROW(scheduler.wait(0, EPOLLIN), std::runtime_error);
+}
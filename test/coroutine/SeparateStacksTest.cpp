@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <afina/coroutine/Engine.h>
+
+using Afina::Coroutine::Engine;
+
+static void _add(int &result, int left, int right) { result = left + right; }
+
+TEST(SeparateStacksTest, SimpleStart) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    int result = 0;
+    engine.start(_add, result, 1, 2);
+
+    ASSERT_EQ(3, result);
+}
+
+static void _ping(Engine &pe, std::stringstream &out, void *&other, char name) {
+    for (int i = 1; i <= 3; i++) {
+        out << name << i << " ";
+        pe.sched(other);
+    }
+}
+
+static void _pinger(Engine &pe, std::string &result) {
+    // Routines have own stacks, so locals of one routine could be shared with others
+    std::stringstream out;
+    void *pa = nullptr, *pb = nullptr;
+    pa = pe.run(_ping, pe, out, pb, 'A');
+    pb = pe.run(_ping, pe, out, pa, 'B');
+
+    pe.sched(pa);
+    out << "END";
+    result = out.str();
+}
+
+TEST(SeparateStacksTest, Printer) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    std::string result;
+    engine.start(_pinger, engine, result);
+    ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
+}
+
+static void _step(Engine &pe, std::stringstream &out, int id) {
+    out << "W" << id << "1 ";
+    pe.sched(nullptr);
+
+    out << "W" << id << "2 ";
+}
+
+static void _stepper(Engine &pe, std::string &result) {
+    std::stringstream out;
+    void *w1 = pe.run(_step, pe, out, 1);
+    void *w2 = pe.run(_step, pe, out, 2);
+
+    pe.sched(w1);
+    out << "D ";
+    pe.sched(w2);
+    out << "D ";
+    pe.sched(w2);
+    out << "D ";
+    pe.sched(w1);
+    out << "END";
+
+    result = out.str();
+}
+
+TEST(SeparateStacksTest, SchedToCaller) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    std::string result;
+    engine.start(_stepper, engine, result);
+    ASSERT_STREQ("W11 D W21 D W22 D W12 END", result.c_str());
+}
+
+static void _inc(int &result) { result++; }
+
+static void _spawner(Engine &pe, int &result) {
+    // Finished routines must release their stacks, otherwise that would take 64M
+    for (int i = 0; i < 1000; i++) {
+        pe.sched(pe.run(_inc, result));
+    }
+}
+
+TEST(SeparateStacksTest, ManyRoutines) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    int result = 0;
+    engine.start(_spawner, engine, result);
+    ASSERT_EQ(1000, result);
+}
+
+// Switch benchmark: two routines ping pong with each other having a few KB of live stack under them, like
+// connection coroutine does with parser and storage frames
+const int kSwitches = 20000;
+
+static void _bouncer(Engine &pe, void *&other, int &count) {
+    while (count < kSwitches) {
+        count++;
+        pe.sched(other);
+    }
+}
+
+static void _deep(Engine &pe, void *&first, void *&second, int &count, int depth) {
+    volatile char frame[512];
+    std::memset(const_cast<char *>(frame), depth, sizeof(frame));
+    if (depth > 0) {
+        _deep(pe, first, second, count, depth - 1);
+        return;
+    }
+
+    first = pe.run(_bouncer, pe, second, count);
+    second = pe.run(_bouncer, pe, first, count);
+    pe.sched(first);
+}
+
+static long _measure(Engine::Mode mode) {
+    Engine engine(mode);
+    void *first = nullptr, *second = nullptr;
+    int count = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    engine.start(_deep, engine, first, second, count, 16);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(count, kSwitches);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / kSwitches;
+}
+
+TEST(SeparateStacksTest, SwitchBenchmark) {
+    long copy_ns = _measure(Engine::Mode::CopyStack);
+    long separate_ns = _measure(Engine::Mode::SeparateStacks);
+
+    std::cout << "copy stack: " << copy_ns << "ns per switch" << std::endl;
+    std::cout << "separate stacks: " << separate_ns << "ns per switch" << std::endl;
+    EXPECT_LT(separate_ns, copy_ns);
+}
@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <afina/coroutine/Engine.h>
+#include <afina/coroutine/StackPool.h>
+
+using Afina::Coroutine::Engine;
+using Afina::Coroutine::StackPool;
+
+// Number of resident pages of the stack
+static std::size_t resident(char *stack, std::size_t size) {
+    std::size_t page = sysconf(_SC_PAGESIZE);
+    std::vector<unsigned char> pages(size / page);
+    mincore(stack, size, &pages[0]);
+
+    std::size_t result = 0;
+    for (auto p : pages) {
+        result += p & 1;
+    }
+    return result;
+}
+
+TEST(StackPoolTest, Recycle) {
+    StackPool pool(64 * 1024);
+    EXPECT_EQ(64 * 1024, pool.StackSize());
+
+    char *first = pool.Acquire();
+    char *second = pool.Acquire();
+    EXPECT_NE(first, second);
+    EXPECT_EQ(2, pool.InUse());
+
+    pool.Release(first);
+    EXPECT_EQ(1, pool.InUse());
+    EXPECT_EQ(1, pool.Cached());
+
+    EXPECT_EQ(first, pool.Acquire());
+    EXPECT_EQ(0, pool.Cached());
+
+    pool.Release(first);
+    pool.Release(second);
+}
+
+TEST(StackPoolTest, LazyCommit) {
+    std::size_t page = sysconf(_SC_PAGESIZE);
+    StackPool pool(256 * 1024);
+
+    // Nothing is committed until touched
+    char *stack = pool.Acquire();
+    EXPECT_EQ(0, resident(stack, pool.StackSize()));
+
+    // Routine used top three pages
+    char *top = stack + pool.StackSize();
+    for (int i = 1; i <= 3; i++) {
+        *(top - i * page) = 1;
+    }
+    EXPECT_EQ(3, resident(stack, pool.StackSize()));
+
+    pool.Release(stack);
+    EXPECT_EQ(3 * page, pool.HighWater());
+}
+
+TEST(StackPoolTest, TrimOnRelease) {
+    StackPool pool(256 * 1024);
+
+    char *stack = pool.Acquire();
+    std::memset(stack, 1, pool.StackSize());
+    pool.Release(stack);
+
+    // Deep pages are given back, only the top stays committed for the next routine
+    EXPECT_EQ(pool.StackSize(), pool.HighWater());
+    EXPECT_EQ(StackPool::kKeepResident / sysconf(_SC_PAGESIZE), resident(stack, pool.StackSize()));
+
+    stack = pool.Acquire();
+    EXPECT_EQ(1, stack[pool.StackSize() - 1]);
+    EXPECT_EQ(0, stack[0]);
+    pool.Release(stack);
+}
+
+TEST(StackPoolTest, GuardPage) {
+    testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    StackPool pool(64 * 1024);
+    char *stack = pool.Acquire();
+    volatile char *below = stack - 1;
+    EXPECT_DEATH(*below = 1, "");
+    pool.Release(stack);
+}
+
+static void _idle(Engine &pe) {
+    // Parks right away as idle connection does, then finishes
+    pe.sched(nullptr);
+}
+
+static void _spawn(Engine &pe, std::size_t &in_use) {
+    std::vector<void *> routines;
+    for (int i = 0; i < 100; i++) {
+        routines.push_back(pe.run(_idle, pe));
+        pe.sched(routines.back());
+    }
+    in_use = pe.stacks().InUse();
+
+    for (auto r : routines) {
+        pe.sched(r);
+    }
+}
+
+TEST(StackPoolTest, IdleRoutineCost) {
+    Engine engine(Engine::Mode::SeparateStacks);
+
+    std::size_t in_use = 0;
+    engine.start(_spawn, engine, in_use);
+
+    // Main routine and 100 idle ones
+    EXPECT_EQ(101, in_use);
+    EXPECT_EQ(0, engine.stacks().InUse());
+    EXPECT_EQ(101, engine.stacks().Cached());
+
+    // Idle routine has touched a few KB of its stack only
+    EXPECT_GT(engine.stacks().HighWater(), 0);
+    EXPECT_LE(engine.stacks().HighWater(), StackPool::kKeepResident);
+}
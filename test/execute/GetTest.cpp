@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+#include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Execute;
+
+TEST(GetTest, SmallValuesInline) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval");
+    storage.Put("bar", "barval");
+
+    Get cmd({"foo", "none", "bar"});
+    Response out;
+    cmd.Execute(storage, "", out);
+
+    EXPECT_EQ(1, out.segments().size());
+    EXPECT_EQ("VALUE foo 0 6\r\nfooval\r\nVALUE bar 0 6\r\nbarval\r\nEND\r\n", out.str());
+
+    std::string legacy;
+    cmd.Execute(storage, "", legacy);
+    EXPECT_EQ("VALUE foo 0 6\r\nfooval\r\nVALUE bar 0 6\r\nbarval\r\nEND", legacy);
+}
+
+TEST(GetTest, LargeValuesReferred) {
+    Backend::SimpleLRU storage(1 << 20);
+    std::string big(4096, 'x');
+    storage.Put("big", big);
+
+    Get cmd({"big", "big"});
+    Response out;
+    cmd.Execute(storage, "", out);
+
+    // header, value, "\r\n" + header, value, "\r\nEND\r\n"
+    std::vector<Response::Segment> &segments = out.segments();
+    ASSERT_EQ(5, segments.size());
+    EXPECT_FALSE(segments[1].owned());
+    EXPECT_EQ(segments[1].data(), segments[3].data());
+
+    // Value stays valid after storage dropped it
+    storage.Delete("big");
+    EXPECT_EQ(big, std::string(segments[1].data(), segments[1].size()));
+    EXPECT_EQ("VALUE big 0 4096\r\n" + big + "\r\nVALUE big 0 4096\r\n" + big + "\r\nEND\r\n", out.str());
+}
+
+TEST(GetTest, RenderedItemSingleSpan) {
+    Backend::SimpleLRU storage(1 << 20, true);
+    std::string big(1024, 'y');
+    storage.Put("foo", "fooval", 12, 0);
+    storage.Put("big", big, 3, 0);
+
+    Get cmd({"foo", "big"});
+    Response out;
+    cmd.Execute(storage, "", out);
+
+    // header+value+"\r\n" of small item copied, big item is a single span, then END
+    std::vector<Response::Segment> &segments = out.segments();
+    ASSERT_EQ(3, segments.size());
+    EXPECT_FALSE(segments[1].owned());
+    EXPECT_EQ("VALUE foo 12 6\r\nfooval\r\nVALUE big 3 1024\r\n" + big + "\r\nEND\r\n", out.str());
+}
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+
+#include <ctime>
+#include <string>
+
+#include <afina/execute/MetaDelete.h>
+#include <afina/execute/MetaGet.h>
+#include <afina/execute/MetaNoop.h>
+#include <afina/execute/MetaSet.h>
+#include <afina/execute/Response.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Execute;
+
+// Runs command and returns whole reply
+static std::string run(Command &cmd, Storage &storage, const std::string &args = "") {
+    Response out;
+    cmd.Execute(storage, args, out);
+    return out.str();
+}
+
+TEST(MetaCommandTest, GetFlags) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval", 42, 0);
+
+    MetaGet value("foo", {"v", "f", "s", "t", "k", "Oxyz"});
+    EXPECT_EQ("VA 6 f42 s6 t-1 kfoo Oxyz\r\nfooval\r\n", run(value, storage));
+
+    MetaGet head("foo", {"Oabc", "f"});
+    EXPECT_EQ("HD Oabc f42\r\n", run(head, storage));
+
+    MetaGet miss("bar", {"v"});
+    EXPECT_EQ("EN\r\n", run(miss, storage));
+
+    MetaGet quiet("bar", {"v", "q"});
+    EXPECT_EQ("", run(quiet, storage));
+}
+
+TEST(MetaCommandTest, GetRenderedValue) {
+    Backend::SimpleLRU storage(1024, true);
+    storage.Put("foo", "fooval", 1, 0);
+
+    MetaGet cmd("foo", {"v"});
+    EXPECT_EQ("VA 6\r\nfooval\r\n", run(cmd, storage));
+}
+
+TEST(MetaCommandTest, SetModes) {
+    Backend::SimpleLRU storage;
+
+    MetaSet add("foo", {"ME", "F3", "T100"});
+    EXPECT_EQ("HD\r\n", run(add, storage, "val"));
+    EXPECT_EQ("NS\r\n", run(add, storage, "val"));
+
+    MetaGet ttl("foo", {"t", "f"});
+    std::string reply = run(ttl, storage);
+    EXPECT_TRUE(reply == "HD t100 f3\r\n" || reply == "HD t99 f3\r\n") << reply;
+
+    MetaSet append("foo", {"MA", "q"});
+    EXPECT_EQ("", run(append, storage, "_end"));
+    MetaSet prepend("foo", {"MP", "Oop"});
+    EXPECT_EQ("HD Oop\r\n", run(prepend, storage, "begin_"));
+
+    MetaGet get("foo", {"v", "f"});
+    EXPECT_EQ("VA 13 f3\r\nbegin_val_end\r\n", run(get, storage));
+
+    MetaSet replace("bar", {"MR", "kfoo"});
+    EXPECT_EQ("NS kbar\r\n", run(replace, storage, "val"));
+    MetaSet append_missing("bar", {"MA"});
+    EXPECT_EQ("NS\r\n", run(append_missing, storage, "val"));
+}
+
+TEST(MetaCommandTest, Expired) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval", 0, time(nullptr) - 1);
+
+    MetaGet get("foo", {"v"});
+    EXPECT_EQ("EN\r\n", run(get, storage));
+
+    MetaSet set("foo", {"T-1"});
+    EXPECT_EQ("HD\r\n", run(set, storage, "val"));
+    EXPECT_EQ("EN\r\n", run(get, storage));
+
+    EXPECT_THROW(MetaSet("foo", {"Tx"}), std::runtime_error);
+}
+
+// Numbers out of range are refused rather than wrapped
+TEST(MetaCommandTest, FlagOverflow) {
+    EXPECT_NO_THROW(MetaSet("foo", {"F4294967295"}));
+    EXPECT_THROW(MetaSet("foo", {"F4294967296"}), std::runtime_error);
+    EXPECT_THROW(MetaSet("foo", {"F9999999999"}), std::runtime_error);
+
+    EXPECT_NO_THROW(MetaSet("foo", {"T2147483647"}));
+    EXPECT_THROW(MetaSet("foo", {"T3000000000"}), std::runtime_error);
+    EXPECT_THROW(MetaGet("foo", {"T3000000000"}), std::runtime_error);
+}
+
+TEST(MetaCommandTest, DeleteAndNoop) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval");
+
+    MetaDelete del("foo", {"Oabc"});
+    EXPECT_EQ("HD Oabc\r\n", run(del, storage));
+    EXPECT_EQ("NF Oabc\r\n", run(del, storage));
+
+    storage.Put("foo", "fooval");
+    MetaDelete quiet("foo", {"q"});
+    EXPECT_EQ("", run(quiet, storage));
+    EXPECT_EQ("", run(quiet, storage));
+
+    MetaNoop noop;
+    EXPECT_EQ("MN\r\n", run(noop, storage));
+
+    std::string legacy;
+    Command &cmd = del;
+    cmd.Execute(storage, "", legacy);
+    EXPECT_EQ("NF Oabc", legacy);
+}
+
+TEST(MetaCommandTest, GetAndTouch) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval", 0, 0);
+
+    MetaGet touch("foo", {"T100", "v"});
+    EXPECT_EQ("VA 6\r\nfooval\r\n", run(touch, storage));
+
+    MetaGet ttl("foo", {"t"});
+    std::string reply = run(ttl, storage);
+    EXPECT_TRUE(reply == "HD t100\r\n" || reply == "HD t99\r\n") << reply;
+}
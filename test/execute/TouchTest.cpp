@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+
+#include <ctime>
+#include <string>
+
+#include <afina/execute/Gat.h>
+#include <afina/execute/Response.h>
+#include <afina/execute/Touch.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Execute;
+
+TEST(TouchTest, Touch) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval", 0, time(nullptr) + 1);
+
+    std::string out;
+    Touch(std::string("foo"), 0).Execute(storage, "", out);
+    EXPECT_EQ("TOUCHED", out);
+    Touch(std::string("bar"), 0).Execute(storage, "", out);
+    EXPECT_EQ("NOT_FOUND", out);
+
+    StoredValue value;
+    ASSERT_TRUE(storage.Get("foo", value));
+    EXPECT_EQ(0, value.expire);
+
+    Touch(std::string("foo"), -1).Execute(storage, "", out);
+    EXPECT_EQ("TOUCHED", out);
+    EXPECT_FALSE(storage.Get("foo", value));
+}
+
+TEST(TouchTest, Gat) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval", 3, 0);
+    storage.Put("bar", "barval", 0, 0);
+
+    Gat cmd(100, {"foo", "none"});
+    Response out;
+    cmd.Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 3 6\r\nfooval\r\nEND\r\n", out.str());
+
+    StoredValue value;
+    ASSERT_TRUE(storage.Get("foo", value));
+    EXPECT_GE(value.expire, time(nullptr) + 99);
+    ASSERT_TRUE(storage.Get("bar", value));
+    EXPECT_EQ(0, value.expire);
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+#include "network/BufferPool.h"
+
+using namespace Afina::Network;
+
+TEST(BufferPoolTest, Reuse) {
+    BufferPool pool(4096);
+    EXPECT_EQ(4096, pool.BufferSize());
+    EXPECT_EQ(0, pool.Memory());
+
+    char *a = pool.Acquire();
+    char *b = pool.Acquire();
+    EXPECT_NE(a, b);
+    std::memset(a, 'a', pool.BufferSize());
+    std::memset(b, 'b', pool.BufferSize());
+    EXPECT_EQ(2, pool.InUse());
+    EXPECT_EQ(0, pool.Cached());
+    EXPECT_EQ(2 * 4096, pool.Memory());
+
+    // The most recently released goes out first
+    pool.Release(a);
+    pool.Release(b);
+    EXPECT_EQ(0, pool.InUse());
+    EXPECT_EQ(2, pool.Cached());
+    EXPECT_EQ(2 * 4096, pool.Memory());
+    EXPECT_EQ(b, pool.Acquire());
+    EXPECT_EQ(a, pool.Acquire());
+    EXPECT_EQ(2, pool.InUse());
+    EXPECT_EQ(0, pool.Cached());
+
+    pool.Release(a);
+    pool.Release(b);
+}
+
+TEST(BufferPoolTest, MaxCached) {
+    BufferPool pool(128, 2);
+
+    std::vector<char *> buffers;
+    for (int i = 0; i < 5; i++) {
+        buffers.push_back(pool.Acquire());
+    }
+    EXPECT_EQ(5, pool.InUse());
+
+    // Only a few are kept once load goes down
+    for (auto buffer : buffers) {
+        pool.Release(buffer);
+    }
+    EXPECT_EQ(0, pool.InUse());
+    EXPECT_EQ(2, pool.Cached());
+    EXPECT_EQ(2 * 128, pool.Memory());
+}
@@ -0,0 +1,214 @@
+#include "gtest/gtest.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/mt_reuseport/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "network/uring/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+#include "TestServer.h"
+
+using namespace Afina;
+using namespace Afina::Test;
+
+namespace {
+
+// Client sending that much without being stopped means server doesn't stop reading
+const std::size_t kMaxSent = 1024 * 1024;
+
+// Servers applying connection limits, edge triggered mt_nonblock has to read throttled connection again by
+// itself once it drains, as there is no new EPOLLIN for the data already queued in the socket. uring cancels
+// multishot recv instead and has no timers for the drain timeout
+const std::vector<std::string> kServers = {"st_nonblock", "mt_nonblock", "mt_nonblock_et", "mt_reuseport", "uring"};
+
+std::unique_ptr<Network::Server> make_server(const std::string &name, std::shared_ptr<Afina::Storage> storage,
+                                             const Network::ConnectionLimits &limits) {
+    std::unique_ptr<Network::Server> result;
+    if (name == "st_nonblock") {
+        result.reset(new Network::STnonblock::ServerImpl(storage, logging()));
+    } else if (name == "mt_nonblock") {
+        result.reset(new Network::MTnonblock::ServerImpl(storage, logging()));
+    } else if (name == "mt_nonblock_et") {
+        result.reset(new Network::MTnonblock::ServerImpl(storage, logging(), true));
+    } else if (name == "mt_reuseport") {
+        result.reset(new Network::MTreuseport::ServerImpl(storage, logging()));
+    } else if (name == "uring") {
+        result.reset(new Network::Uring::ServerImpl(storage, logging()));
+    }
+    result->SetLimits(limits);
+    return result;
+}
+
+// Storage with a value big enough for a few gets to reach output limits
+std::shared_ptr<Afina::Storage> make_storage(std::string &reply) {
+    std::string value(1024, 'v');
+    std::shared_ptr<Afina::Storage> result = std::make_shared<Backend::ThreadSafeSimplLRU>(64 * 1024);
+    result->Put("key", value);
+    reply = "VALUE key 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\nEND\r\n";
+    return result;
+}
+
+// Small send buffer, so that kernel can't hide much of what server holds back, and no waiting forever. Receive
+// buffer is left alone: one smaller than loopback MSS makes each segment wait for delayed ACK
+int connect_client(uint16_t port) {
+    int fd = connect_to(port);
+    int size = 16 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+
+    struct timeval tv;
+    tv.tv_sec = 5;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+}
+
+} // namespace
+
+// Client pipelining gets without reading is no longer read once responses reach the high mark, and is served
+// again as soon as it takes them down to the low one
+TEST(ConnectionLimitsTest, OutputHighStopsReading) {
+    Network::ConnectionLimits limits;
+    limits.output_high = 16 * 1024;
+    limits.output_low = 4 * 1024;
+
+    const std::string request = "get key\r\n";
+    std::string reply;
+    auto storage = make_storage(reply);
+
+    for (auto &name : kServers) {
+        SCOPED_TRACE(name);
+        uint16_t port = next_port();
+        auto server = make_server(name, storage, limits);
+        server->Start(port, 1, 2);
+
+        int fd = connect_client(port);
+        std::size_t sent = send_till_stopped(fd, request, kMaxSent);
+        EXPECT_LT(sent, kMaxSent) << "server hasn't stopped reading";
+
+        // Every complete command is answered, resume failure would leave the client waiting for the rest
+        std::size_t expected = sent / request.size() * reply.size();
+        std::size_t received = 0;
+        bool match = true;
+        std::vector<char> buf(64 * 1024);
+        while (received < expected) {
+            ssize_t n = recv(fd, buf.data(), std::min(buf.size(), expected - received), 0);
+            if (n <= 0) {
+                break;
+            }
+            for (ssize_t i = 0; i < n && match; i++) {
+                match = buf[i] == reply[(received + i) % reply.size()];
+            }
+            received += n;
+        }
+        EXPECT_EQ(expected, received);
+        EXPECT_TRUE(match);
+        close(fd);
+
+        server->Stop();
+        server->Join();
+    }
+}
+
+// Client which doesn't take responses is closed once it has been stopped for the drain timeout
+TEST(ConnectionLimitsTest, DrainTimeoutCloses) {
+    Network::ConnectionLimits limits;
+    limits.output_high = 16 * 1024;
+    limits.output_low = 4 * 1024;
+    limits.drain_timeout = std::chrono::milliseconds(200);
+
+    const std::string request = "get key\r\n";
+    std::string reply;
+    auto storage = make_storage(reply);
+
+    for (auto &name : kServers) {
+        if (name == "uring") {
+            continue;
+        }
+        SCOPED_TRACE(name);
+        uint16_t port = next_port();
+        auto server = make_server(name, storage, limits);
+        server->Start(port, 1, 2);
+
+        int fd = connect_client(port);
+        std::size_t sent = send_till_stopped(fd, request, kMaxSent);
+        EXPECT_LT(sent, kMaxSent) << "server hasn't stopped reading";
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // Whatever has been sent before close can be read, then there is either end of stream or reset, but
+        // not the receive timeout of an open connection
+        std::size_t expected = sent / request.size() * reply.size();
+        std::size_t received = 0;
+        std::vector<char> buf(64 * 1024);
+        ssize_t n;
+        while ((n = recv(fd, buf.data(), buf.size(), 0)) > 0) {
+            received += n;
+        }
+        EXPECT_TRUE(n == 0 || errno == ECONNRESET) << "connection is still open";
+        EXPECT_LT(received, expected);
+        close(fd);
+
+        server->Stop();
+        server->Join();
+    }
+}
+
+// Command with an argument over the input limit is refused by closing the connection, responses for commands
+// before it are still delivered. Neither the refused command nor anything pipelined after it runs, even when it
+// all arrives along with the header and spans a few read buffers
+TEST(ConnectionLimitsTest, InputHighCloses) {
+    Network::ConnectionLimits limits;
+    limits.input_high = 1024;
+
+    std::string reply;
+    auto storage = make_storage(reply);
+    std::string request = "get key\r\nset big 0 0 2048\r\n" + std::string(2048, 'y') + "\r\n";
+    while (request.size() < 64 * 1024) {
+        request += "set next 0 0 1\r\nx\r\n";
+    }
+
+    for (auto &name : kServers) {
+        SCOPED_TRACE(name);
+        uint16_t port = next_port();
+        auto server = make_server(name, storage, limits);
+        server->Start(port, 1, 2);
+
+        // Server may close before it gets everything, the rest is lost then
+        int fd = connect_client(port);
+        for (std::size_t sent = 0; sent < request.size();) {
+            ssize_t n = send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                break;
+            }
+            sent += n;
+        }
+
+        std::string received;
+        std::vector<char> buf(4096);
+        ssize_t n;
+        while ((n = recv(fd, buf.data(), buf.size(), 0)) > 0) {
+            received.append(buf.data(), n);
+        }
+        EXPECT_TRUE(n == 0 || errno == ECONNRESET) << "connection is still open";
+        EXPECT_EQ(reply, received);
+        close(fd);
+
+        server->Stop();
+        server->Join();
+
+        std::string stored;
+        EXPECT_FALSE(storage->Get("big", stored));
+        EXPECT_FALSE(storage->Get("next", stored));
+    }
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "network/mt_nonblocking/Connection.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+#include "TestServer.h"
+
+using namespace Afina;
+using namespace Afina::Test;
+
+// Single client pipelines many times more commands than a connection may read per event. With edge triggered
+// epoll there is no new EPOLLIN for data already in the socket, so worker has to come back to the connection by
+// itself both when the read budget is over and when throttled connection drains, otherwise the client waits
+// for the rest of replies forever.
+//
+// Concurrent sender would keep raising new edges, so the whole pipeline is queued up front: client doesn't read
+// till server stops on the output high mark, and unix socket keeps as much as client send buffer allows, which
+// is more than a read budget. Once client drains output to the low mark the budget is far from the high one
+TEST(EdgeTriggeredTest, PipelineOverReadBudget) {
+    const std::string request = "get key\r\n";
+    const std::string reply = "VALUE key 0 5\r\nvalue\r\nEND\r\n";
+    const std::size_t budget = Network::MTnonblock::Connection::kReadBuffer *
+                               Network::MTnonblock::Connection::kReadBudget;
+    const std::string path = "/tmp/afina-edge-" + std::to_string(getpid()) + ".sock";
+
+    Network::ConnectionLimits limits;
+    limits.output_high = 4 * budget / request.size() * reply.size();
+    limits.output_low = 64 * 1024;
+
+    std::shared_ptr<Afina::Storage> storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1024);
+    storage->Put("key", "value");
+
+    Network::MTnonblock::ServerImpl server(storage, logging(), true);
+    server.SetLimits(limits);
+    server.SetUnixSocket(path);
+    server.Start(next_port(), 1, 2);
+
+    int fd = connect_to(path);
+    int size = 2 * budget;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    struct timeval tv;
+    tv.tv_sec = 5;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    std::size_t sent = send_till_stopped(fd, request, 64 * budget);
+    EXPECT_GT(sent, 4 * budget + budget);
+
+    std::size_t expected = sent / request.size() * reply.size();
+    std::size_t received = 0;
+    bool match = true;
+    std::vector<char> buf(64 * 1024);
+    while (received < expected) {
+        ssize_t n = recv(fd, buf.data(), std::min(buf.size(), expected - received), 0);
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < n && match; i++) {
+            match = buf[i] == reply[(received + i) % reply.size()];
+        }
+        received += n;
+    }
+    close(fd);
+
+    EXPECT_EQ(expected, received);
+    EXPECT_TRUE(match);
+
+    server.Stop();
+    server.Join();
+}
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "network/OutputQueue.h"
+
+using namespace Afina::Network;
+
+// Reads everything from the socket until peer closes it
+static std::string drain(int fd) {
+    std::string result;
+    char buf[65536];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        result.append(buf, n);
+    }
+    return result;
+}
+
+TEST(OutputQueueTest, KeepsOrder) {
+    int sv[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+    OutputQueue queue;
+    queue.Push("STORED\r\n");
+    queue.Push("");
+    queue.Push("END\r\n");
+    EXPECT_EQ(13, queue.Size());
+
+    EXPECT_EQ(1, queue.Flush(sv[0]));
+    EXPECT_TRUE(queue.Empty());
+    close(sv[0]);
+
+    EXPECT_EQ("STORED\r\nEND\r\n", drain(sv[1]));
+    close(sv[1]);
+}
+
+TEST(OutputQueueTest, PartialWrite) {
+    int sv[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+    int sndbuf = 4096;
+    setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL, 0) | O_NONBLOCK);
+
+    std::string expected;
+    OutputQueue queue;
+    for (int i = 0; i < 1000; i++) {
+        std::string chunk = "VALUE key" + std::to_string(i) + " 0 5\r\nvalue\r\n";
+        expected += chunk;
+        queue.Push(std::move(chunk));
+    }
+
+    // Socket can't take all the data at once
+    ssize_t written = queue.Write(sv[0]);
+    ASSERT_GT(written, 0);
+    ASSERT_FALSE(queue.Empty());
+    EXPECT_EQ(expected.size() - written, queue.Size());
+
+    std::string received;
+    std::thread reader([&]() { received = drain(sv[1]); });
+    while (!queue.Empty()) {
+        if (queue.Write(sv[0]) < 0) {
+            ASSERT_EQ(EAGAIN, errno);
+        }
+    }
+    close(sv[0]);
+    reader.join();
+    close(sv[1]);
+
+    EXPECT_EQ(expected, received);
+}
+
+// Compare syscalls count and time spent to send responses on 50 pipelined gets: one send per command
+// versus a single writev for the whole batch
+TEST(OutputQueueTest, PipelineBenchmark) {
+    const int batches = 2000;
+    const int pipeline = 50;
+
+    size_t batch_size = 0;
+    std::vector<std::string> responses;
+    for (int i = 0; i < pipeline; i++) {
+        responses.push_back("VALUE key" + std::to_string(i) + " 0 10\r\n0123456789\r\nEND\r\n");
+        batch_size += responses.back().size();
+    }
+
+    auto run = [&](bool batched, size_t &syscalls) {
+        int sv[2];
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+        size_t received = 0;
+        std::thread reader([&]() { received = drain(sv[1]).size(); });
+
+        syscalls = 0;
+        auto start = std::chrono::steady_clock::now();
+        OutputQueue queue;
+        for (int b = 0; b < batches; b++) {
+            for (auto &r : responses) {
+                if (batched) {
+                    queue.Push(std::string(r));
+                } else {
+                    send(sv[0], r.data(), r.size(), 0);
+                    syscalls++;
+                }
+            }
+            if (batched) {
+                syscalls += queue.Flush(sv[0]);
+            }
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        close(sv[0]);
+        reader.join();
+        close(sv[1]);
+
+        EXPECT_EQ(batches * batch_size, received);
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    };
+
+    size_t send_calls, writev_calls;
+    auto send_us = run(false, send_calls);
+    auto writev_us = run(true, writev_calls);
+
+    std::cout << "send per command: " << send_calls << " syscalls, " << send_us << "us" << std::endl;
+    std::cout << "writev per batch: " << writev_calls << " syscalls, " << writev_us << "us" << std::endl;
+    EXPECT_EQ(batches * pipeline, send_calls);
+    EXPECT_LE(writev_calls, send_calls / 10);
+}
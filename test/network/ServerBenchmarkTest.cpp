@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <afina/concurrency/Histogram.h>
+
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/uring/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+#include "TestServer.h"
+
+using namespace Afina;
+using namespace Afina::Test;
+
+// Runs clients sending pipelined gets, returns requests per second
+static double run_clients(std::function<int()> connect, int clients, int batches, int pipeline) {
+    std::string batch;
+    std::string reply;
+    for (int i = 0; i < pipeline; i++) {
+        batch += "get key\r\n";
+        reply += "VALUE key 0 5\r\nvalue\r\nEND\r\n";
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<bool> ok(clients, false);
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < clients; c++) {
+        threads.emplace_back([&, c]() {
+            int fd = connect();
+            std::string received;
+            std::vector<char> buf(reply.size());
+            bool result = true;
+            for (int b = 0; b < batches && result; b++) {
+                result = send(fd, batch.data(), batch.size(), 0) == ssize_t(batch.size());
+
+                received.clear();
+                while (result && received.size() < reply.size()) {
+                    ssize_t n = recv(fd, buf.data(), reply.size() - received.size(), 0);
+                    result = n > 0;
+                    if (result) {
+                        received.append(buf.data(), n);
+                    }
+                }
+                result = result && received == reply;
+            }
+            close(fd);
+            ok[c] = result;
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    for (int c = 0; c < clients; c++) {
+        EXPECT_TRUE(ok[c]) << "client " << c;
+    }
+    double seconds = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1e6;
+    return clients * batches * pipeline / seconds;
+}
+
+// Single client sending one get at a time, records round trip of each
+static void run_ping_pong(std::function<int()> connect, int requests, Concurrency::Histogram &latency) {
+    const std::string request = "get key\r\n";
+    const std::string reply = "VALUE key 0 5\r\nvalue\r\nEND\r\n";
+
+    int fd = connect();
+    std::vector<char> buf(reply.size());
+    bool ok = true;
+    for (int i = 0; i < requests && ok; i++) {
+        auto start = std::chrono::steady_clock::now();
+        ok = send(fd, request.data(), request.size(), 0) == ssize_t(request.size());
+
+        std::size_t received = 0;
+        while (ok && received < reply.size()) {
+            ssize_t n = recv(fd, buf.data() + received, reply.size() - received, 0);
+            ok = n > 0;
+            received += ok ? n : 0;
+        }
+        latency.Record(std::chrono::steady_clock::now() - start);
+        ok = ok && std::string(buf.data(), received) == reply;
+    }
+    close(fd);
+    EXPECT_TRUE(ok);
+}
+
+// Compare epoll server with shared queue against io_uring one on the same load
+TEST(ServerBenchmarkTest, UringVsMTnonblock) {
+    const int clients = 4;
+    const int batches = 500;
+    const int pipeline = 32;
+
+    auto log = logging();
+    std::shared_ptr<Afina::Storage> storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1024);
+    storage->Put("key", "value");
+
+    double epoll_rps;
+    {
+        Network::MTnonblock::ServerImpl server(storage, log);
+        server.Start(18081, 1, 2);
+        epoll_rps = run_clients([]() { return connect_to(18081); }, clients, batches, pipeline);
+        server.Stop();
+        server.Join();
+    }
+
+    double uring_rps = 0;
+    try {
+        Network::Uring::ServerImpl server(storage, log);
+        server.Start(18082, 1, 2);
+        uring_rps = run_clients([]() { return connect_to(18082); }, clients, batches, pipeline);
+        server.Stop();
+        server.Join();
+    } catch (std::runtime_error &ex) {
+        std::cout << "io_uring is not available, skipped: " << ex.what() << std::endl;
+    }
+
+    std::cout << "mt_nonblock: " << long(epoll_rps) << " req/s" << std::endl;
+    std::cout << "uring:       " << long(uring_rps) << " req/s" << std::endl;
+}
+
+// Same server, same load, clients come over loopback TCP or over unix domain socket
+TEST(ServerBenchmarkTest, TcpVsUnixSocket) {
+    const int clients = 4;
+    const int batches = 500;
+    const int pipeline = 32;
+    const int requests = 2000;
+    const std::string path = "/tmp/afina-benchmark-" + std::to_string(getpid()) + ".sock";
+
+    auto log = logging();
+    std::shared_ptr<Afina::Storage> storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1024);
+    storage->Put("key", "value");
+
+    Network::MTnonblock::ServerImpl server(storage, log);
+    server.SetUnixSocket(path);
+    server.Start(18083, 1, 2);
+
+    std::function<int()> tcp = []() { return connect_to(18083); };
+    std::function<int()> uds = [&path]() { return connect_to(path); };
+
+    double tcp_rps = run_clients(tcp, clients, batches, pipeline);
+    double uds_rps = run_clients(uds, clients, batches, pipeline);
+
+    Concurrency::Histogram tcp_latency, uds_latency;
+    run_ping_pong(tcp, requests, tcp_latency);
+    run_ping_pong(uds, requests, uds_latency);
+
+    server.Stop();
+    server.Join();
+    EXPECT_NE(0, access(path.c_str(), F_OK)) << "socket file is left behind";
+
+    std::cout << "tcp:  " << long(tcp_rps) << " req/s, round trip p50 " << tcp_latency.Percentile(0.5).count()
+              << "ns, p99 " << tcp_latency.Percentile(0.99).count() << "ns" << std::endl;
+    std::cout << "unix: " << long(uds_rps) << " req/s, round trip p50 " << uds_latency.Percentile(0.5).count()
+              << "ns, p99 " << uds_latency.Percentile(0.99).count() << "ns" << std::endl;
+}
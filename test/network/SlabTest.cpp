@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "network/Slab.h"
+
+using namespace Afina::Network;
+
+namespace {
+
+// Counts objects alive, optionally refuses to be constructed
+struct Tracked {
+    explicit Tracked(int &alive, bool fail = false) : alive(alive), value(0) {
+        if (fail) {
+            throw std::runtime_error("refused");
+        }
+        alive++;
+    }
+    ~Tracked() { alive--; }
+
+    int &alive;
+    uint64_t value;
+};
+
+} // namespace
+
+TEST(SlabTest, Reuse) {
+    int alive = 0;
+    Slab<Tracked> slab;
+    EXPECT_EQ(0, slab.Capacity());
+
+    Tracked *a = slab.Create(alive);
+    Tracked *b = slab.Create(alive);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(2, alive);
+    EXPECT_EQ(2, slab.InUse());
+    EXPECT_EQ(Slab<Tracked>::kSlabObjects, slab.Capacity());
+
+    // The most recently freed slot goes out first
+    slab.Destroy(a);
+    EXPECT_EQ(1, alive);
+    EXPECT_EQ(1, slab.InUse());
+    EXPECT_EQ(a, slab.Create(alive));
+
+    slab.Destroy(a);
+    slab.Destroy(b);
+    EXPECT_EQ(0, alive);
+    EXPECT_EQ(0, slab.InUse());
+}
+
+TEST(SlabTest, Grow) {
+    int alive = 0;
+    Slab<Tracked> slab;
+
+    const std::size_t n = 3 * Slab<Tracked>::kSlabObjects + 1;
+    std::vector<Tracked *> objects;
+    std::set<Tracked *> distinct;
+    for (std::size_t i = 0; i < n; i++) {
+        objects.push_back(slab.Create(alive));
+        objects.back()->value = i;
+        distinct.insert(objects.back());
+    }
+    EXPECT_EQ(n, distinct.size());
+    EXPECT_EQ(4 * Slab<Tracked>::kSlabObjects, slab.Capacity());
+    EXPECT_GE(slab.Memory(), slab.Capacity() * sizeof(Tracked));
+
+    // Objects don't overlap
+    for (std::size_t i = 0; i < n; i++) {
+        EXPECT_EQ(i, objects[i]->value);
+    }
+
+    // Slabs stay for the objects to come
+    for (auto object : objects) {
+        slab.Destroy(object);
+    }
+    EXPECT_EQ(0, alive);
+    for (std::size_t i = 0; i < n; i++) {
+        objects[i] = slab.Create(alive);
+    }
+    EXPECT_EQ(4 * Slab<Tracked>::kSlabObjects, slab.Capacity());
+    for (auto object : objects) {
+        slab.Destroy(object);
+    }
+}
+
+TEST(SlabTest, ConstructorThrows) {
+    int alive = 0;
+    Slab<Tracked> slab;
+
+    Tracked *a = slab.Create(alive);
+    slab.Destroy(a);
+    EXPECT_THROW(slab.Create(alive, true), std::runtime_error);
+    EXPECT_EQ(0, slab.InUse());
+
+    // Slot refused object was about to take is still free
+    EXPECT_EQ(a, slab.Create(alive));
+    slab.Destroy(a);
+}
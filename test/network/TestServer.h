@@ -0,0 +1,130 @@
+#ifndef AFINA_TEST_NETWORK_TEST_SERVER_H
+#define AFINA_TEST_NETWORK_TEST_SERVER_H
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <afina/logging/Config.h>
+
+#include "logging/ServiceImpl.h"
+
+namespace Afina {
+namespace Test {
+
+// Loggers are registered globally, so the service is shared by all tests of the binary
+inline std::shared_ptr<Logging::Service> logging() {
+    static std::shared_ptr<Logging::Service> result;
+    if (result) {
+        return result;
+    }
+
+    std::shared_ptr<Logging::Config> cfg(new Logging::Config);
+    Logging::Appender &console = cfg->appenders["console"];
+    console.type = Logging::Appender::Type::STDERR;
+
+    Logging::Logger &logger = cfg->loggers["root"];
+    logger.level = Logging::Logger::Level::CRITICAL;
+    logger.appenders.push_back("console");
+
+    result.reset(new Logging::ServiceImpl(cfg));
+    result->Start();
+    return result;
+}
+
+// Servers without SO_REUSEADDR can't bind the port while connections closed by the previous run are in
+// TIME_WAIT, so each test takes the next port it is able to bind
+inline uint16_t next_port() {
+    static uint16_t port = 18100;
+    for (;; port++) {
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        bool free = bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+        close(fd);
+        if (free) {
+            return port++;
+        }
+    }
+}
+
+// Connects to the server on loopback, waiting for it to start listening
+inline int connect_to(uint16_t port) {
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    for (int attempt = 0; attempt < 100; attempt++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    throw std::runtime_error("Failed to connect to server");
+}
+
+inline int connect_to(const std::string &path) {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to connect to server");
+    }
+    return fd;
+}
+
+// Sends pipelined requests without reading responses till server stops taking them or at most the given
+// number of bytes, returns bytes sent
+inline std::size_t send_till_stopped(int fd, const std::string &request, std::size_t most) {
+    std::string batch;
+    while (batch.size() < 64 * 1024) {
+        batch += request;
+    }
+
+    std::size_t sent = 0;
+    while (sent < most) {
+        ssize_t n = send(fd, batch.data() + sent % batch.size(), batch.size() - sent % batch.size(),
+                         MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd = {fd, POLLOUT, 0};
+            if (poll(&pfd, 1, 500) == 0) {
+                break;
+            }
+        } else {
+            break;
+        }
+    }
+    return sent;
+}
+
+} // namespace Test
+} // namespace Afina
+
+#endif // AFINA_TEST_NETWORK_TEST_SERVER_H
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/mt_reuseport/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+#include "TestServer.h"
+
+using namespace Afina;
+using namespace Afina::Test;
+
+namespace {
+
+// Servers keeping connection timeouts on the timer wheel
+const std::vector<std::string> kServers = {"st_nonblock", "mt_nonblock", "mt_reuseport"};
+
+std::unique_ptr<Network::Server> make_server(const std::string &name, std::chrono::milliseconds idle,
+                                             std::chrono::milliseconds read) {
+    std::shared_ptr<Afina::Storage> storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1024);
+    std::unique_ptr<Network::Server> result;
+    if (name == "st_nonblock") {
+        result.reset(new Network::STnonblock::ServerImpl(storage, logging()));
+    } else if (name == "mt_nonblock") {
+        result.reset(new Network::MTnonblock::ServerImpl(storage, logging()));
+    } else if (name == "mt_reuseport") {
+        result.reset(new Network::MTreuseport::ServerImpl(storage, logging()));
+    }
+    result->SetTimeouts(idle, read);
+    return result;
+}
+
+// Sends request and waits for the server to close connection, false if it is still open after a few seconds
+bool closed_after(uint16_t port, const std::string &request) {
+    int fd = connect_to(port);
+    struct timeval tv;
+    tv.tv_sec = 3;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    if (!request.empty()) {
+        send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    }
+
+    char buf[256];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+    }
+    close(fd);
+    return n == 0;
+}
+
+} // namespace
+
+// Connection which doesn't send anything, or nothing after the last command, is closed after idle timeout
+TEST(TimeoutsTest, IdleCloses) {
+    for (auto &name : kServers) {
+        SCOPED_TRACE(name);
+        uint16_t port = next_port();
+        auto server = make_server(name, std::chrono::milliseconds(300), std::chrono::milliseconds(0));
+        server->Start(port, 1, 2);
+
+        EXPECT_TRUE(closed_after(port, ""));
+        EXPECT_TRUE(closed_after(port, "get key\r\n"));
+
+        server->Stop();
+        server->Join();
+    }
+}
+
+// Connection which has started a command but doesn't finish it is closed after read timeout
+TEST(TimeoutsTest, ReadCloses) {
+    for (auto &name : kServers) {
+        SCOPED_TRACE(name);
+        uint16_t port = next_port();
+        auto server = make_server(name, std::chrono::milliseconds(0), std::chrono::milliseconds(300));
+        server->Start(port, 1, 2);
+
+        EXPECT_TRUE(closed_after(port, "set key 0 0 5\r\nva"));
+
+        server->Stop();
+        server->Join();
+    }
+}
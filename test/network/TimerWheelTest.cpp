@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "network/TimerWheel.h"
+
+using namespace Afina::Network;
+using std::chrono::milliseconds;
+
+TEST(TimerWheelTest, Fire) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(milliseconds(10), start);
+    EXPECT_EQ(-1, wheel.Timeout(start));
+
+    int fired = 0;
+    TimerWheel::Timer timer([&fired]() { fired++; });
+    wheel.Schedule(timer, milliseconds(25), start);
+    EXPECT_TRUE(timer.Pending());
+    EXPECT_EQ(1, wheel.Size());
+    EXPECT_EQ(30, wheel.Timeout(start));
+
+    // Never early, at most a tick late
+    EXPECT_EQ(0, wheel.Advance(start + milliseconds(29)));
+    EXPECT_EQ(0, fired);
+    EXPECT_EQ(1, wheel.Advance(start + milliseconds(30)));
+    EXPECT_EQ(1, fired);
+    EXPECT_FALSE(timer.Pending());
+    EXPECT_EQ(0, wheel.Size());
+    EXPECT_EQ(-1, wheel.Timeout(start + milliseconds(30)));
+}
+
+TEST(TimerWheelTest, CancelReschedule) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(milliseconds(1), start);
+
+    int fired = 0;
+    TimerWheel::Timer a([&fired]() { fired += 1; });
+    TimerWheel::Timer b([&fired]() { fired += 10; });
+    wheel.Schedule(a, milliseconds(5), start);
+    wheel.Schedule(b, milliseconds(5), start);
+    wheel.Cancel(a);
+    EXPECT_FALSE(a.Pending());
+    EXPECT_EQ(1, wheel.Size());
+
+    // Rescheduling moves timer, doesn't add one more
+    wheel.Schedule(b, milliseconds(100), start);
+    wheel.Schedule(b, milliseconds(200), start);
+    EXPECT_EQ(1, wheel.Size());
+    EXPECT_EQ(0, wheel.Advance(start + milliseconds(199)));
+    EXPECT_EQ(1, wheel.Advance(start + milliseconds(200)));
+    EXPECT_EQ(10, fired);
+
+    // Destroyed timer leaves the wheel
+    {
+        TimerWheel::Timer c([&fired]() { fired += 100; });
+        wheel.Schedule(c, milliseconds(1), start);
+    }
+    EXPECT_EQ(0, wheel.Size());
+    EXPECT_EQ(0, wheel.Advance(start + milliseconds(300)));
+}
+
+TEST(TimerWheelTest, CallbackSchedules) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(milliseconds(1), start);
+
+    // Periodic timer reschedules itself from callback, and cancels the other one due at the same tick. Timers
+    // due at the same tick fire the latest scheduled first
+    int ticks = 0;
+    TimerWheel::Timer other([]() { FAIL(); });
+    TimerWheel::Timer periodic;
+    periodic.callback = [&]() {
+        ticks++;
+        wheel.Cancel(other);
+        if (ticks < 5) {
+            wheel.Schedule(periodic, milliseconds(10), start + milliseconds(10 * ticks));
+        }
+    };
+    wheel.Schedule(other, milliseconds(10), start);
+    wheel.Schedule(periodic, milliseconds(10), start);
+
+    EXPECT_EQ(5, wheel.Advance(start + milliseconds(1000)));
+    EXPECT_EQ(5, ticks);
+    EXPECT_EQ(0, wheel.Size());
+}
+
+TEST(TimerWheelTest, Levels) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(milliseconds(1), start);
+
+    // Delays spread over all wheels, each timer records when it has fired
+    std::mt19937 rng(42);
+    std::vector<int64_t> delays;
+    for (int i = 0; i < 1000; i++) {
+        delays.push_back(rng() % (int64_t(1) << (6 * (1 + i % 4))));
+    }
+    delays.push_back(64);
+    delays.push_back(4096);
+    delays.push_back(4096 * 64 + 1);
+
+    int64_t now = 0;
+    std::vector<int64_t> fired_at(delays.size(), -1);
+    std::vector<std::unique_ptr<TimerWheel::Timer>> timers;
+    for (std::size_t i = 0; i < delays.size(); i++) {
+        timers.emplace_back(new TimerWheel::Timer([&fired_at, &now, i]() { fired_at[i] = now; }));
+        wheel.Schedule(*timers.back(), milliseconds(delays[i]), start);
+    }
+
+    // Jump from one wakeup to another as epoll would
+    while (wheel.Size() > 0) {
+        int timeout = wheel.Timeout(start + milliseconds(now));
+        ASSERT_GE(timeout, 0);
+        ASSERT_LE(timeout, 64);
+        now += timeout;
+        wheel.Advance(start + milliseconds(now));
+    }
+
+    for (std::size_t i = 0; i < delays.size(); i++) {
+        EXPECT_EQ(std::max<int64_t>(delays[i], 1), fired_at[i]) << "delay " << delays[i];
+    }
+}
+
+TEST(TimerWheelTest, Behind) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(milliseconds(10), start);
+
+    // Wheel hasn't been advanced for a while, delay counts from now anyway
+    int fired = 0;
+    TimerWheel::Timer timer([&fired]() { fired++; });
+    wheel.Schedule(timer, milliseconds(100), start + milliseconds(1000));
+    EXPECT_EQ(0, wheel.Advance(start + milliseconds(1099)));
+    EXPECT_EQ(1, wheel.Advance(start + milliseconds(1100)));
+    EXPECT_EQ(1, fired);
+}
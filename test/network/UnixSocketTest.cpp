@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "network/UnixSocket.h"
+#include "network/mt_blocking/ServerImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/mt_reuseport/ServerImpl.h"
+#include "network/st_blocking/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+#include "TestServer.h"
+
+using namespace Afina;
+using namespace Afina::Test;
+
+namespace {
+
+// Descriptors process has open
+std::size_t open_descriptors() {
+    std::size_t result = 0;
+    DIR *dir = opendir("/proc/self/fd");
+    while (struct dirent *entry = readdir(dir)) {
+        result += entry->d_name[0] != '.';
+    }
+    closedir(dir);
+    return result;
+}
+
+} // namespace
+
+TEST(UnixSocketTest, Listen) {
+    const std::string path = "/tmp/afina-unix-" + std::to_string(getpid()) + ".sock";
+
+    // Socket left by the listener that is gone is replaced, live one is refused
+    int stale = Network::ListenUnixSocket(path, 5);
+    close(stale);
+    int fd = Network::ListenUnixSocket(path, 5);
+    EXPECT_THROW(Network::ListenUnixSocket(path, 5), std::runtime_error);
+
+    int client = connect_to(path);
+    close(client);
+    Network::CloseUnixSocket(fd, path);
+    EXPECT_NE(0, access(path.c_str(), F_OK));
+
+    // Anything else at the path is left alone
+    std::ofstream(path) << "data";
+    EXPECT_THROW(Network::ListenUnixSocket(path, 5), std::runtime_error);
+    EXPECT_EQ(0, access(path.c_str(), F_OK));
+    unlink(path.c_str());
+}
+
+// Server failing to listen on unix socket doesn't keep TCP listener and the rest opened before
+TEST(UnixSocketTest, StartFailureCloses) {
+    const std::string path = "/tmp/afina-unix-" + std::to_string(getpid()) + ".file";
+    std::ofstream(path) << "data";
+
+    std::shared_ptr<Afina::Storage> storage = std::make_shared<Backend::ThreadSafeSimplLRU>(1024);
+    std::vector<std::unique_ptr<Network::Server>> servers;
+    servers.emplace_back(new Network::STblocking::ServerImpl(storage, logging()));
+    servers.emplace_back(new Network::MTblocking::ServerImpl(storage, logging()));
+    servers.emplace_back(new Network::STnonblock::ServerImpl(storage, logging()));
+    servers.emplace_back(new Network::MTnonblock::ServerImpl(storage, logging()));
+    servers.emplace_back(new Network::MTreuseport::ServerImpl(storage, logging()));
+
+    for (auto &server : servers) {
+        std::size_t before = open_descriptors();
+        server->SetUnixSocket(path);
+        EXPECT_THROW(server->Start(next_port(), 1, 2), std::runtime_error);
+        EXPECT_EQ(before, open_descriptors());
+    }
+    unlink(path.c_str());
+}
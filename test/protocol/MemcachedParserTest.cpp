@@ -1,12 +1,18 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 #include <afina/execute/Add.h>
+#include <afina/execute/Gat.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/MetaGet.h>
+#include <afina/execute/MetaSet.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
 
 #include <protocol/Parser.h>
 
@@ -58,6 +64,38 @@ TEST(MemcachedParserTest, SimpleAdd) {
     ASSERT_EQ(-1, tmp->expire());
 }
 
+// Verify multi digit expire time, also split between reads
+TEST(MemcachedParserTest, ExpireTime) {
+    size_t consumed = 0;
+    size_t value_size;
+
+    Protocol::Parser parser;
+    ASSERT_TRUE(parser.Parse("set foo 0 3600 5\r\n", consumed));
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(3600, reinterpret_cast<Execute::Set *>(cmd.get())->expire());
+    ASSERT_EQ(5, value_size);
+
+    Protocol::Parser split;
+    ASSERT_FALSE(split.Parse("set foo 0 12", consumed));
+    ASSERT_TRUE(split.Parse("3456 5\r\n", consumed));
+    cmd = split.Build(value_size);
+    ASSERT_EQ(123456, reinterpret_cast<Execute::Set *>(cmd.get())->expire());
+
+    Protocol::Parser negative;
+    ASSERT_TRUE(negative.Parse("add foo 0 -120 5\r\n", consumed));
+    cmd = negative.Build(value_size);
+    ASSERT_EQ(-120, reinterpret_cast<Execute::Add *>(cmd.get())->expire());
+
+    Protocol::Parser limit;
+    ASSERT_TRUE(limit.Parse("set foo 0 2147483647 5\r\n", consumed));
+    cmd = limit.Build(value_size);
+    ASSERT_EQ(INT32_MAX, reinterpret_cast<Execute::Set *>(cmd.get())->expire());
+
+    Protocol::Parser overflow;
+    ASSERT_THROW(overflow.Parse("set foo 0 2147483648 5\r\n", consumed), std::runtime_error);
+}
+
 // Verify simple get command passed in a single string
 TEST(MemcachedParserTest, SimpleGet) {
     Protocol::Parser parser;
@@ -98,3 +136,123 @@ TEST(MemcachedParserTest, Stats) {
     Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd.get());
     ASSERT_FALSE(tmp == nullptr);
 }
+
+// Verify meta get with flags and opaque token
+TEST(MemcachedParserTest, MetaGet) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    bool cmd_avail = parser.Parse("mg foo v  t Oabc\r\n", consumed);
+    ASSERT_TRUE(cmd_avail);
+    ASSERT_EQ(18, consumed);
+    ASSERT_EQ("mg", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(0, value_size);
+
+    Execute::MetaGet *tmp = reinterpret_cast<Execute::MetaGet *>(cmd.get());
+    ASSERT_EQ("foo", tmp->key());
+    ASSERT_TRUE(tmp->has('v'));
+    ASSERT_TRUE(tmp->has('t'));
+    ASSERT_FALSE(tmp->has('f'));
+    ASSERT_EQ("abc", tmp->token('O'));
+}
+
+// Verify meta set takes data length out of the command line
+TEST(MemcachedParserTest, MetaSet) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    bool cmd_avail = parser.Parse("ms foo 6 F5 T60 MA q\r\nfooval\r\n", consumed);
+    ASSERT_TRUE(cmd_avail);
+    ASSERT_EQ(22, consumed);
+    ASSERT_EQ("ms", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(6, value_size);
+
+    Execute::MetaSet *tmp = reinterpret_cast<Execute::MetaSet *>(cmd.get());
+    ASSERT_EQ("foo", tmp->key());
+    ASSERT_EQ("5", tmp->token('F'));
+    ASSERT_EQ("A", tmp->token('M'));
+    ASSERT_TRUE(tmp->has('q'));
+}
+
+TEST(MemcachedParserTest, MetaNoop) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("mn\r\n", consumed));
+    ASSERT_EQ(4, consumed);
+
+    size_t value_size;
+    ASSERT_FALSE(parser.Build(value_size) == nullptr);
+    ASSERT_EQ(0, value_size);
+}
+
+TEST(MemcachedParserTest, MetaInvalid) {
+    size_t consumed = 0, value_size = 0;
+
+    Protocol::Parser no_key;
+    EXPECT_THROW(no_key.Parse("mg\r\n", consumed), std::runtime_error);
+
+    Protocol::Parser bad_flag;
+    ASSERT_TRUE(bad_flag.Parse("mg foo x\r\n", consumed));
+    EXPECT_THROW(bad_flag.Build(value_size), std::runtime_error);
+
+    Protocol::Parser bad_length;
+    ASSERT_TRUE(bad_length.Parse("ms foo 1x\r\n", consumed));
+    EXPECT_THROW(bad_length.Build(value_size), std::runtime_error);
+
+    Protocol::Parser bad_mode;
+    ASSERT_TRUE(bad_mode.Parse("ms foo 1 MX\r\n", consumed));
+    EXPECT_THROW(bad_mode.Build(value_size), std::runtime_error);
+}
+
+TEST(MemcachedParserTest, Touch) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("touch foo -1\r\n", consumed));
+    ASSERT_EQ(14, consumed);
+    ASSERT_EQ("touch", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(0, value_size);
+
+    Execute::Touch *tmp = reinterpret_cast<Execute::Touch *>(cmd.get());
+    ASSERT_EQ("foo", tmp->key());
+    ASSERT_EQ(-1, tmp->expire());
+
+    Protocol::Parser no_exptime;
+    ASSERT_TRUE(no_exptime.Parse("touch foo\r\n", consumed));
+    EXPECT_THROW(no_exptime.Build(value_size), std::runtime_error);
+}
+
+TEST(MemcachedParserTest, Gat) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("gats 300 foo bar\r\n", consumed));
+    ASSERT_EQ(18, consumed);
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(0, value_size);
+
+    Execute::Gat *tmp = reinterpret_cast<Execute::Gat *>(cmd.get());
+    ASSERT_EQ(300, tmp->expire());
+    ASSERT_EQ(2, tmp->keys().size());
+    ASSERT_EQ("bar", tmp->keys()[1]);
+
+    Protocol::Parser bad_exptime;
+    ASSERT_TRUE(bad_exptime.Parse("gat foo\r\n", consumed));
+    EXPECT_THROW(bad_exptime.Build(value_size), std::runtime_error);
+}
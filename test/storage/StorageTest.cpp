@@ -195,3 +195,50 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(StorageTest, FlagsAndRenderedHeader) {
+    SimpleLRU storage(1024, true);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 42, 0));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val22", 7, 0));
+
+    Afina::StoredValue value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value.rendered);
+    EXPECT_EQ(42, value.flags);
+    EXPECT_EQ("val1", std::string(value.data(), value.size));
+    EXPECT_EQ("VALUE KEY1 42 4\r\nval1\r\n", std::string(value.buffer->data(), value.offset + value.size + 2));
+
+    // Update replaces the buffer, old reference stays valid
+    EXPECT_TRUE(storage.Set("KEY1", "value1", 1, 0));
+    EXPECT_EQ("val1", std::string(value.data(), value.size));
+
+    std::string plain;
+    EXPECT_TRUE(storage.Get("KEY1", plain));
+    EXPECT_EQ("value1", plain);
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(1, value.flags);
+}
+
+TEST(StorageTest, TouchKeepsValue) {
+    SimpleLRU storage(1024, true);
+
+    EXPECT_FALSE(storage.Touch("KEY1", 0));
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 42, time(nullptr) - 1));
+    EXPECT_FALSE(storage.Touch("KEY1", 0));
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", 42, 0));
+    Afina::StoredValue before;
+    EXPECT_TRUE(storage.Get("KEY1", before));
+
+    time_t expire = time(nullptr) + 100;
+    Afina::StoredValue after;
+    EXPECT_TRUE(storage.GetAndTouch("KEY1", expire, after));
+    EXPECT_EQ(expire, after.expire);
+    EXPECT_EQ(42, after.flags);
+    // Buffer isn't rebuilt
+    EXPECT_EQ(before.buffer, after.buffer);
+
+    EXPECT_TRUE(storage.Touch("KEY1", time(nullptr) - 1));
+    EXPECT_FALSE(storage.Get("KEY1", after));
+}